@@ -0,0 +1,122 @@
+#include "assignment_solver.h"
+
+/**
+ * @brief Solve the min-cost assignment of rows (trucks) to columns (station slots)
+ *          with the Hungarian method (shortest augmenting path, O(rows^2 * cols)).
+ *          The cost matrix is row-major and must satisfy rows <= cols.
+ *
+ *          The solver checks its time budget after each augmented row,
+ *          if the budget is exceeded it gives up and returns ERROR,
+ *          the caller is expected to fall back to the greedy assignment.
+ *
+ * @param cost
+ * @param rows
+ * @param cols
+ * @param budget
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::AssignmentSolver::solve(const std::vector<long> &cost, int rows, int cols,
+                               std::chrono::microseconds budget)
+{
+    const long INF {std::numeric_limits<long>::max() / 4};
+
+    mAssignment.assign(rows, -1);
+    mTotalCost = 0;
+
+    if(rows < 1 || rows > cols || cost.size() < static_cast<size_t>(rows) * cols) {
+        return ServiceStatus::ERROR;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + budget;
+
+    // potentials and matching use 1-based indices, index 0 is the virtual column
+    mRowPotential.assign(rows + 1, 0);
+    mColPotential.assign(cols + 1, 0);
+    mColMatch.assign(cols + 1, 0);
+    mColWay.assign(cols + 1, 0);
+
+    for (int i {1}; i <= rows; i++) {
+        mColMatch[0] = i;
+        int j0 {0};
+        mMinSlack.assign(cols + 1, INF);
+        mColUsed.assign(cols + 1, 0);
+
+        // find an augmenting path for row i
+        do {
+            mColUsed[j0] = 1;
+            int  i0 {mColMatch[j0]};
+            int  j1 {0};
+            long delta {INF};
+
+            for (int j {1}; j <= cols; j++) {
+                if(mColUsed[j]) {
+                    continue;
+                }
+
+                long cur = cost[(i0 - 1) * cols + (j - 1)] - mRowPotential[i0] - mColPotential[j];
+                if(cur < mMinSlack[j]) {
+                    mMinSlack[j] = cur;
+                    mColWay[j]   = j0;
+                }
+                if(mMinSlack[j] < delta) {
+                    delta = mMinSlack[j];
+                    j1    = j;
+                }
+            }
+
+            for (int j {0}; j <= cols; j++) {
+                if(mColUsed[j]) {
+                    mRowPotential[mColMatch[j]] += delta;
+                    mColPotential[j]            -= delta;
+                }
+                else {
+                    mMinSlack[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (mColMatch[j0] != 0);
+
+        // flip the augmenting path
+        do {
+            int j1 {mColWay[j0]};
+            mColMatch[j0] = mColMatch[j1];
+            j0 = j1;
+        } while (j0 != 0);
+
+        if(std::chrono::steady_clock::now() > deadline) {
+            return ServiceStatus::ERROR;
+        }
+    }
+
+    for (int j {1}; j <= cols; j++) {
+        if(mColMatch[j] != 0) {
+            mAssignment[mColMatch[j] - 1] = j - 1;
+            mTotalCost += cost[(mColMatch[j] - 1) * cols + (j - 1)];
+        }
+    }
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Returns the column assigned to each row of the last solved problem
+ *
+ * @return const std::vector<int>&
+ */
+const std::vector<int> &
+Lunar::AssignmentSolver::assignment()
+{
+    return mAssignment;
+}
+
+/**
+ * @brief Returns the total cost of the last solved problem
+ *
+ * @return long
+ */
+long
+Lunar::AssignmentSolver::totalCost()
+{
+    return mTotalCost;
+}
@@ -0,0 +1,32 @@
+#ifndef ASSIGNMENT_SOLVER_H
+#define ASSIGNMENT_SOLVER_H
+
+#include "service_include.h"
+
+namespace Lunar {
+    class AssignmentSolver
+    {
+        public:
+            AssignmentSolver() {}
+
+            virtual ~AssignmentSolver() {}
+
+            ServiceStatus solve(const std::vector<long> &cost, int rows, int cols,
+                                std::chrono::microseconds budget);
+
+            const std::vector<int> &assignment();
+            long totalCost();
+
+        private:
+            std::vector<long> mRowPotential;
+            std::vector<long> mColPotential;
+            std::vector<long> mMinSlack;
+            std::vector<int>  mColMatch;
+            std::vector<int>  mColWay;
+            std::vector<char> mColUsed;
+            std::vector<int>  mAssignment;
+            long              mTotalCost{0};
+    };
+}
+
+#endif // ASSIGNMENT_SOLVER_H
@@ -0,0 +1,339 @@
+#include "capacity_optimizer.h"
+#include "mining_controller.h"
+
+#include <atomic>
+
+namespace {
+    /**
+     * @brief Smallest x in [lo, max] with pred(x) for a monotone pred,
+     *          the search starts at guess and grows by a quarter until pred holds, then bisects
+     *
+     * @return int 0 if pred doesn't hold up to max
+     */
+    template <typename Pred>
+    int seekMinimal(int lo, int guess, int max, Pred pred)
+    {
+        int hi = std::clamp(guess, lo, max);
+        while (pred(hi) == false) {
+            if(hi >= max) {
+                return 0;
+            }
+            lo = hi + 1;
+            hi = std::min(max, hi + std::max(1, hi / 4));
+        }
+
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if(pred(mid)) {
+                hi = mid;
+            }
+            else {
+                lo = mid + 1;
+            }
+        }
+
+        return hi;
+    }
+}
+
+/**
+ * @brief Run the goal-seek and print the chosen configuration with its confidence intervals
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::CapacityOptimizer::run()
+{
+    mTargetPerHour = mCfg->optimizeDeliveriesPerHour();
+    mMaxWaitTime   = mCfg->optimizeMaxWaitMinutes();
+    if(mMaxWaitTime < 0) {
+        mMaxWaitTime = std::numeric_limits<double>::max();
+    }
+
+    // the replications of every configuration use the same seeds (common random numbers)
+    mSeed = mCfg->rngSeed();
+    if(mSeed < 0) {
+        mSeed = Lunar::DEFAULT_RNG_SEED;
+    }
+
+    auto cacheDir = mCfg->resultCacheDir();
+    if(cacheDir.empty() == false && mCache.open(cacheDir) != ServiceStatus::SUCESS) {
+        return ServiceStatus::ERROR;
+    }
+
+    // the replications run on a pinned worker pool, one worker per CPU
+    mPool = std::make_unique<WorkerPool>(0, WorkerPool::pinningPolicy(*mCfg));
+
+    // analytic seed of the search
+    auto stationGuess = analyticStations();
+    if(stationGuess < 1) {
+        std::cerr << "[OPT-ERROR], DeliveriesPerHour:" << mTargetPerHour
+                  << " is not reachable with up to " << Lunar::OPTIMIZE_MAX_STATIONS << " unload-stations" << std::endl;
+        return ServiceStatus::ERROR;
+    }
+    auto fleetGuess = analyticFleet(stationGuess);
+    auto est        = estimate(stationGuess, fleetGuess);
+    std::cerr << "[OPT-INFO], Estimate: Stations:" << stationGuess << ", Trucks:" << fleetGuess << ", "
+              << std::fixed << std::setprecision(1)
+              << "DeliveriesPerHour:" << est.deliveriesPerHour << ", "
+              << "MeanWaitTime:"      << est.meanWaitTime      << "min" << std::endl;
+
+    // no configuration below the bay capacity can reach the target
+    int stationLow {1};
+    if(est.utilization > 0.0) {
+        auto capacityPerStation = est.deliveriesPerHour / est.utilization / stationGuess;
+        stationLow = std::clamp(static_cast<int>(std::ceil(mTargetPerHour / capacityPerStation)), 1, stationGuess);
+    }
+
+    auto numOfStations = seekMinimal(stationLow, stationGuess, Lunar::OPTIMIZE_MAX_STATIONS, [this] (int s) {
+        int numOfTrucks {0};
+        return isFeasible(s, numOfTrucks);
+    });
+
+    if(numOfStations < 1) {
+        std::cerr << "[OPT-ERROR], No configuration with up to " << Lunar::OPTIMIZE_MAX_STATIONS
+                  << " unload-stations reaches the target, Runs:" << mRuns << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    auto &best = evaluate(numOfStations, mFleets[numOfStations]);
+    std::cerr << "[OPT-SUMMARY], " << formatEvaluation(best) << ", "
+              << "Evaluations:"    << mEvaluations.size()   << ", "
+              << "TotalRuns:"      << mRuns;
+    if(mCache.isOpen()) {
+        std::cerr << ", CacheHits:" << mCache.hits();
+    }
+    std::cerr << std::endl;
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Analytic estimate of a configuration, the controller is initialized but not run
+ *
+ * @param numOfStations
+ * @param numOfTrucks
+ * @return Lunar::QueueEstimate
+ */
+Lunar::QueueEstimate
+Lunar::CapacityOptimizer::estimate(int numOfStations, int numOfTrucks)
+{
+    Config cfg = *mCfg;
+    cfg.set(ServiceParams::TRUCK,          numOfTrucks);
+    cfg.set(ServiceParams::UNLOAD_STATION, numOfStations);
+
+    MiningController ctrl(&cfg);
+    ctrl.setPaced(false);
+    ctrl.setReporting(false);
+    if(ctrl.init() != ServiceStatus::SUCESS) {
+        return QueueEstimate();
+    }
+
+    return ctrl.estimate();
+}
+
+/**
+ * @brief Smallest fleet the analytic model rates at the target throughput
+ *
+ * @param numOfStations
+ * @return int 0 if the stations can't reach the target
+ */
+int
+Lunar::CapacityOptimizer::analyticFleet(int numOfStations)
+{
+    // beyond 2x the bay capacity more trucks only queue
+    auto single = estimate(numOfStations, 1);
+    if(single.offeredLoad <= 0.0) {
+        return 0;
+    }
+    auto maxFleet = std::min(Lunar::OPTIMIZE_MAX_TRUCKS, static_cast<int>(std::ceil(2.0 / single.offeredLoad)));
+    auto minFleet = std::max(1, static_cast<int>(mTargetPerHour / single.deliveriesPerHour));
+
+    return seekMinimal(minFleet, minFleet, maxFleet, [this, numOfStations] (int n) {
+        return estimate(numOfStations, n).deliveriesPerHour >= mTargetPerHour;
+    });
+}
+
+/**
+ * @brief Smallest station count the analytic model rates feasible
+ *
+ * @return int 0 if none up to OPTIMIZE_MAX_STATIONS
+ */
+int
+Lunar::CapacityOptimizer::analyticStations()
+{
+    return seekMinimal(1, 1, Lunar::OPTIMIZE_MAX_STATIONS, [this] (int s) {
+        auto numOfTrucks = analyticFleet(s);
+        return numOfTrucks > 0 && estimate(s, numOfTrucks).meanWaitTime <= mMaxWaitTime;
+    });
+}
+
+/**
+ * @brief Simulate a configuration with SWEEP_REPLICATIONS runs (at least 2) in parallel on the worker pool,
+ *          each run is created, stepped and destroyed on its worker. The results are cached
+ *
+ * @param numOfStations
+ * @param numOfTrucks
+ * @return const Lunar::CapacityEvaluation&
+ */
+const Lunar::CapacityEvaluation &
+Lunar::CapacityOptimizer::evaluate(int numOfStations, int numOfTrucks)
+{
+    auto key = std::make_pair(numOfStations, numOfTrucks);
+    auto it  = mEvaluations.find(key);
+    if(it != mEvaluations.end()) {
+        return it->second;
+    }
+
+    auto &eval = mEvaluations[key];
+    eval.numOfStations = numOfStations;
+    eval.numOfTrucks   = numOfTrucks;
+
+    auto runs   = std::max(2, mCfg->sweepReplications());
+    bool steady = mCfg->warmUpDetection() > 0;
+
+    std::vector<Config> cfgs(runs, *mCfg);
+    std::vector<MiningSummary> sums(runs);
+    std::vector<int> simulated;
+    std::atomic<bool> failed {false};
+    for (int r {0}; r < runs; r++) {
+        cfgs[r].set(ServiceParams::TRUCK,          numOfTrucks);
+        cfgs[r].set(ServiceParams::UNLOAD_STATION, numOfStations);
+        cfgs[r].set(ServiceParams::RNG_SEED,       mSeed + r);
+
+        // repeated studies take the run from the result cache
+        if(mCache.lookup(cfgs[r], sums[r])) {
+            continue;
+        }
+
+        // the run is created on its worker, so its trucks and stations are allocated on the node of the worker
+        simulated.push_back(r);
+        mPool->submit([&cfg = cfgs[r], &sum = sums[r], &failed] () {
+            MiningController ctrl(&cfg);
+            ctrl.setPaced(false);
+            ctrl.setReporting(false);
+            if(ctrl.init() != ServiceStatus::SUCESS) {
+                failed = true;
+                return;
+            }
+
+            ctrl.startServices();
+            while (ctrl.clock() <= static_cast<unsigned long>(ctrl.runTime())) {
+                ctrl.step();
+            }
+            sum = ctrl.summary();
+        });
+    }
+    mPool->wait();
+
+    if(failed) {
+        std::cerr << "[OPT-ERROR], Stations:" << numOfStations << ", Trucks:" << numOfTrucks
+                  << " init failed" << std::endl;
+        return eval;
+    }
+
+    for (auto r : simulated) {
+        mCache.store(cfgs[r], sums[r]);
+    }
+
+    for (auto &sum : sums) {
+        if(steady) {
+            auto steadyRunTime = std::max<long>(sum.runTime - sum.warmUpTime, 1);
+            eval.deliveriesPerHour.add(sum.steadyDeliveries * 60.0 / steadyRunTime);
+            eval.meanWaitTime.add(sum.steadyMeanWaitTime);
+        }
+        else {
+            eval.deliveriesPerHour.add(sum.deliveries * 60.0 / std::max<long>(sum.runTime, 1));
+            eval.meanWaitTime.add(sum.meanWaitTime);
+        }
+    }
+    mRuns += simulated.size();
+
+    std::cerr << "[OPT-INFO], " << formatEvaluation(eval) << std::endl;
+    return eval;
+}
+
+/**
+ * @brief Smallest simulated fleet that reaches the target throughput with the stations,
+ *          seeded by the analytic fleet
+ *
+ * @param numOfStations
+ * @return int 0 if the stations can't reach the target
+ */
+int
+Lunar::CapacityOptimizer::minimalFleet(int numOfStations)
+{
+    auto it = mFleets.find(numOfStations);
+    if(it != mFleets.end()) {
+        return it->second;
+    }
+
+    int numOfTrucks {0};
+    auto single = estimate(numOfStations, 1);
+    if(single.offeredLoad > 0.0) {
+        auto maxFleet = std::min(Lunar::OPTIMIZE_MAX_TRUCKS, static_cast<int>(std::ceil(2.0 / single.offeredLoad)));
+        auto minFleet = std::max(1, static_cast<int>(mTargetPerHour / single.deliveriesPerHour));
+        auto guess    = analyticFleet(numOfStations);
+
+        numOfTrucks = seekMinimal(minFleet, (guess > 0) ? guess : minFleet, maxFleet, [this, numOfStations] (int n) {
+            return reachesTarget(evaluate(numOfStations, n));
+        });
+    }
+
+    mFleets[numOfStations] = numOfTrucks;
+    return numOfTrucks;
+}
+
+/**
+ * @brief The stations are feasible if their smallest fleet at the target keeps the mean wait within the limit,
+ *          a larger fleet only waits longer
+ *
+ * @param numOfStations
+ * @param numOfTrucks the smallest fleet at the target
+ * @return true
+ * @return false
+ */
+bool
+Lunar::CapacityOptimizer::isFeasible(int numOfStations, int &numOfTrucks)
+{
+    numOfTrucks = minimalFleet(numOfStations);
+    if(numOfTrucks < 1) {
+        return false;
+    }
+
+    return evaluate(numOfStations, numOfTrucks).meanWaitTime.mean <= mMaxWaitTime;
+}
+
+/**
+ * @brief Check if the mean throughput of the runs reaches the target
+ *
+ * @param eval
+ * @return true
+ * @return false
+ */
+bool
+Lunar::CapacityOptimizer::reachesTarget(const CapacityEvaluation &eval)
+{
+    return eval.deliveriesPerHour.count > 0 && eval.deliveriesPerHour.mean >= mTargetPerHour;
+}
+
+/**
+ * @brief One evaluation with the 95% confidence intervals of its KPIs
+ *
+ * @param eval
+ * @return std::string
+ */
+std::string
+Lunar::CapacityOptimizer::formatEvaluation(const CapacityEvaluation &eval)
+{
+    std::stringstream ss;
+
+    ss << "Stations:"          << eval.numOfStations << ", "
+       << "Trucks:"            << eval.numOfTrucks   << ", "
+       << "Runs:"              << eval.deliveriesPerHour.count << ", "
+       << std::fixed << std::setprecision(2)
+       << "DeliveriesPerHour:" << eval.deliveriesPerHour.mean << "+-" << eval.deliveriesPerHour.halfWidth() << ", "
+       << "MeanWaitTime:"      << eval.meanWaitTime.mean      << "+-" << eval.meanWaitTime.halfWidth()      << "min";
+
+    return ss.rdbuf()->str();
+}
@@ -0,0 +1,68 @@
+#ifndef CAPACITY_OPTIMIZER_H
+#define CAPACITY_OPTIMIZER_H
+
+#include "service_include.h"
+#include "config.h"
+#include "queue_estimator.h"
+#include "replication_stats.h"
+#include "result_cache.h"
+#include "worker_pool.h"
+
+namespace Lunar {
+
+    // Replicated simulation of one station-count x fleet-size configuration
+    struct CapacityEvaluation {
+        int         numOfStations     {0};
+        int         numOfTrucks       {0};
+        RunningStat deliveriesPerHour {};
+        RunningStat meanWaitTime      {};
+    };
+
+    /**
+     * @brief Goal-seek of the minimal number of unload-stations and the smallest fleet
+     *          that reach OPTIMIZE_DELIVERIES_PER_HOUR with a mean wait of at most OPTIMIZE_MAX_WAIT_MINUTES
+     *
+     *          Both KPIs are monotone: more trucks deliver more but wait longer, more stations cut the wait.
+     *          So for a station count the smallest fleet that reaches the target is found by bisection,
+     *          the station count is feasible if that fleet meets the wait limit,
+     *          and the minimal feasible station count is found by bisection as well.
+     *          The analytic estimate seeds both searches, the replications of a configuration run in parallel
+     *          with common random numbers, so the simulated KPIs stay monotone across the search
+     */
+    class CapacityOptimizer
+    {
+        public:
+            CapacityOptimizer(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~CapacityOptimizer() {}
+
+            ServiceStatus run();
+
+        protected:
+            Config *mCfg {nullptr};
+            ResultCache mCache;
+            std::unique_ptr<WorkerPool> mPool;
+
+            QueueEstimate estimate        (int numOfStations, int numOfTrucks);
+            int  analyticFleet            (int numOfStations);
+            int  analyticStations         ();
+
+            const CapacityEvaluation &evaluate(int numOfStations, int numOfTrucks);
+            int  minimalFleet             (int numOfStations);
+            bool isFeasible               (int numOfStations, int &numOfTrucks);
+            bool reachesTarget            (const CapacityEvaluation &eval);
+
+            static std::string formatEvaluation(const CapacityEvaluation &eval);
+
+        private:
+            double mTargetPerHour {0.0};
+            double mMaxWaitTime   {0.0};
+            int    mSeed          {DEFAULT_RNG_SEED};
+            int    mRuns          {0};
+            std::map<std::pair<int, int>, CapacityEvaluation> mEvaluations;
+            std::map<int, int>                                mFleets;     // minimal fleet per station count, 0: unreachable
+    };
+}
+
+#endif // CAPACITY_OPTIMIZER_H
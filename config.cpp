@@ -16,6 +16,7 @@ Lunar::Config::Config(std::string path) {
 Lunar::Config::~Config()
 {
     mLst.clear();
+    mStrLst.clear();
 }
 
 /**
@@ -51,6 +52,30 @@ Lunar::Config::read(std::string path)
     return mLst.size();
 }
 
+/**
+ * @brief Set a config-param in memory, e.g. for benchmarks or embedded runs
+ *
+ * @param param
+ * @param value
+ */
+void
+Lunar::Config::set(ServiceParams param, int value)
+{
+    mLst[param] = value;
+}
+
+/**
+ * @brief Set a string config-param in memory, e.g. UNLOAD_STATION_BAYS of an embedded run
+ *
+ * @param param
+ * @param value
+ */
+void
+Lunar::Config::set(ServiceParams param, const std::string &value)
+{
+    mStrLst[param] = value;
+}
+
 /**
  * @brief It creates config list from  params
  *
@@ -72,7 +97,18 @@ Lunar::Config::addToConfLst(const std::string &line)
         tokens.push_back(token);
     }
 
-    if(tokens.size() != 2 || std::isdigit(tokens[1].at(0)) == false) {
+    if(tokens.size() != 2 || tokens[1].empty()) {
+        return ret;
+    }
+
+    // string params, e.g. file paths
+    auto strIt = ConfigStringParam.find(tokens.at(0));
+    if(strIt != ConfigStringParam.end()) {
+        mStrLst[strIt->second] = tokens[1];
+        return true;
+    }
+
+    if(std::isdigit(tokens[1].at(0)) == false) {
         return ret;
     }
 
@@ -172,4 +208,586 @@ Lunar::Config::simRunTimeInHours()
     }
 
     return it->second;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief It returns the scheduling policy of the unload-station scheduler
+ *          0: greedy, 1: batch-assignment
+ *
+ * @return int
+ */
+int
+Lunar::Config::schedulingPolicy()
+{
+    auto it = mLst.find(ServiceParams::SCHEDULING_POLICY);
+    if(it == mLst.end()) {
+        return static_cast<int>(SchedulingPolicy::GREEDY);
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the time budget (micro-seconds) of the batch-assignment solver
+ *
+ * @return int
+ */
+int
+Lunar::Config::batchAssignmentBudgetUs()
+{
+    auto it = mLst.find(ServiceParams::BATCH_ASSIGNMENT_BUDGET_US);
+    if(it == mLst.end()) {
+        return Lunar::BATCH_ASSIGNMENT_BUDGET_US;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the seed of the loading-time generators,
+ *          ERROR if not set (non-deterministic run)
+ *
+ * @return int
+ */
+int
+Lunar::Config::rngSeed()
+{
+    auto it = mLst.find(ServiceParams::RNG_SEED);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the verification mode
+ *          0: off, 1: record golden trace, 2: verify against golden trace, 3: side-by-side
+ *
+ * @return int
+ */
+int
+Lunar::Config::verifyMode()
+{
+    auto it = mLst.find(ServiceParams::VERIFY_MODE);
+    if(it == mLst.end()) {
+        return static_cast<int>(VerifyMode::OFF);
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the engine verified against the reference engine
+ *
+ * @return int
+ */
+int
+Lunar::Config::verifyEngine()
+{
+    auto it = mLst.find(ServiceParams::VERIFY_ENGINE);
+    if(it == mLst.end()) {
+        return static_cast<int>(EngineType::REFERENCE);
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the path of the golden trace
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::goldenTraceFile()
+{
+    auto it = mStrLst.find(ServiceParams::GOLDEN_TRACE_FILE);
+    if(it == mStrLst.end()) {
+        return Lunar::GOLDEN_TRACE_FILE;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the path of the tick-profile JSON dump, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::profileJsonFile()
+{
+    auto it = mStrLst.find(ServiceParams::PROFILE_JSON_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the path of the Chrome trace-event export, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::traceEventFile()
+{
+    auto it = mStrLst.find(ServiceParams::TRACE_EVENT_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the fleet event-file that adds/retires trucks and opens/closes unload-stations
+ *          while the simulation runs, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::fleetEventFile()
+{
+    auto it = mStrLst.find(ServiceParams::FLEET_EVENT_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the site-file with the truck classes and the site x station drive times, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::siteFile()
+{
+    auto it = mStrLst.find(ServiceParams::SITE_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the number of bays of the unload-station with the index stationIdx
+ *          UNLOAD_STATION_BAYS is either one count for all stations or a comma separated list per station,
+ *          stations after the end of the list get the last count of the list
+ *
+ * @param stationIdx
+ * @return int -1 if the count is invalid
+ */
+int
+Lunar::Config::unloadStationBays(int stationIdx)
+{
+    return perStationValue(ServiceParams::UNLOAD_STATION_BAYS, stationIdx, Lunar::UNLOAD_STATION_BAYS);
+}
+
+/**
+ * @brief Returns the station-specific cost (minutes) the batch-assignment adds to the unload-station with the index stationIdx,
+ *          STATION_ASSIGNMENT_COST is either one cost for all stations or a comma separated list per station
+ *
+ * @param stationIdx
+ * @return int 0 if not set, -1 if the cost is invalid
+ */
+int
+Lunar::Config::stationAssignmentCost(int stationIdx)
+{
+    return perStationValue(ServiceParams::STATION_ASSIGNMENT_COST, stationIdx, 0);
+}
+
+/**
+ * @brief Returns the value of a per-station string param, either one value for all stations or a comma separated list,
+ *          stations after the end of the list get the last value of the list
+ *
+ * @param param
+ * @param stationIdx
+ * @param defaultValue if the param is not set
+ * @return int -1 if the value is invalid
+ */
+int
+Lunar::Config::perStationValue(ServiceParams param, int stationIdx, int defaultValue)
+{
+    auto it = mStrLst.find(param);
+    if(it == mStrLst.end()) {
+        return defaultValue;
+    }
+
+    std::vector<std::string> counts;
+    std::string count;
+    std::stringstream ss(it->second);
+    while (std::getline(ss, count, ',')) {
+        counts.push_back(count);
+    }
+
+    if(counts.empty()) {
+        return ServiceStatus::ERROR;
+    }
+
+    auto &val = counts[std::min<size_t>(stationIdx, counts.size() - 1)];
+    if(val.empty() || val.size() > 9 || std::ranges::all_of(val, [] (unsigned char c) { return std::isdigit(c); }) == false) {
+        return ServiceStatus::ERROR;
+    }
+
+    return std::stoi(val);
+}
+
+/**
+ * @brief Returns the comma separated fleet sizes of the sweep, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::sweepTrucks()
+{
+    auto it = mStrLst.find(ServiceParams::SWEEP_TRUCKS);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the comma separated unload-station counts of the sweep, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::sweepStations()
+{
+    auto it = mStrLst.find(ServiceParams::SWEEP_STATIONS);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the number of seeded runs per sweep configuration
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepReplications()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_REPLICATIONS);
+    if(it == mLst.end()) {
+        return Lunar::SWEEP_REPLICATIONS;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the estimated load (percent) below which a sweep configuration runs once, 0 disables it
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepMinLoadPercent()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_MIN_LOAD_PERCENT);
+    if(it == mLst.end()) {
+        return Lunar::SWEEP_MIN_LOAD_PERCENT;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the estimated load (percent) above which a sweep configuration is skipped, 0 disables it
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepMaxLoadPercent()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_MAX_LOAD_PERCENT);
+    if(it == mLst.end()) {
+        return Lunar::SWEEP_MAX_LOAD_PERCENT;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the target half-width (percent of the mean) of the 95% confidence intervals
+ *          of the sweep KPIs, 0 if not set: fixed number of replications
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepCiPercent()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_CI_PERCENT);
+    if(it == mLst.end()) {
+        return 0;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the most runs of a sweep configuration with sequential stopping
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepMaxReplications()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_MAX_REPLICATIONS);
+    if(it == mLst.end()) {
+        return Lunar::SWEEP_MAX_REPLICATIONS;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns 1 if the warm-up is detected (MSER-5) and truncated from the summary statistics
+ *
+ * @return int
+ */
+int
+Lunar::Config::warmUpDetection()
+{
+    auto it = mLst.find(ServiceParams::WARMUP_DETECTION);
+    if(it == mLst.end()) {
+        return 0;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns 1 if run r of every sweep configuration uses the same seed (common random numbers),
+ *          0: independent seeds per configuration
+ *
+ * @return int
+ */
+int
+Lunar::Config::sweepCommonRandomNumbers()
+{
+    auto it = mLst.find(ServiceParams::SWEEP_COMMON_RANDOM_NUMBERS);
+    if(it == mLst.end()) {
+        return 1;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the target throughput of the capacity optimizer, ERROR if not set (no optimization)
+ *
+ * @return int
+ */
+int
+Lunar::Config::optimizeDeliveriesPerHour()
+{
+    auto it = mLst.find(ServiceParams::OPTIMIZE_DELIVERIES_PER_HOUR);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the maximum mean wait of the capacity optimizer, ERROR if not set (no limit)
+ *
+ * @return int
+ */
+int
+Lunar::Config::optimizeMaxWaitMinutes()
+{
+    auto it = mLst.find(ServiceParams::OPTIMIZE_MAX_WAIT_MINUTES);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the Unix domain socket of the daemon mode, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::daemonSocket()
+{
+    auto it = mStrLst.find(ServiceParams::DAEMON_SOCKET);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the number of worker threads of the daemon, -1 if not set (one per CPU)
+ *
+ * @return int
+ */
+int
+Lunar::Config::daemonWorkers()
+{
+    auto it = mLst.find(ServiceParams::DAEMON_WORKERS);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the directory of the result cache, empty if the cache is off
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::resultCacheDir()
+{
+    auto it = mStrLst.find(ServiceParams::RESULT_CACHE_DIR);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the file of the multi-site mode, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::multiSiteFile()
+{
+    auto it = mStrLst.find(ServiceParams::MULTI_SITE_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns 1 if the sites of the multi-site mode run on one thread, ERROR if not set
+ *
+ * @return int
+ */
+int
+Lunar::Config::multiSiteSerial()
+{
+    auto it = mLst.find(ServiceParams::MULTI_SITE_SERIAL);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the pinning policy of the worker threads
+ *          0: none, 1: compact, 2: scatter over the NUMA nodes, ERROR if not set
+ *
+ * @return int
+ */
+int
+Lunar::Config::workerPinning()
+{
+    auto it = mLst.find(ServiceParams::WORKER_PINNING);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns the interval of the memory report in simulated minutes, ERROR if not set
+ *
+ * @return int
+ */
+int
+Lunar::Config::memoryReportMinutes()
+{
+    auto it = mLst.find(ServiceParams::MEMORY_REPORT_MINUTES);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the POSIX shared-memory name of the live snapshot, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::liveSnapshotShm()
+{
+    auto it = mStrLst.find(ServiceParams::LIVE_SNAPSHOT_SHM);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief It returns 0 if the per-tick truck and station reports are off, ERROR if not set
+ *
+ * @return int
+ */
+int
+Lunar::Config::tickReports()
+{
+    auto it = mLst.find(ServiceParams::TICK_REPORTS);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the path of the level-of-detail timeline file, empty if not set
+ *
+ * @return std::string
+ */
+std::string
+Lunar::Config::timelinePyramidFile()
+{
+    auto it = mStrLst.find(ServiceParams::TIMELINE_PYRAMID_FILE);
+    if(it == mStrLst.end()) {
+        return "";
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Returns the bucket width of the finest timeline level in minutes, ERROR if not set
+ *
+ * @return int
+ */
+int
+Lunar::Config::timelineBucketMinutes()
+{
+    auto it = mLst.find(ServiceParams::TIMELINE_BUCKET_MINUTES);
+    if(it == mLst.end()) {
+        return Lunar::ERROR;
+    }
+
+    return it->second;
+}
@@ -13,17 +13,57 @@ namespace Lunar
       virtual ~Config();
 
       int read                (std::string path = Lunar::CONFIG_FILE);
+      void set                (ServiceParams param, int value);
+      void set                (ServiceParams param, const std::string &value);
       int numOfTrucks         ();
       int numOfUnloadStations ();
       int processSpeedUpBy    ();
       int simRunTimeInHours   ();
+      int schedulingPolicy    ();
+      int batchAssignmentBudgetUs();
+      int rngSeed             ();
+      int verifyMode          ();
+      int verifyEngine        ();
+      std::string goldenTraceFile();
+      std::string profileJsonFile();
+      std::string traceEventFile ();
+      std::string fleetEventFile ();
+      std::string siteFile       ();
+      int unloadStationBays   (int stationIdx);
+      int stationAssignmentCost(int stationIdx);
+      std::string sweepTrucks    ();
+      std::string sweepStations  ();
+      int sweepReplications   ();
+      int sweepMinLoadPercent ();
+      int sweepMaxLoadPercent ();
+      int sweepCiPercent      ();
+      int sweepMaxReplications();
+      int warmUpDetection     ();
+      int sweepCommonRandomNumbers();
+      int optimizeDeliveriesPerHour();
+      int optimizeMaxWaitMinutes  ();
+      std::string daemonSocket   ();
+      int daemonWorkers       ();
+      std::string resultCacheDir ();
+      std::string multiSiteFile  ();
+      int multiSiteSerial     ();
+      int workerPinning       ();
+      int memoryReportMinutes ();
+      std::string liveSnapshotShm();
+      int tickReports         ();
+      std::string timelinePyramidFile();
+      int timelineBucketMinutes();
+      const std::map<ServiceParams, int>         &intParams   () const { return mLst;    }
+      const std::map<ServiceParams, std::string> &stringParams() const { return mStrLst; }
 
    protected:
       std::string mPath {Lunar::CONFIG_FILE};
       std::map<ServiceParams, int>mLst;
+      std::map<ServiceParams, std::string>mStrLst;
 
       bool addToConfLst (const std::string &param);
       int  getIntParam  (const std::string &param);
+      int  perStationValue(ServiceParams param, int stationIdx, int defaultValue);
 
    };
 }
@@ -0,0 +1,457 @@
+#include "coroutine_mining_engine.h"
+#include "warm_up_detector.h"
+
+/**
+ * @brief Create the trucks, stations and the truck coroutines,
+ *          the frames, timers and queues are sized up front so the simulation doesn't allocate
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::CoroutineMiningEngine::init()
+{
+    if(mCfg->schedulingPolicy() != static_cast<int>(SchedulingPolicy::GREEDY) ||
+       mCfg->siteFile().empty() == false || mCfg->fleetEventFile().empty() == false) {
+        std::cerr << "[CE-ERROR], The coroutine engine runs the greedy scheduling without site-file and fleet-events" << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    auto numOfTrucks   = mCfg->numOfTrucks();
+    auto numOfStations = mCfg->numOfUnloadStations();
+    if(numOfTrucks < 1 || numOfStations < 1) {
+        std::cerr << "[CE-ERROR], Trucks:" << numOfTrucks << ", UnloadStations:" << numOfStations << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    auto simulationDuration = mCfg->simRunTimeInHours();
+    mRunTime = hourToMinutes((simulationDuration > 1) ? simulationDuration : Lunar::SIMULATION_TIME_HOURS);
+    mWarmUp  = mCfg->warmUpDetection() > 0;
+    mClock   = 0;
+
+    // Unseeded runs draw a single seed here; a random_device per loading time costs more than the rest of the tick
+    auto seed = mCfg->rngSeed();
+    if(seed < 0) {
+        seed = static_cast<decltype(seed)>(std::random_device()() & 0x7fffffff);
+    }
+    mTrucks.assign(numOfTrucks, CoTruck());
+    for (int t {0}; t < numOfTrucks; t++) {
+        mTrucks[t].index = t;
+        mTrucks[t].rng   = RandomStream(seed, t);
+    }
+
+    mStations.assign(numOfStations, CoStation());
+    mStationOrder.clear();
+    for (int s {0}; s < numOfStations; s++) {
+        auto bays = mCfg->unloadStationBays(s);
+        if(bays < 1) {
+            std::cerr << "[CE-ERROR], UnloadStation:" << s << ", Number of bays:" << bays
+                      << ", using " << Lunar::UNLOAD_STATION_BAYS << std::endl;
+            bays = Lunar::UNLOAD_STATION_BAYS;
+        }
+
+        auto &stat = mStations[s];
+        stat.events = &mEvents;
+        // a queue holds every truck at most, one more bay than trucks is never busy
+        stat.numOfBays = std::min(bays, numOfTrucks + 1);
+        stat.queue.reserve(numOfTrucks);
+        stat.bayFree.resize(stat.numOfBays);
+        mStationOrder.push_back(OrderEntry(0, s));
+    }
+
+    mWaitingTrucks.reserve(numOfTrucks);
+    mEvents.reserve(numOfTrucks);
+
+    // the deliveries are logged for the warm-up detection only, the bound is the one of the reference engine
+    mDeliveryLog.clear();
+    if(mWarmUp) {
+        mDeliveryLog.reserve(numOfTrucks * (mRunTime / hourToMinutes(LOADING_TIME_MIN_HOURS) + 1));
+    }
+
+    mTasks.clear();
+    mTasks.reserve(numOfTrucks);
+    framePool().reserve(numOfTrucks);
+    FramePool::Scope frames(framePool());
+    for (int t {0}; t < numOfTrucks; t++) {
+        mTasks.push_back(truckBehaviour(t));
+    }
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Start the truck cycles, the first minute of the trucks and stations is the one after the service clock
+ *
+ */
+void
+Lunar::CoroutineMiningEngine::startServices()
+{
+    mEvents.advanceTo(mClock + 1);
+    for (auto &task : mTasks) {
+        task.handle().resume();
+    }
+}
+
+/**
+ * @brief Advance the simulation by one minute:
+ *          resume the trucks whose timer fired, run the stations that have an event in this minute,
+ *          release the unloaded trucks and assign the arrived ones
+ *
+ */
+void
+Lunar::CoroutineMiningEngine::step()
+{
+    mClock++;
+    mEvents.advanceTo(mClock + 1);
+    mEvents.resumeDue();
+
+    for (auto &stat : mStations) {
+        if(isStationDue(stat)) {
+            tickStation(stat);
+        }
+    }
+
+    releaseDoneTrucks();
+    assignWaitingTrucks();
+}
+
+/**
+ * @brief Per-minute state of the engine
+ *
+ * @param snap
+ */
+void
+Lunar::CoroutineMiningEngine::snapshot(EngineSnapshot &snap)
+{
+    snap.minute     = mClock;
+    snap.deliveries = 0;
+    snap.truckStates.resize(mTrucks.size());
+    snap.stationQueues.resize(mStations.size());
+
+    for (size_t t {0}; t < mTrucks.size(); t++) {
+        snap.truckStates[t] = mTrucks[t].state;
+        snap.deliveries    += mTrucks[t].deliveries;
+    }
+    for (size_t s {0}; s < mStations.size(); s++) {
+        snap.stationQueues[s] = mStations[s].queue.size();
+    }
+}
+
+/**
+ * @brief Summary of the run
+ *
+ * @return Lunar::MiningSummary
+ */
+Lunar::MiningSummary
+Lunar::CoroutineMiningEngine::summary()
+{
+    MiningSummary sum;
+
+    sum.runTime       = mRunTime;
+    sum.numOfStations = mStations.size();
+    sum.numOfTrucks   = mTrucks.size();
+    for (auto &trk : mTrucks) {
+        sum.deliveries    += trk.deliveries;
+        sum.totalWaitTime += trk.totalWaitTime;
+    }
+    sum.meanWaitTime = (sum.deliveries > 0) ? static_cast<double>(sum.totalWaitTime) / sum.deliveries : 0.0;
+
+    if(mWarmUp) {
+        summarizeSteadyState(sum);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Cycle of a truck: loading, driving, waiting for a station, unloading and the delivery
+ *
+ * @param trkIdx
+ * @return Lunar::SimTask
+ */
+Lunar::SimTask
+Lunar::CoroutineMiningEngine::truckBehaviour(int trkIdx)
+{
+    auto &trk = mTrucks[trkIdx];
+
+    for (;;) {
+        trk.loadingTime = generateLoadingTime(trk.rng);
+        trk.state       = TruckState::LOADING;
+        co_await mEvents.delay(trk.loadingTime);
+
+        trk.state = TruckState::DRIVING;
+        co_await mEvents.delay(mDriveTime);
+
+        trk.state       = TruckState::WAITING_FOR_UNLOAD_STATION;
+        trk.arrivalTime = mEvents.now();
+        auto &stat = co_await requestStation(trk);
+
+        trk.state = TruckState::UNLOADING;
+        co_await stat.acquire(trk);
+
+        // released by the station, the delivery is booked in the next minute
+        trk.state = TruckState::UNLOADING_DONE;
+        co_await mEvents.delay(1);
+
+        auto waitTime = static_cast<long>(mEvents.now()) - trk.arrivalTime;
+        trk.deliveries++;
+        trk.totalWaitTime += waitTime;
+        if(mWarmUp) {
+            mDeliveryLog.push_back(TruckDeliveryLog(trk.stationIdx, static_cast<int>(waitTime), static_cast<long>(mEvents.now())));
+        }
+        trk.stationIdx = -1;
+        trk.state      = TruckState::IDEL;
+        co_await mEvents.delay(1);
+    }
+}
+
+/**
+ * @brief A station has to be ticked if a bay reached its deadline or a free bay can take a queued truck,
+ *          in any other minute the tick of the reference engine doesn't change the station
+ *
+ * @param stat
+ * @return true
+ * @return false
+ */
+bool
+Lunar::CoroutineMiningEngine::isStationDue(CoStation &stat)
+{
+    auto queueSize = static_cast<int>(stat.queue.size());
+    return queueSize > 0 &&
+           (static_cast<long>(mEvents.now()) >= stat.nextDeadline || stat.doneBays > 0 ||
+            (stat.busyBays < stat.numOfBays && queueSize > stat.busyBays));
+}
+
+/**
+ * @brief Flag the trucks in the bays that reached their deadline and fill the free bays
+ *
+ * @param stat
+ */
+void
+Lunar::CoroutineMiningEngine::tickStation(CoStation &stat)
+{
+    auto now = static_cast<long>(mEvents.now());
+    for (int b {0}; b < stat.busyBays; b++) {
+        auto &bay = stat.queue[b];
+        if(bay.isDone == false && bay.startTime + mUnloadTime <= now) {
+            bay.isDone = true;
+            stat.doneBays++;
+        }
+    }
+
+    startUnloading(stat);
+    updateState(stat);
+
+    stat.nextDeadline = std::numeric_limits<long>::max();
+    for (int b {0}; b < stat.busyBays; b++) {
+        if(stat.queue[b].isDone == false) {
+            stat.nextDeadline = std::min(stat.nextDeadline, stat.queue[b].startTime + mUnloadTime);
+        }
+    }
+    stat.waitDirty = true;
+}
+
+/**
+ * @brief Start the arrived trucks on the free bays, the waiting part of the queue is sorted
+ *          by the latest arrival first like UnloadStation::startUnloading
+ *
+ * @param stat
+ */
+void
+Lunar::CoroutineMiningEngine::startUnloading(CoStation &stat)
+{
+    auto queueSize = static_cast<int>(stat.queue.size());
+    if(stat.busyBays >= stat.numOfBays || queueSize <= stat.busyBays) {
+        return;
+    }
+
+    // stable insertion sort, std::stable_sort would allocate its buffer
+    for (int i {stat.busyBays + 1}; i < queueSize; i++) {
+        auto entry = stat.queue[i];
+        auto j     = i;
+        for (; j > stat.busyBays && stat.queue[j - 1].arrivalTime < entry.arrivalTime; j--) {
+            stat.queue[j] = stat.queue[j - 1];
+        }
+        stat.queue[j] = entry;
+    }
+
+    auto now = static_cast<long>(mEvents.now());
+    for (int i {stat.busyBays}; stat.busyBays < stat.numOfBays && i < queueSize; i++) {
+        if(stat.queue[i].arrivalTime > now) {
+            continue;
+        }
+        std::rotate(stat.queue.begin() + stat.busyBays, stat.queue.begin() + i, stat.queue.begin() + i + 1);
+        stat.queue[stat.busyBays++].startTime = now;
+    }
+}
+
+/**
+ * @brief Set the state from the occupancy of the bays
+ *
+ * @param stat
+ */
+void
+Lunar::CoroutineMiningEngine::updateState(CoStation &stat)
+{
+    if(stat.doneBays > 0) {
+        stat.state = UnloadStationState::UNLOADING_DONE;
+    }
+    else if(stat.busyBays > 0) {
+        stat.state = UnloadStationState::UNLOADING;
+    }
+    else {
+        stat.state = UnloadStationState::IDEL;
+    }
+}
+
+/**
+ * @brief Time until a bay is free for a truck that joins the queue now, like UnloadStation::totalWaitTime.
+ *          Between the events of the station the bays are full and count down or the station has a free bay,
+ *          so the minute a bay is free stays the same and only has to be recomputed after an event
+ *
+ * @param stat
+ * @return long
+ */
+long
+Lunar::CoroutineMiningEngine::totalWaitTime(CoStation &stat)
+{
+    if(stat.queue.empty()) {
+        return 0;
+    }
+
+    auto now = static_cast<long>(mEvents.now());
+    if(stat.waitDirty == false) {
+        return std::max(stat.freeAt - now, 0L);
+    }
+
+    std::ranges::fill(stat.bayFree, 0);
+    size_t bay {0};
+
+    for (auto &trk : stat.queue) {
+        if(trk.isDone) {
+            bay++;
+        }
+        else if(trk.startTime > 0) {
+            auto leftTime = (trk.startTime + mUnloadTime) - now;
+            stat.bayFree[bay++ % stat.numOfBays] = std::max(leftTime, 0L);
+        }
+        else {
+            *std::ranges::min_element(stat.bayFree) += mUnloadTime;
+        }
+    }
+
+    auto waitTime = *std::ranges::min_element(stat.bayFree);
+    stat.freeAt    = now + waitTime;
+    stat.waitDirty = false;
+
+    return waitTime;
+}
+
+/**
+ * @brief Release the unloaded trucks in the scheduling order of the stations and resume them
+ *
+ */
+void
+Lunar::CoroutineMiningEngine::releaseDoneTrucks()
+{
+    for (auto &entry : mStationOrder) {
+        auto &stat = mStations[entry.idx];
+        while (stat.state == UnloadStationState::UNLOADING_DONE) {
+            auto bay    = std::ranges::find_if(stat.queue, [] (const QueueEntry &trk) { return trk.isDone; });
+            auto handle = bay->handle;
+            stat.queue.erase(bay);
+            stat.busyBays--;
+            stat.doneBays--;
+            stat.waitDirty = true;
+            updateState(stat);
+
+            handle.resume();
+        }
+    }
+}
+
+/**
+ * @brief Greedy assignment of the trucks that arrived in this minute, like UnloadStationScheduler::checkForUnloadingRequest.
+ *          All trucks wait since this minute, so they are served in the order of their index,
+ *          each one takes the next station with the least wait, the stations are sorted again after the last one
+ *
+ */
+void
+Lunar::CoroutineMiningEngine::assignWaitingTrucks()
+{
+    sortStationsForWaitTime();
+    if(mWaitingTrucks.empty()) {
+        return;
+    }
+
+    std::ranges::sort(mWaitingTrucks);
+
+    size_t statPos {0};
+    for (auto trkIdx : mWaitingTrucks) {
+        if(statPos == mStationOrder.size()) {
+            sortStationsForWaitTime();
+            statPos = 0;
+        }
+
+        // the truck joins the queue of the station before the next one is assigned
+        auto &trk = mTrucks[trkIdx];
+        trk.stationIdx = mStationOrder[statPos++].idx;
+        trk.handle.resume();
+    }
+
+    // the reference engine sorts again at the next truck in its order
+    if(statPos == mStationOrder.size() && mWaitingTrucks.back() + 1 < static_cast<int>(mTrucks.size())) {
+        sortStationsForWaitTime();
+    }
+
+    mWaitingTrucks.clear();
+}
+
+/**
+ * @brief Stable sort of the stations by the least wait, the order is kept between the minutes
+ *
+ */
+void
+Lunar::CoroutineMiningEngine::sortStationsForWaitTime()
+{
+    for (auto &entry : mStationOrder) {
+        entry.key = totalWaitTime(mStations[entry.idx]);
+    }
+
+    // insertion sort, the order is sorted in most minutes
+    for (size_t i {1}; i < mStationOrder.size(); i++) {
+        auto entry = mStationOrder[i];
+        auto j     = i;
+        for (; j > 0 && mStationOrder[j - 1].key > entry.key; j--) {
+            mStationOrder[j] = mStationOrder[j - 1];
+        }
+        mStationOrder[j] = entry;
+    }
+}
+
+/**
+ * @brief Detect the warm-up by MSER-5 on the deliveries per minute, like MiningController::summarizeSteadyState
+ *
+ * @param sum
+ */
+void
+Lunar::CoroutineMiningEngine::summarizeSteadyState(MiningSummary &sum)
+{
+    std::vector<double> throughput(mClock + 1, 0.0);
+    for (auto &log : mDeliveryLog) {
+        if(log.doneTime >= 0 && log.doneTime < static_cast<long>(throughput.size())) {
+            throughput[log.doneTime] += 1.0;
+        }
+    }
+
+    sum.warmUpTime = WarmUpDetector::mser5(throughput);
+
+    long waitTime {0};
+    for (auto &log : mDeliveryLog) {
+        if(log.doneTime > sum.warmUpTime) {
+            sum.steadyDeliveries++;
+            waitTime += log.waitTime;
+        }
+    }
+
+    sum.steadyMeanWaitTime = (sum.steadyDeliveries > 0) ? static_cast<double>(waitTime) / sum.steadyDeliveries : 0.0;
+}
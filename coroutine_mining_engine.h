@@ -0,0 +1,137 @@
+#ifndef COROUTINE_MINING_ENGINE_H
+#define COROUTINE_MINING_ENGINE_H
+
+#include "service_include.h"
+#include "config.h"
+#include "simulation_engine.h"
+#include "event_scheduler.h"
+
+namespace Lunar {
+
+    /**
+     * @brief Simulation engine that runs the cycle of each truck as a C++20 coroutine on an EventScheduler.
+     *          A truck co_awaits its loading and driving time, an unload-station from the scheduler
+     *          and its turn at the station; it is resumed only when the awaited event fired,
+     *          so the trucks that load or drive cost nothing per minute.
+     *          A station is only ticked in the minutes a bay reaches its deadline or a free bay can take a queued truck,
+     *          its wait is only recomputed after a truck joined, started or left, so a minute without events costs O(stations).
+     *          It reproduces the reference engine minute by minute for runs without site-file and fleet-events (VERIFY_ENGINE=2).
+     */
+    class CoroutineMiningEngine : public SimulationEngine
+    {
+        public:
+            CoroutineMiningEngine(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~CoroutineMiningEngine() {}
+
+            ServiceStatus init         () override;
+            void          startServices() override;
+            void          step         () override;
+            unsigned long clock        () override { return mClock;   }
+            long          runTime      () override { return mRunTime; }
+            void          snapshot     (EngineSnapshot &snap) override;
+            MiningSummary summary      () override;
+
+            FramePool    &framePool    () { return mEvents.framePool(); }
+
+        protected:
+            struct CoTruck {
+                int                     index        {0};
+                TruckState              state        {TruckState::IDEL};
+                int                     loadingTime  {0};
+                long                    arrivalTime  {0};
+                int                     stationIdx   {-1};
+                int                     deliveries   {0};
+                long                    totalWaitTime{0};
+                RandomStream            rng          {};
+                std::coroutine_handle<> handle       {nullptr};   // suspended for a station or in a station queue
+            };
+
+            struct QueueEntry {
+                int                     trkIdx      {-1};
+                long                    arrivalTime {0};
+                long                    startTime   {0};
+                bool                    isDone      {false};
+                std::coroutine_handle<> handle      {nullptr};
+            };
+
+            // the bays are the front of the queue, the waiting trucks follow
+            struct CoStation {
+                const EventScheduler   *events    {nullptr};
+                UnloadStationState      state     {UnloadStationState::IDEL};
+                int                     numOfBays {Lunar::UNLOAD_STATION_BAYS};
+                int                     busyBays  {0};
+                int                     doneBays  {0};
+                std::vector<QueueEntry> queue     {};
+                std::vector<long>       bayFree   {};
+                long                    nextDeadline{std::numeric_limits<long>::max()};  // earliest deadline of the busy bays
+                long                    freeAt    {0};       // minute a bay is free for a joining truck, valid if not waitDirty
+                bool                    waitDirty {true};
+
+                // joins the queue, the truck is resumed when it is released after unloading
+                struct AcquireAwaiter {
+                    CoStation *stat   {nullptr};
+                    int        trkIdx {-1};
+
+                    bool await_ready  () const noexcept { return false; }
+                    void await_suspend(std::coroutine_handle<> handle) {
+                        stat->queue.push_back(QueueEntry(trkIdx, stat->events->now(), 0, false, handle));
+                        stat->waitDirty = true;
+                    }
+                    void await_resume () const noexcept {}
+                };
+
+                AcquireAwaiter acquire(const CoTruck &trk) { return AcquireAwaiter(this, trk.index); }
+            };
+
+            // waits for the scheduler to assign an unload-station
+            struct StationRequest {
+                CoroutineMiningEngine *engine {nullptr};
+                CoTruck               *trk    {nullptr};
+
+                bool await_ready  () const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) {
+                    trk->handle = handle;
+                    engine->mWaitingTrucks.push_back(trk->index);
+                }
+                CoStation &await_resume() const noexcept { return engine->mStations[trk->stationIdx]; }
+            };
+
+            struct OrderEntry {
+                long key {0};
+                int  idx {0};
+            };
+
+            Config *mCfg {nullptr};
+
+            unsigned long mClock      {0};
+            long          mRunTime    {0};
+            bool          mWarmUp     {false};
+            int           mDriveTime  {Lunar::DRIVE_TIME_MINUTES};
+            int           mUnloadTime {Lunar::UNLOAD_TIME_MINUTES};
+
+            EventScheduler                mEvents;
+            std::vector<CoTruck>          mTrucks         {};
+            std::vector<CoStation>        mStations       {};
+            std::vector<OrderEntry>       mStationOrder   {};
+            std::vector<int>              mWaitingTrucks  {};
+            std::vector<TruckDeliveryLog> mDeliveryLog    {};
+            std::vector<SimTask>          mTasks          {};     // destroyed before the frame pool of mEvents
+
+            SimTask truckBehaviour(int trkIdx);
+            StationRequest requestStation(CoTruck &trk) { return StationRequest(this, &trk); }
+
+            bool isStationDue       (CoStation &stat);
+            void tickStation        (CoStation &stat);
+            void startUnloading     (CoStation &stat);
+            void updateState        (CoStation &stat);
+            long totalWaitTime      (CoStation &stat);
+            void releaseDoneTrucks  ();
+            void assignWaitingTrucks();
+            void sortStationsForWaitTime();
+            void summarizeSteadyState(MiningSummary &sum);
+    };
+}
+
+#endif // COROUTINE_MINING_ENGINE_H
@@ -0,0 +1,152 @@
+#include "event_scheduler.h"
+
+thread_local Lunar::FramePool *Lunar::FramePool::sCurrent {nullptr};
+
+/**
+ * @brief Reserve blocks for the frames that will be created,
+ *          the chunk is allocated with the first frame when the block size is known
+ *
+ * @param numOfFrames
+ */
+void
+Lunar::FramePool::reserve(size_t numOfFrames)
+{
+    mReserved = numOfFrames;
+}
+
+/**
+ * @brief Take a block for a frame of the given size
+ *
+ * @param size
+ * @return void*
+ */
+void *
+Lunar::FramePool::allocate(size_t size)
+{
+    auto blockSize = sizeof(BlockHeader) + size;
+    if(mBlockSize == 0) {
+        mBlockSize = (blockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+    if(blockSize > mBlockSize) {
+        return allocateUnpooled(size);
+    }
+
+    if(mFree == nullptr) {
+        addChunk(std::max<size_t>(mReserved, 1));
+    }
+
+    auto *block = mFree;
+    mFree = block->next;
+    mNumOfFrames++;
+
+    auto *header = new (block) BlockHeader(this);
+    return header + 1;
+}
+
+/**
+ * @brief Allocate a frame on the heap
+ *
+ * @param size
+ * @return void*
+ */
+void *
+Lunar::FramePool::allocateUnpooled(size_t size)
+{
+    auto *header = new (::operator new(sizeof(BlockHeader) + size)) BlockHeader(nullptr);
+    return header + 1;
+}
+
+/**
+ * @brief Take a block from the current pool of the thread, or the heap if there is none
+ *
+ * @param size
+ * @return void*
+ */
+void *
+Lunar::FramePool::allocateCurrent(size_t size)
+{
+    return (sCurrent != nullptr) ? sCurrent->allocate(size) : allocateUnpooled(size);
+}
+
+/**
+ * @brief Return the block of the frame to its pool
+ *
+ * @param frame
+ */
+void
+Lunar::FramePool::release(void *frame)
+{
+    auto *header = static_cast<BlockHeader *>(frame) - 1;
+    auto *pool   = header->pool;
+    if(pool == nullptr) {
+        ::operator delete(header);
+        return;
+    }
+
+    auto *block = new (header) FreeBlock(pool->mFree);
+    pool->mFree = block;
+    pool->mNumOfFrames--;
+}
+
+/**
+ * @brief Carve a chunk into blocks and put them on the free list
+ *
+ * @param numOfBlocks
+ */
+void
+Lunar::FramePool::addChunk(size_t numOfBlocks)
+{
+    static_assert(sizeof(FreeBlock) <= sizeof(BlockHeader), "a free block has to fit into the header of a frame");
+
+    auto chunk = std::make_unique<std::byte[]>(mBlockSize * numOfBlocks);
+    for (size_t b {numOfBlocks}; b > 0; b--) {
+        mFree = new (chunk.get() + (b - 1) * mBlockSize) FreeBlock(mFree);
+    }
+    mChunks.push_back(std::move(chunk));
+}
+
+/**
+ * @brief Reserve the timer heap, every coroutine waits for one timer at most
+ *
+ * @param numOfTimers
+ */
+void
+Lunar::EventScheduler::reserve(size_t numOfTimers)
+{
+    mTimers.reserve(numOfTimers);
+}
+
+/**
+ * @brief Resume the coroutine in the given minute
+ *
+ * @param handle
+ * @param minute
+ */
+void
+Lunar::EventScheduler::schedule(std::coroutine_handle<> handle, unsigned long minute)
+{
+    mTimers.push_back(Timer(minute, mSeq++, handle));
+    std::ranges::push_heap(mTimers, std::greater<>());
+}
+
+/**
+ * @brief Resume the coroutines whose minute has come,
+ *          a resumed coroutine may schedule itself again
+ *
+ * @return size_t number of resumed coroutines
+ */
+size_t
+Lunar::EventScheduler::resumeDue()
+{
+    size_t resumed {0};
+    while (mTimers.empty() == false && mTimers.front().minute <= mNow) {
+        auto handle = mTimers.front().handle;
+        std::ranges::pop_heap(mTimers, std::greater<>());
+        mTimers.pop_back();
+
+        handle.resume();
+        resumed++;
+    }
+
+    return resumed;
+}
@@ -0,0 +1,158 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include "service_include.h"
+
+#include <coroutine>
+#include <utility>
+
+namespace Lunar {
+
+    /**
+     * @brief Pool of equally sized blocks for coroutine frames,
+     *          the blocks are carved from chunks and recycled through a free list.
+     *          The block size is taken from the first frame, larger frames fall back to the heap.
+     *          Each block starts with the pool it came from, so a frame is released without knowing its pool.
+     */
+    class FramePool
+    {
+        public:
+            FramePool() {}
+            FramePool(const FramePool &) = delete;
+            FramePool &operator=(const FramePool &) = delete;
+            virtual ~FramePool() {}
+
+            void  reserve (size_t numOfFrames);
+            void *allocate(size_t size);
+
+            static void *allocateUnpooled(size_t size);
+            static void *allocateCurrent (size_t size);
+            static void  release         (void *frame);
+
+            // Makes the pool the current one of the thread while the coroutines of its owner are created
+            class Scope
+            {
+                public:
+                    explicit Scope(FramePool &pool) :
+                        mPrevious(std::exchange(sCurrent, &pool)) {}
+                    Scope(const Scope &) = delete;
+                    Scope &operator=(const Scope &) = delete;
+                    ~Scope() { sCurrent = mPrevious; }
+
+                private:
+                    FramePool *mPrevious {nullptr};
+            };
+
+            size_t numOfFrames() const { return mNumOfFrames; }
+
+        private:
+            struct alignas(std::max_align_t) BlockHeader {
+                FramePool *pool {nullptr};          // nullptr: allocated on the heap
+            };
+            struct FreeBlock {
+                FreeBlock *next {nullptr};
+            };
+
+            size_t     mBlockSize  {0};
+            size_t     mReserved   {0};
+            size_t     mNumOfFrames{0};
+            FreeBlock *mFree       {nullptr};
+            std::vector<std::unique_ptr<std::byte[]>> mChunks {};
+
+            static thread_local FramePool *sCurrent;
+
+            void addChunk(size_t numOfBlocks);
+    };
+
+    /**
+     * @brief Coroutine of a simulated entity, it starts suspended and runs whenever it is resumed
+     *          until its next co_await. The frame comes from the FramePool made current by a FramePool::Scope
+     *          of the owner, without one it is allocated on the heap.
+     */
+    class SimTask
+    {
+        public:
+            struct promise_type {
+                SimTask get_return_object() { return SimTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                std::suspend_always final_suspend  () noexcept { return {}; }
+                void return_void        () {}
+                void unhandled_exception() { std::terminate(); }
+
+                static void *operator new(size_t size) { return FramePool::allocateCurrent(size); }
+                static void  operator delete(void *frame, size_t) { FramePool::release(frame); }
+            };
+
+            SimTask() {}
+            SimTask(const SimTask &) = delete;
+            SimTask &operator=(const SimTask &) = delete;
+            SimTask(SimTask &&other) noexcept :
+                mHandle(std::exchange(other.mHandle, nullptr)) {}
+            SimTask &operator=(SimTask &&other) noexcept {
+                std::swap(mHandle, other.mHandle);
+                return *this;
+            }
+            ~SimTask() {
+                if(mHandle) {
+                    mHandle.destroy();
+                }
+            }
+
+            std::coroutine_handle<> handle() const { return mHandle; }
+
+        private:
+            explicit SimTask(std::coroutine_handle<promise_type> handle) :
+                mHandle(handle) {}
+
+            std::coroutine_handle<promise_type> mHandle {nullptr};
+    };
+
+    /**
+     * @brief Single-threaded scheduler of the simulated minutes,
+     *          a coroutine suspended by co_await delay(n) is resumed in the minute now + n and not before.
+     *          Coroutines of the same minute are resumed in the order they were suspended.
+     */
+    class EventScheduler
+    {
+        public:
+            EventScheduler() {}
+            virtual ~EventScheduler() {}
+
+            struct DelayAwaiter {
+                EventScheduler *events  {nullptr};
+                long            minutes {0};
+
+                bool await_ready  () const noexcept { return minutes <= 0; }
+                void await_suspend(std::coroutine_handle<> handle) { events->schedule(handle, events->now() + minutes); }
+                void await_resume () const noexcept {}
+            };
+
+            DelayAwaiter delay(long minutes) { return DelayAwaiter(this, minutes); }
+
+            void          reserve   (size_t numOfTimers);
+            void          schedule  (std::coroutine_handle<> handle, unsigned long minute);
+            void          advanceTo (unsigned long minute) { mNow = minute; }
+            size_t        resumeDue ();
+            unsigned long now       () const { return mNow; }
+            size_t        pending   () const { return mTimers.size(); }
+            FramePool    &framePool ()       { return mFramePool; }
+
+        private:
+            struct Timer {
+                unsigned long           minute {0};
+                unsigned long           seq    {0};
+                std::coroutine_handle<> handle {nullptr};
+
+                bool operator>(const Timer &other) const {
+                    return (minute != other.minute) ? (minute > other.minute) : (seq > other.seq);
+                }
+            };
+
+            unsigned long      mNow    {0};
+            unsigned long      mSeq    {0};
+            std::vector<Timer> mTimers {};          // min-heap by minute and seq
+            FramePool          mFramePool;
+    };
+}
+
+#endif // EVENT_SCHEDULER_H
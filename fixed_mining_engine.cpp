@@ -0,0 +1,68 @@
+#include "fixed_mining_engine.h"
+
+namespace {
+    /**
+     * @brief Instantiate the engine of the layout that matches the fleet and station count
+     *
+     * @param cfg
+     * @return std::unique_ptr<Lunar::SimulationEngine> nullptr if there is no such layout
+     */
+    template <size_t... L>
+    std::unique_ptr<Lunar::SimulationEngine> createForLayout(Lunar::Config *cfg, std::index_sequence<L...>)
+    {
+        using Lunar::FIXED_LAYOUTS;
+
+        auto numOfTrucks   = cfg->numOfTrucks();
+        auto numOfStations = cfg->numOfUnloadStations();
+
+        std::unique_ptr<Lunar::SimulationEngine> engine;
+        ((numOfTrucks   == FIXED_LAYOUTS[L].numOfTrucks &&
+          numOfStations == FIXED_LAYOUTS[L].numOfStations &&
+          (engine = std::make_unique<Lunar::FixedMiningEngine<FIXED_LAYOUTS[L].numOfTrucks,
+                                                              FIXED_LAYOUTS[L].numOfStations,
+                                                              Lunar::SchedulingPolicy::GREEDY>>(cfg), true)) || ...);
+
+        return engine;
+    }
+}
+
+/**
+ * @brief Check if the fixed engine can run the config:
+ *          one of the fixed layouts, greedy scheduling and neither site-file nor fleet-events,
+ *          the trace-events are only written by the reporting MiningController
+ *
+ * @param cfg
+ * @return true
+ * @return false
+ */
+bool
+Lunar::hasFixedEngine(Config &cfg)
+{
+    if(cfg.schedulingPolicy() != static_cast<int>(SchedulingPolicy::GREEDY) ||
+       cfg.siteFile().empty()       == false ||
+       cfg.fleetEventFile().empty() == false) {
+        return false;
+    }
+
+    auto numOfTrucks   = cfg.numOfTrucks();
+    auto numOfStations = cfg.numOfUnloadStations();
+    return std::ranges::any_of(FIXED_LAYOUTS, [&] (const FixedLayout &layout) {
+        return layout.numOfTrucks == numOfTrucks && layout.numOfStations == numOfStations;
+    });
+}
+
+/**
+ * @brief Create the fixed engine of the config
+ *
+ * @param cfg
+ * @return std::unique_ptr<Lunar::SimulationEngine> nullptr if the config has no fixed engine
+ */
+std::unique_ptr<Lunar::SimulationEngine>
+Lunar::createFixedEngine(Config *cfg)
+{
+    if(hasFixedEngine(*cfg) == false) {
+        return nullptr;
+    }
+
+    return createForLayout(cfg, std::make_index_sequence<FIXED_LAYOUTS.size()>());
+}
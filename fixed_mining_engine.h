@@ -0,0 +1,516 @@
+#ifndef FIXED_MINING_ENGINE_H
+#define FIXED_MINING_ENGINE_H
+
+#include "service_include.h"
+#include "config.h"
+#include "simulation_engine.h"
+#include "warm_up_detector.h"
+
+#include <array>
+#include <utility>
+
+namespace Lunar {
+
+    // fleet x station layout of a standard site
+    struct FixedLayout {
+        int numOfTrucks   {0};
+        int numOfStations {0};
+    };
+
+    // the layouts the fixed engine is built for, each one is a separate instantiation
+    constexpr std::array<FixedLayout, 7> FIXED_LAYOUTS {{
+        {7, 1}, {10, 1}, {11, 3}, {20, 2}, {50, 3}, {100, 10}, {200, 12}
+    }};
+
+    bool                              hasFixedEngine   (Config &cfg);
+    std::unique_ptr<SimulationEngine> createFixedEngine(Config *cfg);
+
+    /**
+     * @brief Simulation engine specialized at compile time for the number of trucks, unload-stations
+     *          and the scheduling policy, the counterpart of the MiningController for the Monte Carlo runs of the fixed layouts.
+     *          Trucks, stations, station queues and the scheduling order are std::arrays of the fixed size,
+     *          there are no slot maps, no ids and no per-entity calls, the station selection is unrolled over the station count.
+     *          It reproduces the reference engine minute by minute for runs without site-file and fleet-events (VERIFY_ENGINE=1).
+     *
+     * @tparam NumOfTrucks
+     * @tparam NumOfStations
+     * @tparam Policy
+     */
+    template <int NumOfTrucks, int NumOfStations, SchedulingPolicy Policy>
+    class FixedMiningEngine : public SimulationEngine
+    {
+        static_assert(NumOfTrucks > 0 && NumOfStations > 0, "the fixed engine needs trucks and unload-stations");
+        static_assert(Policy == SchedulingPolicy::GREEDY,
+                      "the batch assignment depends on the time budget of the solver, only the greedy policy is reproducible");
+
+        public:
+            FixedMiningEngine(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~FixedMiningEngine() {}
+
+            /**
+             * @brief Read the run-time, the bays and the seed, the config has to match the layout
+             *
+             * @return ServiceStatus
+             */
+            ServiceStatus init() override
+            {
+                if(mCfg->numOfTrucks() != NumOfTrucks || mCfg->numOfUnloadStations() != NumOfStations ||
+                   mCfg->schedulingPolicy() != static_cast<int>(Policy)) {
+                    std::cerr << "[FE-ERROR], Config doesn't match the layout Trucks:" << NumOfTrucks
+                              << ", UnloadStations:" << NumOfStations << std::endl;
+                    return ServiceStatus::ERROR;
+                }
+
+                auto simulationDuration = mCfg->simRunTimeInHours();
+                mRunTime   = hourToMinutes((simulationDuration > 1) ? simulationDuration : Lunar::SIMULATION_TIME_HOURS);
+                mWarmUp    = mCfg->warmUpDetection() > 0;
+                mClock     = 0;
+
+                auto seed = mCfg->rngSeed();
+                for (int t {0}; t < NumOfTrucks; t++) {
+                    mTrucks[t] = FixedTruck();
+                    if(seed >= 0) {
+                        mTrucks[t].rng    = RandomStream(seed, t);
+                        mTrucks[t].seeded = true;
+                    }
+                    mTruckOrder[t] = OrderEntry(0, t);
+                }
+
+                for (int s {0}; s < NumOfStations; s++) {
+                    auto bays = mCfg->unloadStationBays(s);
+                    if(bays < 1) {
+                        std::cerr << "[FE-ERROR], UnloadStation:" << s << ", Number of bays:" << bays
+                                  << ", using " << Lunar::UNLOAD_STATION_BAYS << std::endl;
+                        bays = Lunar::UNLOAD_STATION_BAYS;
+                    }
+                    mStations[s] = FixedStation();
+                    // a queue holds every truck at most, one more bay than trucks is never busy
+                    mStations[s].numOfBays = std::min(bays, NumOfTrucks + 1);
+                    mStationOrder[s] = OrderEntry(0, s);
+                }
+
+                // the deliveries are logged for the warm-up detection only, the bound is the one of the reference engine
+                mDeliveryLog.clear();
+                if(mWarmUp) {
+                    mDeliveryLog.reserve(NumOfTrucks * (mRunTime / hourToMinutes(LOADING_TIME_MIN_HOURS) + 1));
+                }
+
+                return ServiceStatus::SUCESS;
+            }
+
+            void startServices() override
+            {
+                for (auto &trk : mTrucks) {
+                    trk.clockOffset = mClock;
+                    tickTruck(trk);
+                }
+                for (auto &stat : mStations) {
+                    tickStation(stat);
+                }
+            }
+
+            void step() override
+            {
+                mClock++;
+
+                for (auto &trk : mTrucks) {
+                    tickTruck(trk);
+                }
+                for (auto &stat : mStations) {
+                    tickStation(stat);
+                }
+
+                releaseDoneTrucks();
+                assignWaitingTrucks();
+            }
+
+            unsigned long clock  () override { return mClock;   }
+            long          runTime() override { return mRunTime; }
+
+            void snapshot(EngineSnapshot &snap) override
+            {
+                snap.minute     = mClock;
+                snap.deliveries = 0;
+                snap.truckStates.resize(NumOfTrucks);
+                snap.stationQueues.resize(NumOfStations);
+
+                for (int t {0}; t < NumOfTrucks; t++) {
+                    snap.truckStates[t] = mTrucks[t].state;
+                    snap.deliveries    += mTrucks[t].deliveries;
+                }
+                for (int s {0}; s < NumOfStations; s++) {
+                    snap.stationQueues[s] = mStations[s].queueSize;
+                }
+            }
+
+            MiningSummary summary() override
+            {
+                MiningSummary sum;
+
+                sum.runTime       = mRunTime;
+                sum.numOfStations = NumOfStations;
+                sum.numOfTrucks   = NumOfTrucks;
+                for (auto &trk : mTrucks) {
+                    sum.deliveries    += trk.deliveries;
+                    sum.totalWaitTime += trk.totalWaitTime;
+                }
+                sum.meanWaitTime = (sum.deliveries > 0) ? static_cast<double>(sum.totalWaitTime) / sum.deliveries : 0.0;
+
+                if(mWarmUp) {
+                    summarizeSteadyState(sum);
+                }
+
+                return sum;
+            }
+
+        private:
+            static constexpr int DRIVE_TIME  {(Lunar::DRIVE_TIME_MINUTES * Lunar::TRUCK_SPEED_PERCENT + Lunar::TRUCK_SPEED_PERCENT - 1)
+                                              / Lunar::TRUCK_SPEED_PERCENT};
+            static constexpr int UNLOAD_TIME {Lunar::UNLOAD_TIME_MINUTES};
+
+            struct FixedTruck {
+                long         clock        {0};      // restarts with every cycle like the truck of the reference engine
+                long         clockOffset  {0};
+                TruckState   state        {TruckState::IDEL};
+                long         loadingStart {0};
+                int          loadingTime  {0};
+                long         drivingStart {0};
+                long         arrivalTime  {0};
+                int          stationIdx   {-1};
+                int          deliveries   {0};
+                long         totalWaitTime{0};
+                bool         seeded       {false};
+                RandomStream rng          {};
+            };
+
+            struct QueueEntry {
+                int  trkIdx      {-1};
+                long arrivalTime {0};
+                long startTime   {0};
+                bool isDone      {false};
+            };
+
+            // the bays are the front of the queue, the waiting trucks follow
+            struct FixedStation {
+                long                                  clock    {0};
+                UnloadStationState                    state    {UnloadStationState::IDEL};
+                int                                   numOfBays{Lunar::UNLOAD_STATION_BAYS};
+                int                                   busyBays {0};
+                int                                   doneBays {0};
+                int                                   queueSize{0};
+                std::array<QueueEntry, NumOfTrucks>   queue    {};
+                std::array<long, NumOfTrucks + 1>     bayFree  {};
+            };
+
+            struct OrderEntry {
+                long key {0};
+                int  idx {0};
+            };
+
+            Config *mCfg {nullptr};
+
+            unsigned long mClock   {0};
+            long          mRunTime {0};
+            bool          mWarmUp  {false};
+
+            std::array<FixedTruck,   NumOfTrucks>   mTrucks       {};
+            std::array<FixedStation, NumOfStations> mStations     {};
+            std::array<OrderEntry,   NumOfTrucks>   mTruckOrder   {};
+            std::array<OrderEntry,   NumOfStations> mStationOrder {};
+            std::vector<TruckDeliveryLog>           mDeliveryLog  {};
+
+            /**
+             * @brief State machine of a truck, the same stages as Truck::tick without routes
+             *
+             * @param trk
+             */
+            void tickTruck(FixedTruck &trk)
+            {
+                trk.clock++;
+                switch (trk.state)
+                {
+                    case TruckState::IDEL:
+                        trk.clockOffset += trk.clock;
+                        trk.clock        = 0;
+                        trk.loadingStart = 0;
+                        trk.loadingTime  = trk.seeded ? generateLoadingTime(trk.rng) : generateLoadingTime();
+                        trk.state        = TruckState::LOADING;
+                        break;
+
+                    case TruckState::LOADING:
+                        if(trk.clock >= trk.loadingStart + trk.loadingTime) {
+                            trk.drivingStart = trk.clock;
+                            trk.state        = TruckState::DRIVING;
+                        }
+                        break;
+
+                    case TruckState::DRIVING:
+                        if(trk.clock >= trk.drivingStart + DRIVE_TIME) {
+                            trk.arrivalTime = trk.clock;
+                            trk.state       = TruckState::WAITING_FOR_UNLOAD_STATION;
+                        }
+                        break;
+
+                    case TruckState::UNLOADING_DONE: {
+                        auto waitTime = trk.clock - trk.arrivalTime;
+                        trk.deliveries++;
+                        trk.totalWaitTime += waitTime;
+                        if(mWarmUp) {
+                            mDeliveryLog.push_back(TruckDeliveryLog(trk.stationIdx, static_cast<int>(waitTime),
+                                                                    trk.clockOffset + trk.clock));
+                        }
+                        trk.stationIdx = -1;
+                        trk.state      = TruckState::IDEL;
+                    }
+                    break;
+
+                    default:
+                        break;
+                }
+            }
+
+            /**
+             * @brief State machine of a station, the same stages as UnloadStation::tick
+             *
+             * @param stat
+             */
+            static void tickStation(FixedStation &stat)
+            {
+                stat.clock++;
+
+                // flag the trucks in the bays that reached their deadline
+                for (int b {0}; b < stat.busyBays; b++) {
+                    auto &bay = stat.queue[b];
+                    if(bay.isDone == false && bay.startTime + UNLOAD_TIME <= stat.clock) {
+                        bay.isDone = true;
+                        stat.doneBays++;
+                    }
+                }
+
+                startUnloading(stat);
+                updateState(stat);
+            }
+
+            /**
+             * @brief Fill the free bays, the waiting part of the queue is sorted by the latest arrival first
+             *          and the started trucks move behind the busy bays, like UnloadStation::startUnloading
+             *
+             * @param stat
+             */
+            static void startUnloading(FixedStation &stat)
+            {
+                if(stat.busyBays >= stat.numOfBays || stat.queueSize <= stat.busyBays) {
+                    return;
+                }
+
+                // stable insertion sort, the queue is nearly sorted
+                for (int i {stat.busyBays + 1}; i < stat.queueSize; i++) {
+                    auto entry = stat.queue[i];
+                    auto j     = i;
+                    for (; j > stat.busyBays && stat.queue[j - 1].arrivalTime < entry.arrivalTime; j--) {
+                        stat.queue[j] = stat.queue[j - 1];
+                    }
+                    stat.queue[j] = entry;
+                }
+
+                for (int i {stat.busyBays}; stat.busyBays < stat.numOfBays && i < stat.queueSize; i++) {
+                    if(stat.queue[i].arrivalTime > static_cast<long>(stat.clock)) {
+                        continue;
+                    }
+                    auto entry = stat.queue[i];
+                    for (auto j {i}; j > stat.busyBays; j--) {
+                        stat.queue[j] = stat.queue[j - 1];
+                    }
+                    entry.startTime = stat.clock;
+                    stat.queue[stat.busyBays++] = entry;
+                }
+            }
+
+            static void updateState(FixedStation &stat)
+            {
+                if(stat.doneBays > 0) {
+                    stat.state = UnloadStationState::UNLOADING_DONE;
+                }
+                else if(stat.busyBays > 0) {
+                    stat.state = UnloadStationState::UNLOADING;
+                }
+                else {
+                    stat.state = UnloadStationState::IDEL;
+                }
+            }
+
+            /**
+             * @brief Remove the first truck that is done from the queue
+             *
+             * @param stat
+             * @return int truck index
+             */
+            static int releaseTruck(FixedStation &stat)
+            {
+                int pos {0};
+                while (stat.queue[pos].isDone == false) {
+                    pos++;
+                }
+
+                auto trkIdx = stat.queue[pos].trkIdx;
+                for (; pos + 1 < stat.queueSize; pos++) {
+                    stat.queue[pos] = stat.queue[pos + 1];
+                }
+                stat.queueSize--;
+                stat.busyBays--;
+                stat.doneBays--;
+                updateState(stat);
+
+                return trkIdx;
+            }
+
+            /**
+             * @brief Time until a bay is free for a truck that joins the queue now, like UnloadStation::totalWaitTime
+             *
+             * @param stat
+             * @return long
+             */
+            static long totalWaitTime(FixedStation &stat)
+            {
+                if(stat.queueSize == 0) {
+                    return 0;
+                }
+
+                auto bays = stat.bayFree.begin() + stat.numOfBays;
+                std::fill(stat.bayFree.begin(), bays, 0);
+                size_t bay {0};
+
+                for (int i {0}; i < stat.queueSize; i++) {
+                    auto &trk = stat.queue[i];
+                    if(trk.isDone) {
+                        bay++;
+                    }
+                    else if(trk.startTime > 0) {
+                        auto leftTime = (trk.startTime + UNLOAD_TIME) - static_cast<long>(stat.clock);
+                        stat.bayFree[bay++ % stat.numOfBays] = std::max(leftTime, 0L);
+                    }
+                    else {
+                        *std::min_element(stat.bayFree.begin(), bays) += UNLOAD_TIME;
+                    }
+                }
+
+                return *std::min_element(stat.bayFree.begin(), bays);
+            }
+
+            /**
+             * @brief Release the trucks that are done, the stations are visited in the scheduling order
+             *
+             */
+            void releaseDoneTrucks()
+            {
+                for (auto &entry : mStationOrder) {
+                    auto &stat = mStations[entry.idx];
+                    while (stat.state == UnloadStationState::UNLOADING_DONE) {
+                        auto &trk = mTrucks[releaseTruck(stat)];
+                        if(trk.state == TruckState::UNLOADING) {
+                            trk.state = TruckState::UNLOADING_DONE;
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @brief Greedy assignment of the waiting trucks, the longest waiting truck gets the station
+             *          with the least wait, like UnloadStationScheduler::checkForUnloadingRequest
+             *
+             */
+            void assignWaitingTrucks()
+            {
+                sortStationsForWaitTime();
+                sortTrucksForWaitTime();
+
+                int statPos {0};
+                for (auto &entry : mTruckOrder) {
+                    if(statPos == NumOfStations) {
+                        sortStationsForWaitTime();
+                        statPos = 0;
+                    }
+
+                    auto &trk = mTrucks[entry.idx];
+                    if(trk.state == TruckState::WAITING_FOR_UNLOAD_STATION && trk.stationIdx < 0) {
+                        auto &stat = mStations[mStationOrder[statPos].idx];
+                        trk.stationIdx = mStationOrder[statPos].idx;
+                        trk.state      = TruckState::UNLOADING;
+                        stat.queue[stat.queueSize++] = QueueEntry(entry.idx, stat.clock, 0, false);
+                        statPos++;
+                    }
+                }
+            }
+
+            // the station keys are computed unrolled over the station count
+            void sortStationsForWaitTime()
+            {
+                [this] <size_t... S> (std::index_sequence<S...>) {
+                    ((mStationOrder[S].key = totalWaitTime(mStations[mStationOrder[S].idx])), ...);
+                }(std::make_index_sequence<NumOfStations>());
+                stableSortByKey(mStationOrder);
+            }
+
+            void sortTrucksForWaitTime()
+            {
+                for (auto &entry : mTruckOrder) {
+                    auto &trk = mTrucks[entry.idx];
+                    entry.key = (trk.state == TruckState::WAITING_FOR_UNLOAD_STATION) ? trk.arrivalTime - trk.clock : 0;
+                }
+                stableSortByKey(mTruckOrder);
+            }
+
+            /**
+             * @brief Stable insertion sort by ascending key, the order is sorted in most minutes,
+             *          so it is a single pass then
+             *
+             * @param order
+             */
+            template <size_t N>
+            static void stableSortByKey(std::array<OrderEntry, N> &order)
+            {
+                for (size_t i {1}; i < N; i++) {
+                    if(order[i - 1].key <= order[i].key) {
+                        continue;
+                    }
+                    auto entry = order[i];
+                    auto j     = i;
+                    for (; j > 0 && order[j - 1].key > entry.key; j--) {
+                        order[j] = order[j - 1];
+                    }
+                    order[j] = entry;
+                }
+            }
+
+            /**
+             * @brief Detect the warm-up by MSER-5 on the deliveries per minute, like MiningController::summarizeSteadyState
+             *
+             * @param sum
+             */
+            void summarizeSteadyState(MiningSummary &sum)
+            {
+                std::vector<double> throughput(mClock + 1, 0.0);
+                for (auto &log : mDeliveryLog) {
+                    if(log.doneTime >= 0 && log.doneTime < static_cast<long>(throughput.size())) {
+                        throughput[log.doneTime] += 1.0;
+                    }
+                }
+
+                sum.warmUpTime = WarmUpDetector::mser5(throughput);
+
+                long waitTime {0};
+                for (auto &log : mDeliveryLog) {
+                    if(log.doneTime > sum.warmUpTime) {
+                        sum.steadyDeliveries++;
+                        waitTime += log.waitTime;
+                    }
+                }
+
+                sum.steadyMeanWaitTime = (sum.steadyDeliveries > 0) ? static_cast<double>(waitTime) / sum.steadyDeliveries : 0.0;
+            }
+    };
+}
+
+#endif // FIXED_MINING_ENGINE_H
@@ -0,0 +1,283 @@
+#include "live_snapshot.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <thread>
+
+/**
+ * @brief Destroy the Lunar:: Live Snapshot Writer:: Live Snapshot Writer object
+ *
+ */
+Lunar::LiveSnapshotWriter::~LiveSnapshotWriter()
+{
+    close();
+}
+
+/**
+ * @brief Create the shared-memory region, e.g. "/lunar_mining", a stale region of the same name is replaced.
+ *          The stale one is unlinked, not truncated, so a monitor that still maps it keeps a valid mapping
+ *
+ * @param name
+ * @param truckCapacity
+ * @param stationCapacity
+ * @return false if the region can't be created
+ */
+bool
+Lunar::LiveSnapshotWriter::open(const std::string &name, uint32_t truckCapacity, uint32_t stationCapacity)
+{
+    close();
+    if(name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+        std::cerr << "[LS-ERROR], Invalid shared-memory name:" << name << ", e.g. /lunar_mining" << std::endl;
+        return false;
+    }
+
+    auto truckOffset   = (sizeof(LiveSnapshotHeader) + 7) / 8 * 8;
+    auto stationOffset = truckOffset + (truckCapacity + 7) / 8 * 8;
+    mSize = stationOffset + stationCapacity * sizeof(int32_t);
+
+    shm_unlink(name.c_str());
+    auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0) {
+        std::cerr << "[LS-ERROR], Unable to open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // the new region is zeroed
+    auto *region = (ftruncate(fd, mSize) == 0) ?
+                   mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if(region == MAP_FAILED) {
+        std::cerr << "[LS-ERROR], Unable to map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    mName          = name;
+    mRegion        = region;
+    mFinished      = false;
+    mHeader        = new (region) LiveSnapshotHeader();
+    mTruckStates   = static_cast<uint8_t *>(region) + truckOffset;
+    mStationQueues = reinterpret_cast<int32_t *>(static_cast<uint8_t *>(region) + stationOffset);
+
+    mHeader->version         = LIVE_SNAPSHOT_VERSION;
+    mHeader->truckCapacity   = truckCapacity;
+    mHeader->stationCapacity = stationCapacity;
+    mHeader->truckOffset     = static_cast<uint32_t>(truckOffset);
+    mHeader->stationOffset   = static_cast<uint32_t>(stationOffset);
+    std::atomic_ref<uint64_t>(mHeader->magic).store(LIVE_SNAPSHOT_MAGIC, std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Publish the final state of the run, the monitors stop with it
+ *
+ * @param runState
+ */
+void
+Lunar::LiveSnapshotWriter::finish(LiveRunState runState)
+{
+    if(mHeader == nullptr || mFinished) {
+        return;
+    }
+
+    auto &hdr = begin();
+    storeRelaxed(hdr.runState, static_cast<uint32_t>(runState));
+    end();
+    mFinished = true;
+}
+
+/**
+ * @brief Unmap and remove the region, monitors that mapped it keep the last snapshot,
+ *          a run that was not finished is published as aborted
+ *
+ */
+void
+Lunar::LiveSnapshotWriter::close()
+{
+    if(mRegion == nullptr) {
+        return;
+    }
+
+    finish(LiveRunState::ABORTED);
+
+    munmap(mRegion, mSize);
+    shm_unlink(mName.c_str());
+    mRegion        = nullptr;
+    mHeader        = nullptr;
+    mTruckStates   = nullptr;
+    mStationQueues = nullptr;
+}
+
+/**
+ * @brief Start a snapshot, seq becomes odd
+ *
+ * @return Lunar::LiveSnapshotHeader&
+ */
+Lunar::LiveSnapshotHeader &
+Lunar::LiveSnapshotWriter::begin()
+{
+    std::atomic_ref<uint64_t> seq(mHeader->seq);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return *mHeader;
+}
+
+/**
+ * @brief Publish the snapshot, seq becomes even
+ *
+ */
+void
+Lunar::LiveSnapshotWriter::end()
+{
+    std::atomic_ref<uint64_t> seq(mHeader->seq);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Destroy the Lunar:: Live Snapshot Reader:: Live Snapshot Reader object
+ *
+ */
+Lunar::LiveSnapshotReader::~LiveSnapshotReader()
+{
+    close();
+}
+
+/**
+ * @brief Map the region of a running simulation read-only
+ *
+ * @param name
+ * @return false if there is no valid region of the name
+ */
+bool
+Lunar::LiveSnapshotReader::open(const std::string &name)
+{
+    close();
+
+    auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st {};
+    auto *region = (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(LiveSnapshotHeader)) ?
+                   mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if(region == MAP_FAILED) {
+        return false;
+    }
+
+    mRegion = region;
+    mSize   = st.st_size;
+    mHeader = static_cast<const LiveSnapshotHeader *>(region);
+
+    auto magic = std::atomic_ref<uint64_t>(const_cast<uint64_t &>(mHeader->magic)).load(std::memory_order_acquire);
+    if(magic != LIVE_SNAPSHOT_MAGIC || mHeader->version != LIVE_SNAPSHOT_VERSION ||
+       mHeader->stationOffset + mHeader->stationCapacity * sizeof(int32_t) > mSize) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Unmap the region
+ *
+ */
+void
+Lunar::LiveSnapshotReader::close()
+{
+    if(mRegion != nullptr) {
+        munmap(mRegion, mSize);
+    }
+    mRegion = nullptr;
+    mHeader = nullptr;
+}
+
+/**
+ * @brief Copy a consistent snapshot, it retries while the writer updates the region
+ *
+ * @param snap
+ * @param maxRetries
+ * @return false if no consistent copy was taken within the retries
+ */
+bool
+Lunar::LiveSnapshotReader::read(LiveSnapshot &snap, int maxRetries)
+{
+    if(mHeader == nullptr) {
+        return false;
+    }
+
+    const auto &hdr      = *mHeader;
+    const auto *base     = static_cast<const uint8_t *>(mRegion);
+    const auto *states   = base + hdr.truckOffset;
+    const auto *queues   = reinterpret_cast<const int32_t *>(base + hdr.stationOffset);
+    std::atomic_ref<uint64_t> seq(const_cast<uint64_t &>(hdr.seq));
+
+    for (int r {0}; r <= maxRetries; r++) {
+        if(r > 0) {
+            // give the writer the CPU to finish the snapshot
+            std::this_thread::yield();
+        }
+
+        auto before = seq.load(std::memory_order_acquire);
+        if(before & 1) {
+            mRetries++;
+            continue;
+        }
+
+        snap.minute        = loadRelaxed(hdr.minute);
+        snap.runTime       = loadRelaxed(hdr.runTime);
+        snap.numOfTrucks   = loadRelaxed(hdr.numOfTrucks);
+        snap.numOfStations = loadRelaxed(hdr.numOfStations);
+        snap.runState      = static_cast<LiveRunState>(loadRelaxed(hdr.runState));
+        snap.deliveries    = loadRelaxed(hdr.deliveries);
+        snap.totalWaitTime = loadRelaxed(hdr.totalWaitTime);
+        snap.queuedTrucks  = loadRelaxed(hdr.queuedTrucks);
+        for (size_t s {0}; s < snap.trucksInState.size(); s++) {
+            snap.trucksInState[s] = loadRelaxed(hdr.trucksInState[s]);
+        }
+
+        auto numOfTrucks   = std::min(loadRelaxed(hdr.truckIndices),   hdr.truckCapacity);
+        auto numOfStations = std::min(loadRelaxed(hdr.stationIndices), hdr.stationCapacity);
+        snap.truckStates.resize(numOfTrucks);
+        snap.stationQueues.resize(numOfStations);
+        for (uint32_t t {0}; t < numOfTrucks; t++) {
+            snap.truckStates[t] = loadRelaxed(states[t]);
+        }
+        for (uint32_t s {0}; s < numOfStations; s++) {
+            snap.stationQueues[s] = loadRelaxed(queues[s]);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(seq.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+        mRetries++;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check whether the region of the name is still linked, the writer unlinks it when the run ends
+ *
+ * @param name
+ * @return true
+ * @return false
+ */
+bool
+Lunar::LiveSnapshotReader::exists(const std::string &name)
+{
+    auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0) {
+        return false;
+    }
+
+    ::close(fd);
+    return true;
+}
@@ -0,0 +1,139 @@
+#ifndef LIVE_SNAPSHOT_H
+#define LIVE_SNAPSHOT_H
+
+#include "service_include.h"
+
+#include <atomic>
+#include <array>
+#include <cstring>
+
+namespace Lunar {
+
+    const uint64_t LIVE_SNAPSHOT_MAGIC   {0x4c554e4152534e50};   // "LUNARSNP"
+    const uint32_t LIVE_SNAPSHOT_VERSION {2};
+    const uint8_t  LIVE_SNAPSHOT_RETIRED {0xff};                // truck state of a retired truck
+
+    enum class LiveRunState : uint32_t {
+        RUNNING = 0,
+        FINISHED,               // the run reached its run time
+        ABORTED,                // the run was stopped or interrupted before
+        COUNT
+    };
+
+    /**
+     * @brief Head of the shared-memory region, the truck states (one byte per truck index) and
+     *          the station queue lengths (int32 per station index) follow it.
+     *          Everything after seq is written under the seqlock: seq is odd while the writer updates the snapshot,
+     *          a reader copies the snapshot and retries if seq was odd or changed meanwhile.
+     *          The fields are accessed with relaxed atomic loads/stores, so a torn read is detected, never undefined.
+     */
+    struct LiveSnapshotHeader {
+        uint64_t magic          {0};        // written last, the region is valid once it is set
+        uint32_t version        {0};
+        uint32_t truckCapacity  {0};        // truck indices beyond the capacity are not published
+        uint32_t stationCapacity{0};
+        uint32_t truckOffset    {0};        // of the truck states from the start of the region
+        uint32_t stationOffset  {0};        // of the station queues from the start of the region
+        uint32_t reserved       {0};
+
+        alignas(64) uint64_t seq {0};
+
+        uint64_t minute         {0};
+        uint64_t runTime        {0};
+        uint32_t numOfTrucks    {0};        // alive trucks
+        uint32_t numOfStations  {0};        // open stations
+        uint32_t truckIndices   {0};        // trucks ever created, the published states are min(truckIndices, truckCapacity)
+        uint32_t stationIndices {0};
+        uint32_t runState       {0};        // LiveRunState, the last snapshot of a run is not RUNNING
+        uint64_t deliveries     {0};        // incl. the retired trucks
+        uint64_t totalWaitTime  {0};
+        uint64_t queuedTrucks   {0};        // in all station queues
+        uint32_t trucksInState[static_cast<size_t>(TruckState::COUNT)] {};
+    };
+
+    static_assert(std::atomic_ref<uint64_t>::is_always_lock_free, "the seqlock needs lock-free 64-bit atomics");
+
+    // consistent copy of the region, taken by a reader
+    struct LiveSnapshot {
+        uint64_t minute        {0};
+        uint64_t runTime       {0};
+        uint32_t numOfTrucks   {0};
+        uint32_t numOfStations {0};
+        LiveRunState runState  {LiveRunState::RUNNING};
+        uint64_t deliveries    {0};
+        uint64_t totalWaitTime {0};
+        uint64_t queuedTrucks  {0};
+        std::array<uint32_t, static_cast<size_t>(TruckState::COUNT)> trucksInState {};
+        std::vector<uint8_t> truckStates   {};
+        std::vector<int32_t> stationQueues {};
+    };
+
+    template <typename T>
+    inline void storeRelaxed(T &field, T value) { std::atomic_ref<T>(field).store(value, std::memory_order_relaxed); }
+
+    template <typename T>
+    inline T loadRelaxed(const T &field) { return std::atomic_ref<T>(const_cast<T &>(field)).load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Writer of the live snapshot, it creates the POSIX shared-memory region and publishes a snapshot per tick.
+     *          The writer never waits for the readers, any number of monitor processes can map the region.
+     */
+    class LiveSnapshotWriter
+    {
+        public:
+            LiveSnapshotWriter() {}
+            LiveSnapshotWriter(const LiveSnapshotWriter &) = delete;
+            LiveSnapshotWriter &operator=(const LiveSnapshotWriter &) = delete;
+            virtual ~LiveSnapshotWriter();
+
+            bool open  (const std::string &name, uint32_t truckCapacity, uint32_t stationCapacity);
+            void finish(LiveRunState runState);
+            void close ();
+            bool isOpen() const { return mHeader != nullptr; }
+
+            // the snapshot is written between begin and end
+            LiveSnapshotHeader &begin();
+            void end();
+
+            uint8_t *truckStates  () { return mTruckStates;   }
+            int32_t *stationQueues() { return mStationQueues; }
+
+        private:
+            std::string         mName          {};
+            void               *mRegion        {nullptr};
+            size_t              mSize          {0};
+            LiveSnapshotHeader *mHeader        {nullptr};
+            uint8_t            *mTruckStates   {nullptr};
+            int32_t            *mStationQueues {nullptr};
+            bool                mFinished      {false};
+    };
+
+    /**
+     * @brief Reader of the live snapshot for monitor processes, it maps the region read-only
+     */
+    class LiveSnapshotReader
+    {
+        public:
+            LiveSnapshotReader() {}
+            LiveSnapshotReader(const LiveSnapshotReader &) = delete;
+            LiveSnapshotReader &operator=(const LiveSnapshotReader &) = delete;
+            virtual ~LiveSnapshotReader();
+
+            bool open (const std::string &name);
+            void close();
+
+            bool read(LiveSnapshot &snap, int maxRetries = LIVE_SNAPSHOT_READ_RETRIES);
+
+            static bool exists(const std::string &name);
+
+            unsigned long retries() const { return mRetries; }
+
+        private:
+            void                     *mRegion  {nullptr};
+            size_t                    mSize    {0};
+            const LiveSnapshotHeader *mHeader  {nullptr};
+            unsigned long             mRetries {0};
+    };
+}
+
+#endif // LIVE_SNAPSHOT_H
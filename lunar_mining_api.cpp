@@ -0,0 +1,219 @@
+#include "lunar_mining_api.h"
+#include "mining_controller.h"
+
+/**
+ * @brief A simulation owns its config, the controller only keeps a pointer to it
+ *
+ */
+struct LunarMiningSimulation {
+    Lunar::Config           cfg;
+    Lunar::MiningController ctrl;
+
+    LunarMiningSimulation() :
+        cfg(""), ctrl(&cfg) {}
+};
+
+namespace {
+
+    /**
+     * @brief Check the config up front, the controller would log and fall back to defaults instead
+     *
+     * @param cfg
+     * @return true
+     * @return false
+     */
+    bool isValid(const LunarMiningConfig &cfg)
+    {
+        if(cfg.numOfTrucks < 1 || cfg.numOfUnloadStations < 1 || cfg.batchAssignmentBudgetUs < 0) {
+            return false;
+        }
+
+        if(cfg.schedulingPolicy < 0 || cfg.schedulingPolicy >= static_cast<int>(Lunar::SchedulingPolicy::COUNT)) {
+            return false;
+        }
+
+        return true;
+    }
+}
+
+/**
+ * @brief Returns the version of the API the library was built with
+ *
+ * @return int
+ */
+int
+lunar_mining_api_version(void)
+{
+    return LUNAR_MINING_API_VERSION;
+}
+
+/**
+ * @brief Fill the config with the defaults of mining.cfg, the fleet has to be set by the caller
+ *
+ * @param cfg
+ */
+void
+lunar_mining_default_config(LunarMiningConfig *cfg)
+{
+    if(cfg == nullptr) {
+        return;
+    }
+
+    cfg->numOfTrucks             = 0;
+    cfg->numOfUnloadStations     = 0;
+    cfg->unloadStationBays       = nullptr;
+    cfg->simulationHours         = Lunar::SIMULATION_TIME_HOURS;
+    cfg->schedulingPolicy        = static_cast<int>(Lunar::SchedulingPolicy::GREEDY);
+    cfg->batchAssignmentBudgetUs = Lunar::BATCH_ASSIGNMENT_BUDGET_US;
+    cfg->rngSeed                 = Lunar::DEFAULT_RNG_SEED;
+    cfg->warmUpDetection         = 0;
+}
+
+/**
+ * @brief Create and initialize an unpaced, silent simulation
+ *
+ * @param cfg
+ * @param sim  set to the new simulation on success
+ * @return LunarMiningStatus
+ */
+LunarMiningStatus
+lunar_mining_create(const LunarMiningConfig *cfg, LunarMiningSimulation **sim)
+{
+    if(cfg == nullptr || sim == nullptr || isValid(*cfg) == false) {
+        return LUNAR_MINING_INVALID_ARGUMENT;
+    }
+    *sim = nullptr;
+
+    try {
+        auto s = std::make_unique<LunarMiningSimulation>();
+
+        s->cfg.set(Lunar::ServiceParams::TRUCK,                 cfg->numOfTrucks);
+        s->cfg.set(Lunar::ServiceParams::UNLOAD_STATION,        cfg->numOfUnloadStations);
+        s->cfg.set(Lunar::ServiceParams::SIMULATION_TIME_HOURS, cfg->simulationHours);
+        s->cfg.set(Lunar::ServiceParams::SCHEDULING_POLICY,     cfg->schedulingPolicy);
+        s->cfg.set(Lunar::ServiceParams::BATCH_ASSIGNMENT_BUDGET_US, cfg->batchAssignmentBudgetUs);
+        s->cfg.set(Lunar::ServiceParams::RNG_SEED,              cfg->rngSeed);
+        s->cfg.set(Lunar::ServiceParams::WARMUP_DETECTION,      cfg->warmUpDetection);
+        if(cfg->unloadStationBays != nullptr) {
+            s->cfg.set(Lunar::ServiceParams::UNLOAD_STATION_BAYS, std::string(cfg->unloadStationBays));
+        }
+
+        for (int idx {0}; idx < cfg->numOfUnloadStations; idx++) {
+            if(s->cfg.unloadStationBays(idx) < 1) {
+                return LUNAR_MINING_INVALID_ARGUMENT;
+            }
+        }
+
+        s->ctrl.setPaced(false);
+        s->ctrl.setReporting(false);
+        if(s->ctrl.init() != Lunar::ServiceStatus::SUCESS) {
+            return LUNAR_MINING_INIT_FAILED;
+        }
+        s->ctrl.startServices();
+
+        *sim = s.release();
+    }
+    catch (const std::bad_alloc &) {
+        return LUNAR_MINING_OUT_OF_MEMORY;
+    }
+    catch (...) {
+        return LUNAR_MINING_INIT_FAILED;
+    }
+
+    return LUNAR_MINING_OK;
+}
+
+/**
+ * @brief Advance the simulation by the given minutes, it stops at the end of the run-time
+ *
+ * @param sim
+ * @param minutes  <= 0: run to completion
+ * @return long  minutes simulated, a negative LunarMiningStatus on errors
+ */
+long
+lunar_mining_run(LunarMiningSimulation *sim, long minutes)
+{
+    if(sim == nullptr) {
+        return LUNAR_MINING_INVALID_ARGUMENT;
+    }
+
+    auto end   = static_cast<unsigned long>(sim->ctrl.runTime()) + 1;
+    auto start = sim->ctrl.clock();
+    if(minutes > 0) {
+        end = std::min(end, start + static_cast<unsigned long>(minutes));
+    }
+
+    try {
+        while (sim->ctrl.clock() < end) {
+            sim->ctrl.step();
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return LUNAR_MINING_OUT_OF_MEMORY;
+    }
+
+    return static_cast<long>(sim->ctrl.clock() - start);
+}
+
+/**
+ * @brief Check if the simulation reached the end of its run-time
+ *
+ * @param sim
+ * @return int 1: done, 0: not done or invalid
+ */
+int
+lunar_mining_done(LunarMiningSimulation *sim)
+{
+    if(sim == nullptr) {
+        return 0;
+    }
+
+    return (sim->ctrl.clock() > static_cast<unsigned long>(sim->ctrl.runTime())) ? 1 : 0;
+}
+
+/**
+ * @brief Summarize the simulation up to the current minute
+ *
+ * @param sim
+ * @param res
+ * @return LunarMiningStatus
+ */
+LunarMiningStatus
+lunar_mining_result(LunarMiningSimulation *sim, LunarMiningResult *res)
+{
+    if(sim == nullptr || res == nullptr) {
+        return LUNAR_MINING_INVALID_ARGUMENT;
+    }
+
+    try {
+        auto sum = sim->ctrl.summary();
+
+        res->minute             = static_cast<long>(sim->ctrl.clock());
+        res->runTime            = sum.runTime;
+        res->numOfStations      = sum.numOfStations;
+        res->numOfTrucks        = sum.numOfTrucks;
+        res->deliveries         = sum.deliveries;
+        res->totalWaitTime      = sum.totalWaitTime;
+        res->meanWaitTime       = sum.meanWaitTime;
+        res->payload            = sum.payload;
+        res->warmUpTime         = sum.warmUpTime;
+        res->steadyDeliveries   = sum.steadyDeliveries;
+        res->steadyMeanWaitTime = sum.steadyMeanWaitTime;
+    }
+    catch (const std::bad_alloc &) {
+        return LUNAR_MINING_OUT_OF_MEMORY;
+    }
+
+    return LUNAR_MINING_OK;
+}
+
+/**
+ * @brief Release the simulation, nullptr is ignored
+ *
+ * @param sim
+ */
+void
+lunar_mining_destroy(LunarMiningSimulation *sim)
+{
+    delete sim;
+}
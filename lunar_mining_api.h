@@ -0,0 +1,100 @@
+#ifndef LUNAR_MINING_API_H
+#define LUNAR_MINING_API_H
+
+/*
+ * Embeddable API of the mining simulation, usable from C and C++.
+ * A simulation is created from an in-memory config, driven minute by minute or to completion,
+ * and its results are returned as plain structs; nothing is read from files or printed.
+ * Simulations are independent, several of them may run on different threads of one process.
+ */
+
+#define LUNAR_MINING_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum LunarMiningStatus {
+    LUNAR_MINING_OK               =  0,
+    LUNAR_MINING_INVALID_ARGUMENT = -1,
+    LUNAR_MINING_INIT_FAILED      = -2,
+    LUNAR_MINING_OUT_OF_MEMORY    = -3
+} LunarMiningStatus;
+
+/* Parameters of a run, the counterpart of mining.cfg; start from lunar_mining_default_config() */
+typedef struct LunarMiningConfig {
+    int         numOfTrucks;
+    int         numOfUnloadStations;
+    const char *unloadStationBays;        /* one count or a comma separated count per station, NULL: 1 bay */
+    int         simulationHours;          /* values below 2 keep the default run-time of 72 hours */
+    int         schedulingPolicy;         /* 0: greedy, 1: batch assignment */
+    int         batchAssignmentBudgetUs;
+    int         rngSeed;                  /* negative: loading times are not reproducible */
+    int         warmUpDetection;          /* 1: MSER-5 warm-up truncation of the steady-state results */
+} LunarMiningConfig;
+
+/* Results of a run up to the current minute */
+typedef struct LunarMiningResult {
+    long   minute;                        /* simulated minutes so far */
+    long   runTime;                       /* minutes of a complete run */
+    long   numOfStations;
+    long   numOfTrucks;
+    long   deliveries;
+    long   totalWaitTime;
+    double meanWaitTime;
+    long   payload;                       /* tons delivered */
+    long   warmUpTime;
+    long   steadyDeliveries;
+    double steadyMeanWaitTime;
+} LunarMiningResult;
+
+typedef struct LunarMiningSimulation LunarMiningSimulation;
+
+int                lunar_mining_api_version   (void);
+void               lunar_mining_default_config(LunarMiningConfig *cfg);
+LunarMiningStatus  lunar_mining_create        (const LunarMiningConfig *cfg, LunarMiningSimulation **sim);
+long               lunar_mining_run           (LunarMiningSimulation *sim, long minutes);
+int                lunar_mining_done          (LunarMiningSimulation *sim);
+LunarMiningStatus  lunar_mining_result        (LunarMiningSimulation *sim, LunarMiningResult *res);
+void               lunar_mining_destroy       (LunarMiningSimulation *sim);
+
+#ifdef __cplusplus
+}
+
+namespace Lunar {
+
+    /**
+     * @brief RAII wrapper of the C API for C++ hosts
+     *
+     */
+    class MiningSimulation
+    {
+        public:
+            MiningSimulation() {}
+            MiningSimulation(const MiningSimulation &) = delete;
+            MiningSimulation &operator=(const MiningSimulation &) = delete;
+            ~MiningSimulation() { lunar_mining_destroy(mSim); }
+
+            LunarMiningStatus create(const LunarMiningConfig &cfg) {
+                lunar_mining_destroy(mSim);
+                mSim = nullptr;
+                return lunar_mining_create(&cfg, &mSim);
+            }
+
+            // minutes <= 0: run to completion
+            long run (long minutes = 0) { return lunar_mining_run(mSim, minutes); }
+            bool done() { return lunar_mining_done(mSim) != 0; }
+
+            LunarMiningResult result() {
+                LunarMiningResult res {};
+                lunar_mining_result(mSim, &res);
+                return res;
+            }
+
+        private:
+            LunarMiningSimulation *mSim {nullptr};
+    };
+}
+#endif
+
+#endif // LUNAR_MINING_API_H
@@ -1,5 +1,10 @@
 #include "mining_controller.h"
 #include "config.h"
+#include "sim_verifier.h"
+#include "sweep_runner.h"
+#include "capacity_optimizer.h"
+#include "simulation_daemon.h"
+#include "multi_site_runner.h"
 #include "service_include.h"
 
 static Lunar::MiningController mCtrl;
@@ -16,10 +21,21 @@ void signalHandler(int signalNumber) {
     exit(signalNumber);
 }
 
+/**
+ * @brief The daemon stops serving and removes its socket
+ *
+ * @param signalNumber
+ */
+void daemonSignalHandler(int signalNumber) {
+    (void) signalNumber;
+    Lunar::SimulationDaemon::requestStop();
+}
+
 
 int main(int argc, char *argv[])
 {
     std::signal(SIGINT,  signalHandler);
+    std::signal(SIGTERM, signalHandler);
 
     //Read config file
     Lunar::Config cfg;
@@ -28,6 +44,38 @@ int main(int argc, char *argv[])
         return  EXIT_FAILURE;
     }
 
+    //Verification mode, compare an engine against the golden trace or the reference engine
+    if(cfg.verifyMode() != static_cast<int>(Lunar::VerifyMode::OFF)) {
+        Lunar::SimulationVerifier verifier(&cfg);
+        return (verifier.run() == Lunar::ServiceStatus::SUCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    //Daemon mode, serve scenario requests on a Unix domain socket with a warm worker pool
+    if(cfg.daemonSocket().empty() == false) {
+        std::signal(SIGINT,  daemonSignalHandler);
+        std::signal(SIGTERM, daemonSignalHandler);
+        Lunar::SimulationDaemon daemon(&cfg);
+        return (daemon.run() == Lunar::ServiceStatus::SUCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    //Multi-site mode, the sites of MULTI_SITE_FILE exchange trucks and run in parallel
+    if(cfg.multiSiteFile().empty() == false) {
+        Lunar::MultiSiteRunner runner(&cfg);
+        return (runner.run() == Lunar::ServiceStatus::SUCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    //Goal-seek of the minimal stations and fleet for a target throughput
+    if(cfg.optimizeDeliveriesPerHour() > 0) {
+        Lunar::CapacityOptimizer optimizer(&cfg);
+        return (optimizer.run() == Lunar::ServiceStatus::SUCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    //Sweep mode, run every fleet-size x station-count configuration pruned by the analytic estimate
+    if(cfg.sweepTrucks().empty() == false || cfg.sweepStations().empty() == false) {
+        Lunar::SweepRunner sweep(&cfg);
+        return (sweep.run() == Lunar::ServiceStatus::SUCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     //Initialize the mining controller;
     mCtrl.set(&cfg);
     if(mCtrl.init() < 1) {
@@ -0,0 +1,69 @@
+#include "memory_account.h"
+
+#include <sys/resource.h>
+
+/**
+ * @brief Returns the bytes currently allocated by all subsystems
+ *
+ * @return size_t
+ */
+size_t
+Lunar::MemoryAccount::current() const
+{
+    size_t bytes {0};
+    for (const auto &res : mResources) {
+        bytes += res.current();
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Returns the sum of the peaks of the subsystems,
+ *          an upper bound of the peak of the simulation as the subsystems may peak at different minutes
+ *
+ * @return size_t
+ */
+size_t
+Lunar::MemoryAccount::peak() const
+{
+    size_t bytes {0};
+    for (const auto &res : mResources) {
+        bytes += res.peak();
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Current and peak KB of each subsystem, e.g. "Trucks:120/128KB, StationQueues:4/4KB, ..."
+ *
+ * @return std::string
+ */
+std::string
+Lunar::MemoryAccount::format() const
+{
+    auto toKb = [] (size_t bytes) { return (bytes + 1023) / 1024; };
+
+    std::stringstream ss;
+    for (size_t s {0}; s < mResources.size(); s++) {
+        ss << MemorySubsystemName.at(static_cast<MemorySubsystem>(s)) << ":"
+           << toKb(mResources[s].current()) << "/" << toKb(mResources[s].peak()) << "KB, ";
+    }
+    ss << "Total:" << toKb(current()) << "/" << toKb(peak()) << "KB";
+
+    return ss.str();
+}
+
+/**
+ * @brief Returns the peak resident set size of the process in KB
+ *
+ * @return long
+ */
+long
+Lunar::MemoryAccount::peakRssKb()
+{
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
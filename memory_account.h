@@ -0,0 +1,82 @@
+#ifndef MEMORY_ACCOUNT_H
+#define MEMORY_ACCOUNT_H
+
+#include "service_include.h"
+
+#include <array>
+
+namespace Lunar {
+
+    /**
+     * @brief Memory resource that counts the bytes it takes from its upstream resource,
+     *          the current and the peak bytes and the number of allocations.
+     *          It is used by one simulation (thread) at a time, the counters are not synchronized.
+     */
+    class TrackingResource : public std::pmr::memory_resource
+    {
+        public:
+            TrackingResource(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) :
+                mUpstream(upstream) {}
+
+            virtual ~TrackingResource() {}
+
+            size_t current    () const { return mCurrent;     }
+            size_t peak       () const { return mPeak;        }
+            size_t allocations() const { return mAllocations; }
+
+        protected:
+            void *do_allocate(size_t bytes, size_t alignment) override
+            {
+                auto *ptr = mUpstream->allocate(bytes, alignment);
+                mCurrent += bytes;
+                mPeak     = std::max(mPeak, mCurrent);
+                mAllocations++;
+                return ptr;
+            }
+
+            void do_deallocate(void *ptr, size_t bytes, size_t alignment) override
+            {
+                mUpstream->deallocate(ptr, bytes, alignment);
+                mCurrent -= bytes;
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+            {
+                return this == &other;
+            }
+
+        private:
+            std::pmr::memory_resource *mUpstream    {nullptr};
+            size_t                     mCurrent     {0};
+            size_t                     mPeak        {0};
+            size_t                     mAllocations {0};
+    };
+
+    /**
+     * @brief Memory of a simulation by subsystem, the containers of a subsystem allocate from its TrackingResource.
+     *          It has to outlive the containers, i.e. it is declared before them.
+     */
+    class MemoryAccount
+    {
+        public:
+            MemoryAccount() {}
+            MemoryAccount(const MemoryAccount &) = delete;
+            MemoryAccount &operator=(const MemoryAccount &) = delete;
+            virtual ~MemoryAccount() {}
+
+            std::pmr::memory_resource *resource(MemorySubsystem sub) { return &mResources[static_cast<size_t>(sub)]; }
+            const TrackingResource    &usage   (MemorySubsystem sub) const { return mResources[static_cast<size_t>(sub)]; }
+
+            size_t current() const;
+            size_t peak   () const;
+
+            std::string format() const;
+
+            static long peakRssKb();
+
+        private:
+            std::array<TrackingResource, static_cast<size_t>(MemorySubsystem::COUNT)> mResources {};
+    };
+}
+
+#endif // MEMORY_ACCOUNT_H
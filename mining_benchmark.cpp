@@ -0,0 +1,846 @@
+#include "mining_controller.h"
+#include "fixed_mining_engine.h"
+#include "coroutine_mining_engine.h"
+#include "worker_pool.h"
+#include "assignment_solver.h"
+#include "config.h"
+#include "service_include.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Count every heap allocation of the process, the benchmark reports allocations per tick.
+// All replaceable forms are replaced, the aligned and nothrow ones would bypass the counter otherwise
+static std::atomic<unsigned long> gAllocations {0};
+
+namespace {
+    void *countedAlloc(std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept
+    {
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+        size = size ? size : 1;
+        if(align <= alignof(std::max_align_t)) {
+            return std::malloc(size);
+        }
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    }
+
+    void *countedAllocOrThrow(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        if(void *ptr = countedAlloc(size, align)) {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    // out of line, so the compiler doesn't pair the free with an inlined operator new
+    [[gnu::noinline]] void countedFree(void *ptr) noexcept
+    {
+        std::free(ptr);
+    }
+}
+
+void *operator new  (std::size_t size)                                      { return countedAllocOrThrow(size); }
+void *operator new[](std::size_t size)                                      { return countedAllocOrThrow(size); }
+void *operator new  (std::size_t size, const std::nothrow_t &) noexcept     { return countedAlloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept     { return countedAlloc(size); }
+void *operator new  (std::size_t size, std::align_val_t al)                 { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al)                 { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void *operator new  (std::size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete  (void *ptr) noexcept                                  { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept                                  { countedFree(ptr); }
+void operator delete  (void *ptr, std::size_t) noexcept                     { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept                     { countedFree(ptr); }
+void operator delete  (void *ptr, const std::nothrow_t &) noexcept          { countedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept          { countedFree(ptr); }
+void operator delete  (void *ptr, std::align_val_t) noexcept                { countedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept                { countedFree(ptr); }
+void operator delete  (void *ptr, std::size_t, std::align_val_t) noexcept   { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept   { countedFree(ptr); }
+void operator delete  (void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { countedFree(ptr); }
+
+namespace {
+
+    using BenchClock = std::chrono::steady_clock;
+
+    struct BenchParams {
+        std::vector<long> trucks    {10, 100, 1000};   // small default grid, larger sizes via --trucks/--stations
+        std::vector<long> stations  {1, 10};
+        long              warmup    {120};     // simulated minutes before measuring
+        long              ticks     {240};     // simulated minutes to measure
+        long              budgetMs  {5000};    // wall-clock budget per case (warm-up + measure)
+        std::string       bench     {"all"};   // phases|end_to_end|all|scaling
+        bool              checkAllocs{false};  // fail if a measured tick allocates
+        bool              checkSolver{false};  // check the batch-assignment solver instead of benchmarking
+        std::vector<long> workers   {};        // scaling: worker counts, default 1, 2, 4, ... all CPUs
+        long              runsPerWorker{4};    // scaling: independent runs per worker
+        Lunar::PinningPolicy pinning {Lunar::PinningPolicy::COMPACT};
+    };
+
+    struct PhaseStats {
+        long          ns        {0};
+        unsigned long allocs    {0};
+    };
+
+    struct BenchResult {
+        std::string name        {};
+        long        trucks      {0};
+        long        stations    {0};
+        long        ticks       {0};
+        long        decisions   {0};
+        long        peakRss     {0};       // of the case, each case runs in its own process
+        PhaseStats  stats       {};
+        long        workers     {0};       // scaling
+        long        runs        {0};       // scaling
+        double      runsPerSec  {0.0};     // scaling
+        double      speedup     {0.0};     // scaling, against the first worker count
+    };
+
+    /**
+     * @brief Returns the peak resident set size of the process in KB
+     *
+     * @return long
+     */
+    long peakRssKb()
+    {
+        struct rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    /**
+     * @brief Result of a case, the measured values start at zero
+     *
+     * @param name
+     * @param trucks
+     * @param stations
+     * @return BenchResult
+     */
+    BenchResult newResult(const std::string &name, long trucks, long stations)
+    {
+        BenchResult res;
+        res.name     = name;
+        res.trucks   = trucks;
+        res.stations = stations;
+        return res;
+    }
+
+    /**
+     * @brief Run a case in a child process, so the peak RSS is the one of the case and not the largest of the cases before it.
+     *          The child passes its results back through a pipe, one line per result.
+     *
+     * @param fn fills the results of the case
+     * @param results
+     * @return false if the case crashed
+     */
+    template <typename Fn>
+    bool runIsolated(Fn &&fn, std::vector<BenchResult> &results)
+    {
+        int fds[2];
+        if(pipe(fds) != 0) {
+            std::cerr << "[BENCH-ERROR], Unable to create a pipe: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        auto pid = fork();
+        if(pid < 0) {
+            std::cerr << "[BENCH-ERROR], Unable to fork: " << std::strerror(errno) << std::endl;
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+
+        if(pid == 0) {
+            close(fds[0]);
+            std::vector<BenchResult> own;
+            fn(own);
+
+            std::stringstream ss;
+            ss << std::setprecision(17);
+            for (auto &res : own) {
+                ss << res.name << " " << res.trucks << " " << res.stations << " " << res.ticks << " " << res.decisions
+                   << " " << peakRssKb() << " " << res.stats.ns << " " << res.stats.allocs << " " << res.workers
+                   << " " << res.runs << " " << res.runsPerSec << " " << res.speedup << "\n";
+            }
+            auto out = ss.str();
+            for (size_t done {0}; done < out.size(); ) {
+                auto n = write(fds[1], out.data() + done, out.size() - done);
+                if(n <= 0) {
+                    _exit(EXIT_FAILURE);
+                }
+                done += n;
+            }
+            _exit(EXIT_SUCCESS);
+        }
+
+        close(fds[1]);
+        std::string out;
+        char buf[4096];
+        for (ssize_t n; (n = read(fds[0], buf, sizeof(buf))) != 0; ) {
+            if(n > 0) {
+                out.append(buf, n);
+            }
+            else if(errno != EINTR) {
+                break;
+            }
+        }
+        close(fds[0]);
+
+        int status {0};
+        waitpid(pid, &status, 0);
+        if(WIFEXITED(status) == false || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            std::cerr << "[BENCH-ERROR], The case failed, status:" << status << std::endl;
+            return false;
+        }
+
+        std::stringstream ss(out);
+        BenchResult res;
+        while (ss >> res.name >> res.trucks >> res.stations >> res.ticks >> res.decisions >> res.peakRss >> res.stats.ns
+                  >> res.stats.allocs >> res.workers >> res.runs >> res.runsPerSec >> res.speedup) {
+            results.push_back(res);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Parse a comma separated list of numbers
+     *
+     * @param str
+     * @return std::vector<long>
+     */
+    std::vector<long> parseList(const std::string &str)
+    {
+        std::vector<long> lst;
+        std::string token;
+        std::stringstream ss(str);
+        while (std::getline(ss, token, ',')) {
+            lst.push_back(std::stol(token));
+        }
+        return lst;
+    }
+
+    /**
+     * @brief Parse the command line, e.g. --trucks=10,100 --stations=1,10 --ticks=240
+     *
+     * @param argc
+     * @param argv
+     * @param params
+     * @return true
+     * @return false
+     */
+    bool parseArgs(int argc, char *argv[], BenchParams &params)
+    {
+        for (int i {1}; i < argc; i++) {
+            std::string arg {argv[i]};
+            auto pos = arg.find(Lunar::CONFIG_DELIMITER);
+            if(arg.rfind("--", 0) != 0 || pos == std::string::npos) {
+                std::cerr << "[BENCH-ERROR], Invalid argument:" << arg << std::endl;
+                return false;
+            }
+
+            auto key = arg.substr(2, pos - 2);
+            auto val = arg.substr(pos + 1);
+            try {
+                if(key == "trucks")         { params.trucks   = parseList(val); }
+                else if(key == "stations")  { params.stations = parseList(val); }
+                else if(key == "warmup")    { params.warmup   = std::stol(val); }
+                else if(key == "ticks")     { params.ticks    = std::stol(val); }
+                else if(key == "budget-ms") { params.budgetMs = std::stol(val); }
+                else if(key == "bench")     { params.bench    = val; }
+                else if(key == "check-allocs") { params.checkAllocs = (std::stol(val) != 0); }
+                else if(key == "check-solver") { params.checkSolver = (std::stol(val) != 0); }
+                else if(key == "workers")   { params.workers  = parseList(val); }
+                else if(key == "runs-per-worker") { params.runsPerWorker = std::max(1L, std::stol(val)); }
+                else if(key == "pinning")   { params.pinning  = static_cast<Lunar::PinningPolicy>(std::clamp(std::stol(val), 0L, 2L)); }
+                else {
+                    std::cerr << "[BENCH-ERROR], Unknown argument:" << key << std::endl;
+                    return false;
+                }
+            }
+            catch (const std::exception &e) {
+                std::cerr << "[BENCH-ERROR], Invalid value for " << key << ": " << e.what() << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Time a callable and count the allocations it does
+     *
+     * @param stats
+     * @param fn
+     */
+    template <typename Fn>
+    void measure(PhaseStats &stats, Fn &&fn)
+    {
+        auto allocs = gAllocations.load(std::memory_order_relaxed);
+        auto begin  = BenchClock::now();
+        fn();
+        stats.ns     += std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - begin).count();
+        stats.allocs += gAllocations.load(std::memory_order_relaxed) - allocs;
+    }
+
+    /**
+     * @brief Drive trucks, unload-stations and the scheduler the same way the MiningController does,
+     *          but time Truck::tick, UnloadStation::tick and UnloadStationScheduler::tick separately
+     *
+     * @param params
+     * @param numOfTrks
+     * @param numOfStats
+     * @param results
+     */
+    void benchPhases(const BenchParams &params, long numOfTrks, long numOfStats, std::vector<BenchResult> &results)
+    {
+        std::pmr::unsynchronized_pool_resource queuePool;
+        std::pmr::unsynchronized_pool_resource logPool;
+        Lunar::SlotMap<Lunar::Truck> trucks;
+        Lunar::SlotMap<Lunar::UnloadStation> stations;
+        Lunar::UnloadStationScheduler scheduler;
+
+        auto maxDeliveries = (params.warmup + params.ticks) / (Lunar::hourToMinutes(Lunar::LOADING_TIME_MIN_HOURS)) + 1;
+        stations.reserve(numOfStats);
+        trucks.reserve(numOfTrks);
+        for (long s {0}; s < numOfStats; s++) {
+            auto stat = stations.get(stations.emplace("UnloadStation_" + std::to_string(s + 1), &queuePool));
+            stat->setIndex(s);
+        }
+        for (long t {0}; t < numOfTrks; t++) {
+            auto trk = trucks.get(trucks.emplace("Truck_" + std::to_string(t + 1), &logPool));
+            trk->setIndex(t);
+            trk->reserve(("UnloadStation_" + std::to_string(numOfStats)).size());
+        }
+        Lunar::UnloadStation::reserveQueueNodes(&queuePool, numOfTrks);
+        Lunar::Truck::reserveLogEntries(&logPool, numOfTrks * maxDeliveries);
+        scheduler.setTrucks(&trucks);
+        scheduler.setUnloadStations(&stations);
+
+        auto trkRes  = newResult("truck_tick",     numOfTrks, numOfStats);
+        auto statRes = newResult("station_tick",   numOfTrks, numOfStats);
+        auto schdRes = newResult("scheduler_tick", numOfTrks, numOfStats);
+
+        // the budget limits the measured ticks, the warm-up always runs to the end
+        auto deadline = BenchClock::time_point::max();
+        for (long minute {0}; minute < params.warmup + params.ticks && BenchClock::now() < deadline; minute++) {
+            bool warm = minute >= params.warmup;
+            if(minute == params.warmup) {
+                deadline = BenchClock::now() + std::chrono::milliseconds(params.budgetMs);
+            }
+            PhaseStats trkStats, statStats, schdStats;
+
+            measure(trkStats,  [&trucks] { for (auto &trk : trucks) { trk.tick(); } });
+            measure(statStats, [&stations] { for (auto &stat : stations) { stat.tick(); } });
+
+            long waiting {0};
+            for (auto &trk : trucks) {
+                waiting += trk.isWaitingForUnloadStation() ? 1 : 0;
+            }
+
+            measure(schdStats, [&scheduler] { scheduler.tick(); });
+
+            long stillWaiting {0};
+            for (auto &trk : trucks) {
+                stillWaiting += trk.isWaitingForUnloadStation() ? 1 : 0;
+            }
+
+            if(warm) {
+                for (auto [res, st] : {std::pair{&trkRes, &trkStats}, {&statRes, &statStats}, {&schdRes, &schdStats}}) {
+                    res->ticks++;
+                    res->stats.ns     += st->ns;
+                    res->stats.allocs += st->allocs;
+                }
+                schdRes.decisions += waiting - stillWaiting;
+            }
+        }
+
+        results.push_back(trkRes);
+        results.push_back(statRes);
+        results.push_back(schdRes);
+    }
+
+    /**
+     * @brief Run an engine end-to-end, the MiningController unpaced and without reports,
+     *          the fixed engine only if the layout has one
+     *
+     * @param params
+     * @param numOfTrks
+     * @param numOfStats
+     * @param type
+     * @param results
+     */
+    void benchEndToEnd(const BenchParams &params, long numOfTrks, long numOfStats, Lunar::EngineType type,
+                       std::vector<BenchResult> &results)
+    {
+        Lunar::Config cfg;
+        cfg.set(Lunar::ServiceParams::TRUCK,          numOfTrks);
+        cfg.set(Lunar::ServiceParams::UNLOAD_STATION, numOfStats);
+        // Seeded so the engines are timed rather than a std::random_device per loading time
+        cfg.set(Lunar::ServiceParams::RNG_SEED,       Lunar::DEFAULT_RNG_SEED);
+
+        std::unique_ptr<Lunar::SimulationEngine> engine;
+        std::string name {"end_to_end"};
+        switch (type)
+        {
+            case Lunar::EngineType::FIXED:
+                engine = Lunar::createFixedEngine(&cfg);
+                if(engine == nullptr) {
+                    return;
+                }
+                name += "_fixed";
+                break;
+
+            case Lunar::EngineType::COROUTINE:
+                engine = std::make_unique<Lunar::CoroutineMiningEngine>(&cfg);
+                name += "_coroutine";
+                break;
+
+            default: {
+                auto ctrl = std::make_unique<Lunar::MiningController>(&cfg);
+                ctrl->setPaced(false);
+                ctrl->setReporting(false);
+                engine = std::move(ctrl);
+            }
+            break;
+        }
+
+        if(engine->init() != Lunar::ServiceStatus::SUCESS) {
+            std::cerr << "[BENCH-ERROR], " << name << " init failed" << std::endl;
+            return;
+        }
+        engine->startServices();
+
+        auto res      = newResult(name, numOfTrks, numOfStats);
+        auto deadline = BenchClock::time_point::max();
+        for (long minute {0}; minute < params.warmup + params.ticks && BenchClock::now() < deadline; minute++) {
+            if(minute == params.warmup) {
+                deadline = BenchClock::now() + std::chrono::milliseconds(params.budgetMs);
+            }
+
+            PhaseStats stats;
+            measure(stats, [&engine] { engine->step(); });
+            if(minute >= params.warmup) {
+                res.ticks++;
+                res.stats.ns     += stats.ns;
+                res.stats.allocs += stats.allocs;
+            }
+        }
+
+        results.push_back(res);
+    }
+
+    /**
+     * @brief Worker counts of the scaling benchmark, default 1, 2, 4, ... up to all CPUs
+     *
+     * @param params
+     * @return std::vector<long>
+     */
+    std::vector<long> scalingWorkers(const BenchParams &params)
+    {
+        auto workers = params.workers;
+        if(workers.empty()) {
+            long numOfCpus = std::max(1, Lunar::CpuTopology().numOfCpus());
+            for (long w {1}; w < numOfCpus; w *= 2) {
+                workers.push_back(w);
+            }
+            workers.push_back(numOfCpus);
+        }
+        return workers;
+    }
+
+    /**
+     * @brief Throughput of independent end-to-end runs on a pinned WorkerPool of numOfWorkers,
+     *          it runs runsPerWorker runs per worker, so the ideal curve over the worker counts is a constant wall time.
+     *          The runs are created on their workers like the runs of sweeps and the capacity optimizer
+     *
+     * @param params
+     * @param numOfTrks
+     * @param numOfStats
+     * @param numOfWorkers
+     * @param results
+     */
+    void benchScaling(const BenchParams &params, long numOfTrks, long numOfStats, long numOfWorkers,
+                      std::vector<BenchResult> &results)
+    {
+        Lunar::WorkerPool pool(static_cast<int>(numOfWorkers), params.pinning);
+        auto numOfRuns = numOfWorkers * params.runsPerWorker;
+        auto minutes   = params.warmup + params.ticks;
+
+        std::atomic<long> failed {0};
+        auto begin = BenchClock::now();
+        for (long r {0}; r < numOfRuns; r++) {
+            pool.submit([numOfTrks, numOfStats, minutes, r, &failed] () {
+                Lunar::Config cfg;
+                cfg.set(Lunar::ServiceParams::TRUCK,          numOfTrks);
+                cfg.set(Lunar::ServiceParams::UNLOAD_STATION, numOfStats);
+                cfg.set(Lunar::ServiceParams::RNG_SEED,       static_cast<int>(r) + 1);
+
+                Lunar::MiningController ctrl(&cfg);
+                ctrl.setPaced(false);
+                ctrl.setReporting(false);
+                if(ctrl.init() != Lunar::ServiceStatus::SUCESS) {
+                    failed++;
+                    return;
+                }
+                ctrl.startServices();
+                for (long m {0}; m < minutes; m++) {
+                    ctrl.step();
+                }
+            });
+        }
+        pool.wait();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - begin).count();
+
+        if(failed > 0) {
+            std::cerr << "[BENCH-ERROR], scaling init failed" << std::endl;
+            return;
+        }
+
+        auto res       = newResult("scaling", numOfTrks, numOfStats);
+        res.workers    = numOfWorkers;
+        res.runs       = numOfRuns;
+        res.ticks      = numOfRuns * minutes;
+        res.stats.ns   = ns;
+        res.runsPerSec = numOfRuns * 1e9 / std::max(ns, 1L);
+        results.push_back(res);
+    }
+
+    /**
+     * @brief Speedup of the scaling results of a case against the per-worker throughput of its first worker count
+     *
+     * @param results
+     * @param first the first scaling result of the case
+     */
+    void scalingSpeedup(std::vector<BenchResult> &results, size_t first)
+    {
+        if(first >= results.size()) {
+            return;
+        }
+
+        auto base = results[first].runsPerSec / std::max(results[first].workers, 1L);
+        for (auto i {first}; i < results.size(); i++) {
+            auto &res   = results[i];
+            res.speedup = (base > 0.0) ? res.runsPerSec / base : 0.0;
+            std::cerr << "[BENCH-INFO], Workers:" << res.workers << ", RunsPerSec:" << std::fixed << std::setprecision(1)
+                      << res.runsPerSec << ", Speedup:" << std::setprecision(2) << res.speedup << std::endl;
+        }
+        std::cerr.unsetf(std::ios::fixed);
+    }
+
+    /**
+     * @brief Print the results as JSON on the standard out
+     *
+     * @param params
+     * @param results
+     */
+    void printJson(const BenchParams &params, const std::vector<BenchResult> &results)
+    {
+        std::cout << "{\n  \"warmup\": " << params.warmup << ",\n  \"ticks\": " << params.ticks
+                  << ",\n  \"budget_ms\": " << params.budgetMs << ",\n  \"results\": [\n";
+
+        for (size_t i {0}; i < results.size(); i++) {
+            auto &res = results[i];
+            std::cout << "    {\"bench\": \""        << res.name        << "\""
+                      << ", \"trucks\": "            << res.trucks
+                      << ", \"stations\": "          << res.stations
+                      << ", \"ticks\": "             << res.ticks;
+
+            // the budget ran out before the first measured tick, there is no number to report
+            // the scaling runs include their init, their allocations are not measured
+            if(res.ticks > 0 && res.name == "scaling") {
+                std::cout << ", \"status\": \"ok\""
+                          << ", \"ns_per_tick\": "     << res.stats.ns / res.ticks
+                          << ", \"allocs_per_tick\": null";
+            }
+            else if(res.ticks > 0) {
+                std::cout << ", \"status\": \"ok\""
+                          << ", \"ns_per_tick\": "     << res.stats.ns / res.ticks
+                          << ", \"allocs_per_tick\": " << static_cast<double>(res.stats.allocs) / res.ticks;
+            }
+            else {
+                std::cout << ", \"status\": \"skipped\", \"ns_per_tick\": null, \"allocs_per_tick\": null";
+            }
+            std::cout << ", \"peak_rss_kb\": " << res.peakRss;
+
+            if(res.name == "scaling") {
+                std::cout << ", \"workers\": "      << res.workers
+                          << ", \"runs\": "         << res.runs
+                          << ", \"runs_per_sec\": " << res.runsPerSec
+                          << ", \"speedup\": "      << res.speedup
+                          << ", \"efficiency\": "   << res.speedup / std::max(res.workers, 1L);
+            }
+            if(res.name == "scheduler_tick") {
+                std::cout << ", \"decisions\": " << res.decisions << ", \"ns_per_decision\": ";
+                if(res.decisions > 0) {
+                    std::cout << res.stats.ns / res.decisions;
+                }
+                else {
+                    std::cout << "null";
+                }
+            }
+
+            std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        std::cout << "  ]\n}" << std::endl;
+    }
+}
+
+namespace {
+
+    /**
+     * @brief Minimal total cost of the assignment of rows to distinct columns by exhaustive search
+     *
+     * @param cost
+     * @param rows
+     * @param cols
+     * @return long
+     */
+    long bruteForceCost(const std::vector<long> &cost, int rows, int cols)
+    {
+        std::vector<char> used(cols, 0);
+        long best {std::numeric_limits<long>::max()};
+        auto search = [&] (auto &self, int r, long sum) -> void {
+            if(r == rows) {
+                best = std::min(best, sum);
+                return;
+            }
+            for (int c {0}; c < cols; c++) {
+                if(used[c] == 0) {
+                    used[c] = 1;
+                    self(self, r + 1, sum + cost[r * cols + c]);
+                    used[c] = 0;
+                }
+            }
+        };
+        search(search, 0, 0);
+        return best;
+    }
+
+    /**
+     * @brief Check that the solution of the solver is an assignment of distinct columns with the optimal cost
+     *
+     * @param solver
+     * @param cost
+     * @param rows
+     * @param cols
+     * @return true
+     * @return false
+     */
+    bool isOptimal(Lunar::AssignmentSolver &solver, const std::vector<long> &cost, int rows, int cols)
+    {
+        std::vector<char> used(cols, 0);
+        long sum {0};
+        for (int r {0}; r < rows; r++) {
+            auto c = solver.assignment()[r];
+            if(c < 0 || c >= cols || used[c]) {
+                return false;
+            }
+            used[c] = 1;
+            sum += cost[r * cols + c];
+        }
+        return sum == solver.totalCost() && sum == bruteForceCost(cost, rows, cols);
+    }
+
+    /**
+     * @brief Check the batch-assignment solver (--check-solver=1)
+     *          |-random matrices with many ties against exhaustive search
+     *          |-batch costs as the scheduler builds them (slot waits, drive times, scale and tie-break):
+     *            optimal, the scaled-down cost is the optimum of the unscaled costs and
+     *            without drive times the longest-waiting trucks get the earlier slots
+     *          |-an exceeded budget makes the solver give up and the scheduler fall back to greedy
+     *
+     * @return true if all checks passed
+     */
+    bool checkSolver()
+    {
+        Lunar::AssignmentSolver solver;
+        std::mt19937 rng(1);
+        auto uniform = [&rng] (int min, int max) { return std::uniform_int_distribution<int>(min, max)(rng); };
+        auto budget  = std::chrono::microseconds(std::chrono::seconds(10));
+        long failures {0};
+
+        for (int trial {0}; trial < 2000; trial++) {
+            int rows = uniform(1, 6);
+            int cols = uniform(rows, 8);
+            std::vector<long> cost(rows * cols);
+            std::ranges::generate(cost, [&] () { return uniform(0, 20); });
+
+            if(solver.solve(cost, rows, cols, budget) != Lunar::ServiceStatus::SUCESS || isOptimal(solver, cost, rows, cols) == false) {
+                failures++;
+                std::cerr << "[BENCH-ERROR], Solver not optimal, random trial:" << trial << std::endl;
+            }
+        }
+
+        for (int trial {0}; trial < 500; trial++) {
+            int rows       = uniform(2, 4);
+            int numOfStats = uniform(1, 2);
+            int cols       = rows * numOfStats;
+            bool withDrive = (trial % 2) == 0;
+            long scale     = static_cast<long>(rows - 1) * rows * (rows + 1) / 2 + 1;
+
+            std::vector<long> plain(rows * cols), cost(rows * cols);
+            for (int s {0}; s < numOfStats; s++) {
+                long queue  = uniform(0, 10);
+                long unload = uniform(1, 8);
+                for (int r {0}; r < rows; r++) {
+                    long drive = withDrive ? uniform(0, 30) : 0;
+                    for (int j {0}; j < rows; j++) {
+                        plain[r * cols + s * rows + j] = std::max(queue + j * unload, drive);
+                        cost [r * cols + s * rows + j] = plain[r * cols + s * rows + j] * scale + static_cast<long>(j) * (rows - r);
+                    }
+                }
+            }
+
+            if(solver.solve(cost, rows, cols, budget) != Lunar::ServiceStatus::SUCESS || isOptimal(solver, cost, rows, cols) == false ||
+               solver.totalCost() / scale != bruteForceCost(plain, rows, cols)) {
+                failures++;
+                std::cerr << "[BENCH-ERROR], Solver not optimal, batch trial:" << trial << std::endl;
+                continue;
+            }
+
+            // with one station and no drive times truck r (r-th longest waiting) has to get slot r
+            if(numOfStats == 1 && withDrive == false) {
+                for (int r {0}; r < rows; r++) {
+                    if(solver.assignment()[r] != r) {
+                        failures++;
+                        std::cerr << "[BENCH-ERROR], Tie-break does not give the earlier slots to the longest-waiting trucks, batch trial:"
+                                  << trial << std::endl;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // a budget that is exceeded before the first row is done
+        std::vector<long> cost(9, 1);
+        if(solver.solve(cost, 3, 3, std::chrono::microseconds(-1)) == Lunar::ServiceStatus::SUCESS) {
+            failures++;
+            std::cerr << "[BENCH-ERROR], Solver ignored an exceeded budget" << std::endl;
+        }
+
+        // the scheduler hands the batch to the greedy assignment
+        std::pmr::unsynchronized_pool_resource queuePool;
+        Lunar::SlotMap<Lunar::Truck> trucks;
+        Lunar::SlotMap<Lunar::UnloadStation> stations;
+        Lunar::UnloadStationScheduler scheduler;
+        for (int s {0}; s < 2; s++) {
+            stations.get(stations.emplace("UnloadStation_" + std::to_string(s + 1), &queuePool))->setIndex(s);
+        }
+        for (int t {0}; t < 4; t++) {
+            auto trk = trucks.get(trucks.emplace("Truck_" + std::to_string(t + 1)));
+            trk->setIndex(t);
+            trk->setState(Lunar::TruckState::WAITING_FOR_UNLOAD_STATION);
+        }
+        scheduler.setTrucks(&trucks);
+        scheduler.setUnloadStations(&stations);
+        scheduler.setSchedulingPolicy(Lunar::SchedulingPolicy::BATCH_ASSIGNMENT, std::chrono::microseconds(-1));
+        scheduler.tick();
+        if(scheduler.batchFallbacks() != 1 || std::ranges::any_of(trucks, [] (Lunar::Truck &trk) { return trk.hasUnloadingStation() == false; })) {
+            failures++;
+            std::cerr << "[BENCH-ERROR], Scheduler did not fall back to greedy, Fallbacks:" << scheduler.batchFallbacks() << std::endl;
+        }
+
+        if(failures == 0) {
+            std::cerr << "[BENCH-INFO], Batch-assignment solver checks passed" << std::endl;
+        }
+        return failures == 0;
+    }
+}
+
+/**
+ * @brief Scheduler scalability benchmark
+ *          It reports ns per tick, ns per scheduling decision, allocations per tick and peak RSS
+ *          for every fleet-size x station-count combination as JSON
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char *argv[])
+{
+    BenchParams params;
+    if(parseArgs(argc, argv, params) == false) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--trucks=10,100,...] [--stations=1,10,...] [--warmup=N] [--ticks=N]"
+                  << " [--budget-ms=N] [--bench=phases|end_to_end|all|scaling] [--check-allocs=1] [--check-solver=1]"
+                  << " [--workers=1,2,...] [--runs-per-worker=N] [--pinning=0|1|2]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(params.checkSolver) {
+        return checkSolver() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // each case runs in its own process, its peak RSS doesn't carry the cases before it
+    std::vector<BenchResult> results;
+    long failedCases {0};
+    auto isolated = [&results, &failedCases] (auto &&fn) {
+        if(runIsolated(fn, results) == false) {
+            failedCases++;
+        }
+    };
+
+    for (auto numOfTrks : params.trucks) {
+        for (auto numOfStats : params.stations) {
+            if(numOfStats > numOfTrks) {
+                continue;
+            }
+
+            std::cerr << "[BENCH-INFO], Trucks:" << numOfTrks << ", UnloadStations:" << numOfStats << std::endl;
+            if(params.bench == "phases" || params.bench == "all") {
+                isolated([&] (std::vector<BenchResult> &res) { benchPhases(params, numOfTrks, numOfStats, res); });
+            }
+            if(params.bench == "end_to_end" || params.bench == "all") {
+                for (auto type : {Lunar::EngineType::REFERENCE, Lunar::EngineType::FIXED, Lunar::EngineType::COROUTINE}) {
+                    isolated([&] (std::vector<BenchResult> &res) { benchEndToEnd(params, numOfTrks, numOfStats, type, res); });
+                }
+            }
+            if(params.bench == "scaling") {
+                auto first = results.size();
+                for (auto numOfWorkers : scalingWorkers(params)) {
+                    isolated([&] (std::vector<BenchResult> &res) {
+                        benchScaling(params, numOfTrks, numOfStats, numOfWorkers, res);
+                    });
+                }
+                scalingSpeedup(results, first);
+            }
+        }
+    }
+
+    printJson(params, results);
+
+    bool failed {failedCases > 0};
+
+    // allocation check, the simulation core must not allocate once it is warmed up,
+    // a case without measured ticks proves nothing and fails the check
+    if(params.checkAllocs) {
+        for (auto &res : results) {
+            if(res.name == "scaling") {
+                continue;
+            }
+            else if(res.ticks == 0) {
+                failed = true;
+                std::cerr << "[BENCH-ERROR], " << res.name << ", Trucks:" << res.trucks << ", UnloadStations:" << res.stations
+                          << ", No tick measured within the budget" << std::endl;
+            }
+            else if(res.stats.allocs > 0) {
+                failed = true;
+                std::cerr << "[BENCH-ERROR], " << res.name << ", Trucks:" << res.trucks << ", UnloadStations:" << res.stations
+                          << ", Allocations in steady state:" << res.stats.allocs << std::endl;
+            }
+        }
+        if(failed == false) {
+            std::cerr << "[BENCH-INFO], No allocations in steady state" << std::endl;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -19,6 +19,10 @@ Lunar::MiningController::releaseResources() {
     // stop thread by setting RUN_SERVICE to false
     RUN_SERVICE = false;
 
+    mTraceWriter.close();
+    mLiveSnapshot.close();
+    mTimeline.close();
+
     releaseTrucks();
     releaseUnloadStations();
 
@@ -39,6 +43,13 @@ Lunar::MiningController::init()
 {
     initServiceParams();
 
+    // truck classes and site x station drive times
+    auto sitePath = mCfg->siteFile();
+    if(sitePath.empty() == false && mSite.load(sitePath) != ServiceStatus::SUCESS) {
+        mServiceErrors++;
+        return ServiceStatus::ERROR;
+    }
+
     int numOfUnloadStations = initUnloadStationService();
     if(numOfUnloadStations < 1) {
         mServiceErrors++;
@@ -46,12 +57,52 @@ Lunar::MiningController::init()
     }
 
     int numOfTrks = initTruckService();
-    if(numOfUnloadStations < 1) {
+    if(numOfTrks < 1) {
         mServiceErrors++;
         return ServiceStatus::ERROR;
     }
 
-    generateServiceStartUpInfo();
+    // every truck can be in one station queue at most,
+    // warm up the pool so the queues don't allocate while the simulation runs
+    UnloadStation::reserveQueueNodes(&mQueuePool, numOfTrks);
+
+    // the delivery logs of the fleet share the pool, it is warmed up for the expected deliveries,
+    // a fleet that delivers more grows it
+    Truck::reserveLogEntries(&mLogPool, numOfTrks * mExpectedDeliveries);
+
+    // scripted fleet changes, e.g. shift changes, breakdowns and staged deployments
+    auto eventPath = mCfg->fleetEventFile();
+    if(eventPath.empty() == false && loadFleetEvents(eventPath) < 0) {
+        mServiceErrors++;
+    }
+
+    // stream truck and station timelines as Chrome trace-events, only by the reporting run,
+    // the runs of sweeps, the optimizer, the daemon and the multi-site mode would all write the same file
+    auto tracePath = mCfg->traceEventFile();
+    if(mReporting && tracePath.empty() == false && mTraceWriter.open(tracePath) == false) {
+        mServiceErrors++;
+    }
+
+    // live state for monitor processes, only by the reporting run,
+    // the runs of sweeps, the optimizer, the daemon and the multi-site mode would share the region
+    auto shmName = mCfg->liveSnapshotShm();
+    if(mReporting && shmName.empty() == false &&
+       mLiveSnapshot.open(shmName, 2 * numOfTrks + LIVE_SNAPSHOT_SPARE_ENTITIES,
+                                   2 * numOfUnloadStations + LIVE_SNAPSHOT_SPARE_ENTITIES) == false) {
+        mServiceErrors++;
+    }
+
+    // level-of-detail timeline, only by the reporting run like the live snapshot,
+    // the last step of the run ends at minute runTime + 1
+    auto timelinePath = mCfg->timelinePyramidFile();
+    if(mReporting && timelinePath.empty() == false &&
+       mTimeline.open(timelinePath, mRunTime + 1, std::max(1, mCfg->timelineBucketMinutes())) == false) {
+        mServiceErrors++;
+    }
+
+    if(mReporting) {
+        generateServiceStartUpInfo();
+    }
 
     return ServiceStatus::SUCESS;
 }
@@ -90,9 +141,7 @@ Lunar::MiningController::stop()
 void
 Lunar::MiningController::runSimulation()
 {
-    startTrucks();
-    startUnloadStation();
-    startUnloadStationScheduler();
+    startServices();
 
     RUN_SERVICE = true;
     std::thread t1(&MiningController::startEventEngine, this);
@@ -106,22 +155,621 @@ Lunar::MiningController::runSimulation()
  */
 void Lunar::MiningController::startEventEngine()
 {
-    while(RUN_SERVICE && PROCESS_CLOCK <= Lunar::hourToMinutes(Lunar::SIMULATION_TIME_HOURS)) {
-        PROCESS_CLOCK++;
-        tick();
-        std::this_thread::yield();
-        std::this_thread::sleep_for(PROCESSING_TICK);
+    while(RUN_SERVICE && PROCESS_CLOCK <= static_cast<unsigned long>(mRunTime)) {
+        step();
+
+        if(mPaced) {
+            std::this_thread::yield();
+            std::this_thread::sleep_for(PROCESSING_TICK);
+        }
 
         // For detail process monitoring
-        generateReport();
+        if(mReporting) {
+            LUNAR_PROFILE_SCOPE(mProfiler, ProfilePhase::REPORT);
+            if(mTickReports) {
+                generateReport();
+            }
+            if(mMemoryReportMinutes > 0 && PROCESS_CLOCK % mMemoryReportMinutes == 0) {
+                generateMemoryReport();
+            }
+        }
     }
 
-    generateSummary();
+    if(mReporting) {
+        generateSummary();
+        generateProfileSummary();
+    }
+
+    mTraceWriter.close();
+    mLiveSnapshot.finish((PROCESS_CLOCK > static_cast<unsigned long>(mRunTime)) ? LiveRunState::FINISHED : LiveRunState::ABORTED);
+    mLiveSnapshot.close();
+    if(mTimeline.close() == false) {
+        mServiceErrors++;
+    }
 
     releaseUnloadStations();
     releaseTrucks();
 }
 
+/**
+ * @brief It starts trucks, unload-stations and the scheduler
+ *          without starting the service clock, so the caller can drive it with step()
+ *
+ */
+void
+Lunar::MiningController::startServices()
+{
+    startTrucks();
+    startUnloadStation();
+    startUnloadStationScheduler();
+    mServicesStarted = true;
+}
+
+/**
+ * @brief Advance the simulation by one minute
+ *
+ */
+void
+Lunar::MiningController::step()
+{
+    PROCESS_CLOCK++;
+    applyFleetEvents();
+    tick();
+
+    // retired trucks and closed stations leave once they are done with their current task
+    if(mRetiringTrucks.empty() == false) {
+        releaseRetiredTrucks();
+    }
+    if(mClosingStations.empty() == false) {
+        releaseDrainedStations();
+    }
+
+    if(mTraceWriter.isOpen()) {
+        generateTraceEvents();
+    }
+    if(mLiveSnapshot.isOpen()) {
+        publishLiveSnapshot();
+    }
+    if(mTimeline.isOpen()) {
+        generateTimelineSample();
+    }
+}
+
+/**
+ * @brief Returns the simulated minute of the service clock
+ *
+ * @return unsigned long
+ */
+unsigned long
+Lunar::MiningController::clock()
+{
+    return PROCESS_CLOCK;
+}
+
+/**
+ * @brief Returns the simulation run time in minutes
+ *
+ * @return long
+ */
+long
+Lunar::MiningController::runTime()
+{
+    return mRunTime;
+}
+
+/**
+ * @brief It fills the per-minute snapshot of trucks and unload-stations ordered by their index
+ *
+ * @param snap
+ */
+void
+Lunar::MiningController::snapshot(EngineSnapshot &snap)
+{
+    snap.minute     = PROCESS_CLOCK;
+    snap.deliveries = 0;
+    snap.truckStates.assign(mTruckHandles.size(), TruckState::IDEL);
+    snap.stationQueues.assign(mStationHandles.size(), 0);
+
+    for (auto &trk : mTrucks) {
+        snap.truckStates[trk.index()] = trk.state();
+        snap.deliveries += trk.numOfDeliveries();
+    }
+
+    for (auto &stat : mUnloadStations) {
+        snap.stationQueues[stat.index()] = stat.numOfTrucksInQueue();
+    }
+}
+
+/**
+ * @brief It returns the summary of the simulation run
+ *
+ * @return Lunar::MiningSummary
+ */
+Lunar::MiningSummary
+Lunar::MiningController::summary()
+{
+    MiningSummary sum;
+
+    sum.runTime       = runTime();
+    sum.numOfStations = mUnloadStations.size();
+    sum.numOfTrucks   = mTrucks.size();
+    sum.deliveries    = mRetiredDeliveries;
+    sum.totalWaitTime = mRetiredWaitTime;
+
+    sum.payload       = mRetiredPayload;
+
+    for (auto &trk : mTrucks) {
+        sum.deliveries    += trk.numOfDeliveries();
+        sum.totalWaitTime += trk.totalWaitTime();
+        sum.payload       += static_cast<long>(trk.numOfDeliveries()) * trk.payload();
+    }
+    sum.meanWaitTime = (sum.deliveries > 0) ? static_cast<double>(sum.totalWaitTime) / sum.deliveries : 0.0;
+
+    if(mCfg->warmUpDetection() > 0) {
+        summarizeSteadyState(sum);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Detect the warm-up by MSER-5 on the deliveries per minute
+ *          and summarize the deliveries done after it
+ *
+ * @param sum
+ */
+void
+Lunar::MiningController::summarizeSteadyState(MiningSummary &sum)
+{
+    std::vector<double> throughput(PROCESS_CLOCK + 1, 0.0);
+    auto count = [&throughput] (const TruckDeliveryLog &log) {
+        if(log.doneTime >= 0 && log.doneTime < static_cast<long>(throughput.size())) {
+            throughput[log.doneTime] += 1.0;
+        }
+    };
+    std::ranges::for_each(mRetiredLog, count);
+    for (auto &trk : mTrucks) {
+        std::ranges::for_each(trk.deliveryLog(), count);
+    }
+
+    sum.warmUpTime = WarmUpDetector::mser5(throughput);
+
+    long waitTime {0};
+    auto steady = [&sum, &waitTime] (const TruckDeliveryLog &log) {
+        if(log.doneTime > sum.warmUpTime) {
+            sum.steadyDeliveries++;
+            waitTime += log.waitTime;
+        }
+    };
+    std::ranges::for_each(mRetiredLog, steady);
+    for (auto &trk : mTrucks) {
+        std::ranges::for_each(trk.deliveryLog(), steady);
+    }
+
+    sum.steadyMeanWaitTime = (sum.steadyDeliveries > 0) ? static_cast<double>(waitTime) / sum.steadyDeliveries : 0.0;
+}
+
+/**
+ * @brief Analytic estimate of the current fleet and stations, no simulation is run
+ *          Routed trucks are assumed to drive to the nearest open station of their site
+ *
+ * @return Lunar::QueueEstimate
+ */
+Lunar::QueueEstimate
+Lunar::MiningController::estimate()
+{
+    QueueModel model;
+
+    model.loadingTime = QueueEstimator::meanLoadingTime();
+    model.runTime     = runTime();
+
+    for (auto &stat : mUnloadStations) {
+        if(stat.isOpen()) {
+            model.numOfBays += stat.numOfBays();
+        }
+    }
+
+    // nearest open station per site
+    std::vector<int> nearest(mSite.numOfSites(), std::numeric_limits<int>::max());
+    for (int site {0}; site < mSite.numOfSites(); site++) {
+        for (auto &stat : mUnloadStations) {
+            if(stat.isOpen()) {
+                nearest[site] = std::min(nearest[site], mSite.driveTime(site, stat.index()));
+            }
+        }
+    }
+
+    double drive  {0.0};
+    double unload {0.0};
+    for (auto &trk : mTrucks) {
+        auto minutes = mSite.hasRoutes() ? nearest[trk.homeSite()] : Lunar::DRIVE_TIME_MINUTES;
+        drive  += trk.scaledDriveTime(minutes);
+        unload += trk.unloadTime();
+    }
+
+    model.numOfTrucks = mTrucks.size();
+    if(model.numOfTrucks > 0) {
+        model.driveTime  = drive  / model.numOfTrucks;
+        model.unloadTime = unload / model.numOfTrucks;
+    }
+    model.startUpTime = hourToMinutes(Lunar::LOADING_TIME_MIN_HOURS) + model.driveTime;
+
+    return QueueEstimator::estimate(model);
+}
+
+/**
+ * @brief Add a truck to the fleet, it starts loading on the next tick
+ *
+ * @return Lunar::SlotHandle
+ */
+Lunar::SlotHandle
+Lunar::MiningController::addTruck()
+{
+    auto handle = createTruck();
+    if(mServicesStarted) {
+        mTrucks.get(handle)->setStartTime(PROCESS_CLOCK);
+        mTrucks.get(handle)->start();
+        mUnloadStationScheduler.truckAdded(handle);
+    }
+
+    return handle;
+}
+
+/**
+ * @brief Retire a truck from the fleet
+ *          a truck waiting in a station queue is taken off the queue and leaves at once,
+ *          a truck that is unloaded right now leaves once its delivery is done
+ *
+ * @param trkId
+ * @return true
+ * @return false if the truck is unknown
+ */
+bool
+Lunar::MiningController::retireTruck(const std::string &trkId)
+{
+    auto it  = mTruckIds.find(trkId);
+    auto trk = (it != mTruckIds.end()) ? mTrucks.get(it->second) : nullptr;
+    if(trk == nullptr) {
+        mServiceErrors++;
+        std::cerr << "[MC-ERROR], Unable to retire unknown truck:" << trkId << std::endl;
+        return false;
+    }
+
+    if(trk->hasUnloadingStation()) {
+        auto statIt = mStationIds.find(trk->unloadStationID());
+        auto stat   = (statIt != mStationIds.end()) ? mUnloadStations.get(statIt->second) : nullptr;
+        if(stat != nullptr && stat->removeTruck(trk->index())) {
+            trk->releaseUnloadStation();
+        }
+    }
+
+    auto handle = it->second;
+    if(trk->hasUnloadingStation() == false) {
+        eraseTruck(handle);
+    }
+    else if(std::ranges::find(mRetiringTrucks, handle) == mRetiringTrucks.end()) {
+        mRetiringTrucks.push_back(handle);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Open a new unload station
+ *
+ * @return Lunar::SlotHandle
+ */
+Lunar::SlotHandle
+Lunar::MiningController::openUnloadStation()
+{
+    auto handle = createUnloadStation();
+    auto stat   = mUnloadStations.get(handle);
+    mMaxStationIdLen = std::max(mMaxStationIdLen, static_cast<int>(stat->id().size()));
+    if(mServicesStarted) {
+        stat->start();
+        mUnloadStationScheduler.stationAdded(handle);
+    }
+
+    return handle;
+}
+
+/**
+ * @brief Close an unload station
+ *          the truck that is unloaded right now finishes, the waiting trucks are re-routed by the scheduler,
+ *          the station leaves once it is drained
+ *
+ * @param statId
+ * @return true
+ * @return false if the station is unknown
+ */
+bool
+Lunar::MiningController::closeUnloadStation(const std::string &statId)
+{
+    auto it   = mStationIds.find(statId);
+    auto stat = (it != mStationIds.end()) ? mUnloadStations.get(it->second) : nullptr;
+    if(stat == nullptr) {
+        mServiceErrors++;
+        std::cerr << "[MC-ERROR], Unable to close unknown unload-station:" << statId << std::endl;
+        return false;
+    }
+
+    stat->close();
+
+    // hand the waiting trucks back to the scheduler
+    mReroutedTrucks.clear();
+    stat->rerouteWaitingTrucks(mReroutedTrucks);
+    for (auto idx : mReroutedTrucks) {
+        auto trk = mTrucks.get(mTruckHandles[idx]);
+        if(trk != nullptr) {
+            trk->releaseUnloadStation();
+        }
+    }
+
+    auto handle = it->second;
+    if(stat->isDrained()) {
+        mStationIds.erase(it);
+        mUnloadStations.erase(handle);
+    }
+    else if(std::ranges::find(mClosingStations, handle) == mClosingStations.end()) {
+        mClosingStations.push_back(handle);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Schedule a fleet event, it is applied at the start of its minute
+ *
+ * @param event
+ */
+void
+Lunar::MiningController::scheduleFleetEvent(const FleetEvent &event)
+{
+    mFleetEvents.emplace(event.minute, event);
+}
+
+/**
+ * @brief Load scripted fleet events from the event-file
+ *          each line is "minute;action;target", e.g.
+ *              120;ADD_TRUCK;5
+ *              480;RETIRE_TRUCK;Truck_3
+ *              600;CLOSE_STATION;UnloadStation_1
+ *              720;OPEN_STATION;2
+ *
+ * @param path
+ * @return int number of loaded events, -1 if the file can't be opened
+ */
+int
+Lunar::MiningController::loadFleetEvents(const std::string &path)
+{
+    std::ifstream inputFile(path);
+    if(inputFile.is_open() == false) {
+        std::cerr << "[MC-ERROR], Unable to open fleet event-file " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    // the value of a number in [min, max], -1 if it isn't one
+    auto toNumber = [] (const std::string &val, long min, long max) {
+        long num {-1};
+        auto [end, ec] = std::from_chars(val.data(), val.data() + val.size(), num);
+        if(val.empty() || std::isdigit(static_cast<unsigned char>(val[0])) == 0 ||
+           ec != std::errc() || end != val.data() + val.size() || num < min || num > max) {
+            return -1L;
+        }
+        return num;
+    };
+
+    int numOfEvents {0};
+    int lineNum     {0};
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        lineNum++;
+        std::erase_if(line, [] (unsigned char c) { return std::isspace(c); });
+        if(line.empty() || line[0] == Lunar::CONFIG_COMMENT_TAGE) {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::string field;
+        std::stringstream ss(line);
+        while (std::getline(ss, field, Lunar::FLEET_EVENT_DELIMITER)) {
+            fields.push_back(field);
+        }
+
+        auto action = (fields.size() == 3) ? FleetActionName.find(fields[1]) : FleetActionName.end();
+        auto minute = (fields.empty() == false) ? toNumber(fields[0], 0, std::numeric_limits<long>::max()) : -1L;
+        if(action == FleetActionName.end() || minute < 0) {
+            mServiceErrors++;
+            std::cerr << "[MC-ERROR], " << path << ":" << lineNum << ", Invalid fleet event:" << line << std::endl;
+            continue;
+        }
+
+        FleetEvent event(static_cast<unsigned long>(minute), action->second, fields[2]);
+        if(event.action == FleetAction::ADD_TRUCK || event.action == FleetAction::OPEN_STATION) {
+            event.count = static_cast<int>(toNumber(fields[2], 1, Lunar::FLEET_EVENT_MAX_COUNT));
+            if(event.count < 0) {
+                mServiceErrors++;
+                std::cerr << "[MC-ERROR], " << path << ":" << lineNum << ", Invalid count:" << fields[2]
+                          << ", 1 to " << Lunar::FLEET_EVENT_MAX_COUNT << std::endl;
+                continue;
+            }
+        }
+
+        scheduleFleetEvent(event);
+        numOfEvents++;
+    }
+
+    return numOfEvents;
+}
+
+/**
+ * @brief Apply the fleet events that are due at the current minute
+ *
+ */
+void
+Lunar::MiningController::applyFleetEvents()
+{
+    while (mFleetEvents.empty() == false && mFleetEvents.begin()->first <= PROCESS_CLOCK) {
+        applyFleetEvent(mFleetEvents.begin()->second);
+        mFleetEvents.erase(mFleetEvents.begin());
+    }
+}
+
+/**
+ * @brief Apply a single fleet event
+ *
+ * @param event
+ */
+void
+Lunar::MiningController::applyFleetEvent(const FleetEvent &event)
+{
+    switch (event.action)
+    {
+        case FleetAction::ADD_TRUCK:
+            for (int i {0}; i < event.count; i++) {
+                auto trk = mTrucks.get(addTruck());
+                if(mReporting) {
+                    std::cerr << "[MC-INFO], Minute:" << PROCESS_CLOCK << ", Added " << trk->id() << std::endl;
+                }
+            }
+            break;
+
+        case FleetAction::RETIRE_TRUCK:
+            if(retireTruck(event.target) && mReporting) {
+                std::cerr << "[MC-INFO], Minute:" << PROCESS_CLOCK << ", Retired " << event.target << std::endl;
+            }
+            break;
+
+        case FleetAction::OPEN_STATION:
+            for (int i {0}; i < event.count; i++) {
+                auto stat = mUnloadStations.get(openUnloadStation());
+                if(mReporting) {
+                    std::cerr << "[MC-INFO], Minute:" << PROCESS_CLOCK << ", Opened " << stat->id() << std::endl;
+                }
+            }
+            break;
+
+        case FleetAction::CLOSE_STATION:
+            if(closeUnloadStation(event.target) && mReporting) {
+                std::cerr << "[MC-INFO], Minute:" << PROCESS_CLOCK << ", Closed " << event.target << std::endl;
+            }
+            break;
+
+        default:
+            mServiceErrors++;
+            std::cerr << "[MC-ERROR], Unknown fleet action:" << static_cast<int>(event.action) << std::endl;
+            break;
+    }
+}
+
+/**
+ * @brief Remove the retiring trucks that are done with their delivery
+ *
+ */
+void
+Lunar::MiningController::releaseRetiredTrucks()
+{
+    std::erase_if(mRetiringTrucks, [this] (SlotHandle handle) {
+        auto trk = mTrucks.get(handle);
+        if(trk == nullptr) {
+            return true;
+        }
+        if(trk->hasUnloadingStation()) {
+            return false;
+        }
+        eraseTruck(handle);
+        return true;
+    });
+}
+
+/**
+ * @brief Remove the closed stations that unloaded their last truck
+ *
+ */
+void
+Lunar::MiningController::releaseDrainedStations()
+{
+    std::erase_if(mClosingStations, [this] (SlotHandle handle) {
+        auto stat = mUnloadStations.get(handle);
+        if(stat == nullptr) {
+            return true;
+        }
+        if(stat->isDrained() == false) {
+            return false;
+        }
+        mStationIds.erase(stat->id());
+        mUnloadStations.erase(handle);
+        return true;
+    });
+}
+
+/**
+ * @brief Remove a truck from the fleet and keep its deliveries for the summary
+ *
+ * @param handle
+ */
+void
+Lunar::MiningController::eraseTruck(SlotHandle handle)
+{
+    auto trk = mTrucks.get(handle);
+    if(trk == nullptr) {
+        return;
+    }
+
+    mRetiredDeliveries += trk->numOfDeliveries();
+    mRetiredWaitTime   += trk->totalWaitTime();
+    mRetiredPayload    += static_cast<long>(trk->numOfDeliveries()) * trk->payload();
+    mRetiredSummaries.emplace_back(trk->summary());
+    if(mCfg->warmUpDetection() > 0) {
+        mRetiredLog.insert(mRetiredLog.end(), trk->deliveryLog().begin(), trk->deliveryLog().end());
+    }
+
+    mDepartedTrucks.push_back(trk->id());
+    mTruckIds.erase(trk->id());
+    mTrucks.erase(handle);
+}
+
+/**
+ * @brief Returns the ids of the trucks of the fleet ordered by their index
+ *
+ * @return std::vector<std::string>
+ */
+std::vector<std::string>
+Lunar::MiningController::truckIds()
+{
+    std::vector<std::string> ids;
+    for (auto handle : mTruckHandles) {
+        auto trk = mTrucks.get(handle);
+        if(trk != nullptr) {
+            ids.push_back(trk->id());
+        }
+    }
+
+    return ids;
+}
+
+/**
+ * @brief Enable/disable the real-time pacing (PROCESSING_TICK) of the service clock
+ *
+ * @param paced
+ */
+void
+Lunar::MiningController::setPaced(bool paced)
+{
+    mPaced = paced;
+}
+
+/**
+ * @brief Enable/disable the per-tick reports and the summary on the console
+ *
+ * @param reporting
+ */
+void
+Lunar::MiningController::setReporting(bool reporting)
+{
+    mReporting = reporting;
+}
+
 /**
  * @brief This method gives trucks, unload-stations and schedule time slice to run
  *          it iterates through trucks and assign them execution time
@@ -132,20 +780,28 @@ void
 Lunar::MiningController::tick()
 {
     //callback trucks
-    auto trkTick = [] (std::unique_ptr<Truck> &trk) {
-        trk->tick();
-    };
-    std::ranges::for_each(mTrucks, trkTick);
-
+    {
+        LUNAR_PROFILE_SCOPE(mProfiler, ProfilePhase::TRUCK_TICK);
+        auto trkTick = [] (Truck &trk) {
+            trk.tick();
+        };
+        std::ranges::for_each(mTrucks, trkTick);
+    }
 
     //callback unload-stations
-    auto unloadStatTick = [] (std::unique_ptr<UnloadStation> &unloadStat) {
-        unloadStat->tick();
-    };
-    std::ranges::for_each(mUnloadStations, unloadStatTick);
+    {
+        LUNAR_PROFILE_SCOPE(mProfiler, ProfilePhase::UNLOAD_STATION_TICK);
+        auto unloadStatTick = [] (UnloadStation &unloadStat) {
+            unloadStat.tick();
+        };
+        std::ranges::for_each(mUnloadStations, unloadStatTick);
+    }
 
     // callback service scheduler
-    mUnloadStationScheduler.tick();
+    {
+        LUNAR_PROFILE_SCOPE(mProfiler, ProfilePhase::SCHEDULER_TICK);
+        mUnloadStationScheduler.tick();
+    }
 }
 
 /**
@@ -165,14 +821,50 @@ Lunar::MiningController::initUnloadStationService()
     }
 
     // create list of unload stations
+    mUnloadStations.reserve(numOfUnloadStations);
     for( int s {0}; s < numOfUnloadStations; s++ ) {
-        auto id = "UnloadStation_" + std::to_string(s+1);
-        mUnloadStations.emplace_back( make_unique<UnloadStation>(id));
+        createUnloadStation();
     }
 
     return mUnloadStations.size();
 }
 
+/**
+ * @brief It creates an unload station with the next unique id
+ *
+ * @return Lunar::SlotHandle
+ */
+Lunar::SlotHandle
+Lunar::MiningController::createUnloadStation()
+{
+    int  idx    = mStationHandles.size();
+    auto id     = "UnloadStation_" + std::to_string(idx+1);
+    auto handle = mUnloadStations.emplace(id, &mQueuePool);
+    auto stat   = mUnloadStations.get(handle);
+    stat->setIndex(idx);
+
+    auto bays = mCfg->unloadStationBays(idx);
+    if(bays < 1) {
+        mServiceErrors++;
+        std::cerr << "[MC-ERROR], " << id << ", Number of bays:" << bays << ", using " << Lunar::UNLOAD_STATION_BAYS << std::endl;
+        bays = Lunar::UNLOAD_STATION_BAYS;
+    }
+    stat->setNumOfBays(bays);
+
+    auto cost = mCfg->stationAssignmentCost(idx);
+    if(cost < 0) {
+        mServiceErrors++;
+        std::cerr << "[MC-ERROR], " << id << ", Assignment cost:" << cost << ", using 0" << std::endl;
+        cost = 0;
+    }
+    stat->setAssignmentCost(cost);
+
+    mStationHandles.push_back(handle);
+    mStationIds[id] = handle;
+
+    return handle;
+}
+
 /**
  * @brief It generates trucks with unique ids
  *
@@ -189,31 +881,70 @@ Lunar::MiningController::initTruckService()
         return ServiceStatus::ERROR;
     }
 
+    // expected deliveries per truck by the mean loading time, the drive and unload times only lower it,
+    // the delivery logs grow with the actual deliveries
+    mExpectedDeliveries = runTime() / hourToMinutes((LOADING_TIME_MIN_HOURS + LOADING_TIME_MAX_HOURS) / 2) + 1;
+    for (auto &stat : mUnloadStations) {
+        mMaxStationIdLen = std::max(mMaxStationIdLen, static_cast<int>(stat.id().size()));
+    }
+
     // create list of trucks
+    mTrucks.reserve(numOfTrks);
     for( int s {0}; s < numOfTrks; s++ ) {
-        auto id = "Truck_" + std::to_string(s+1);
-        mTrucks.emplace_back(make_unique<Truck>(id));
+        createTruck();
     }
 
     return mTrucks.size();
 }
 
+/**
+ * @brief It creates a truck with the next unique id
+ *
+ * @return Lunar::SlotHandle
+ */
+Lunar::SlotHandle
+Lunar::MiningController::createTruck()
+{
+    int  idx    = mTruckHandles.size();
+    auto id     = "Truck_" + std::to_string(idx+1);
+    auto handle = mTrucks.emplace(id, &mLogPool);
+    auto trk    = mTrucks.get(handle);
+    trk->setIndex(idx);
+    trk->reserve(mMaxStationIdLen);
+    trk->setClass(mSite.truckClass(idx));
+    trk->setHomeSite(mSite.siteOf(idx), mSite.hasRoutes());
+
+    // seeded runs draw the loading times from one stream per truck
+    auto seed = mCfg->rngSeed();
+    if(seed >= 0) {
+        trk->setRandomSeed(seed);
+    }
+
+    mTruckHandles.push_back(handle);
+    mTruckIds[id] = handle;
+
+    return handle;
+}
+
 /**
  * @brief It adjust service parameters based on configuration file "mining"
  *  This method checks for
  *      1. if the "SIMULATION_TIME_HOURS" is set, it will adjust the run-time accordingly.
  *      2. if the "PROCESS_SPEED_UP_BY" is set, it will calculation the speed of the process
+ *  The run-time is kept per controller and the tick is only changed by paced controllers,
+ *  so unpaced controllers can be initialized and run side by side in one process
  */
 void
 Lunar::MiningController::initServiceParams()
 {
     auto simulationDuration = mCfg->simRunTimeInHours();
-    if(simulationDuration > 1) {
-        Lunar::SIMULATION_TIME_HOURS = simulationDuration;
-    }
+    mRunTime = hourToMinutes((simulationDuration > 1) ? simulationDuration : Lunar::SIMULATION_TIME_HOURS);
+
+    mMemoryReportMinutes = std::max(0, mCfg->memoryReportMinutes());
+    mTickReports         = (mCfg->tickReports() != 0);
 
     auto speedupBy = mCfg->processSpeedUpBy();
-    if (speedupBy > 1) {
+    if (mPaced && speedupBy > 1) {
         speedupBy = 100 % speedupBy;
         PROCESSING_TICK = (speedupBy * PROCESSING_TICK) / 100;
     }
@@ -227,7 +958,7 @@ void
 Lunar::MiningController::startTrucks()
 {
     std::ranges::for_each(mTrucks,
-                          [] (std::unique_ptr<Truck> &trk) { trk->start();});
+                          [this] (Truck &trk) { trk.setStartTime(PROCESS_CLOCK); trk.start();});
 }
 
 /**
@@ -238,7 +969,7 @@ void
 Lunar::MiningController::startUnloadStation()
 {
     std::ranges::for_each(mUnloadStations,
-        [] (std::unique_ptr<UnloadStation> &stat) { stat->start();});
+        [] (UnloadStation &stat) { stat.start();});
 }
 
 /**
@@ -250,6 +981,16 @@ Lunar::MiningController::startUnloadStationScheduler()
 {
     mUnloadStationScheduler.setUnloadStations(&mUnloadStations);
     mUnloadStationScheduler.setTrucks(&mTrucks);
+    mUnloadStationScheduler.setSiteModel(&mSite);
+
+    auto policy = mCfg->schedulingPolicy();
+    if(policy < 0 || policy >= static_cast<int>(SchedulingPolicy::COUNT)) {
+        mServiceErrors++;
+        std::cerr << "[MC-ERROR], Unknown scheduling policy:" << policy << ", using greedy" << std::endl;
+        policy = static_cast<int>(SchedulingPolicy::GREEDY);
+    }
+    mUnloadStationScheduler.setSchedulingPolicy(static_cast<SchedulingPolicy>(policy),
+                                                std::chrono::microseconds(mCfg->batchAssignmentBudgetUs()));
 }
 
 /**
@@ -259,9 +1000,7 @@ Lunar::MiningController::startUnloadStationScheduler()
 void
 Lunar::MiningController::releaseUnloadStations()
 {
-    for (int i {0}; i < mUnloadStations.size(); i++) {
-        mUnloadStations.pop_front();
-    }
+    mUnloadStations.clear();
 }
 
 /**
@@ -271,9 +1010,7 @@ Lunar::MiningController::releaseUnloadStations()
 void
 Lunar::MiningController::releaseTrucks()
 {
-    for (int i {0}; i < mTrucks.size(); i++) {
-        mTrucks.pop_front();
-    }
+    mTrucks.clear();
 }
 
 /**
@@ -306,8 +1043,8 @@ void
 Lunar::MiningController::generateTruckReport()
 {
     // The truck "operator<<" is overloaded
-    auto tReportReq = [] (std::unique_ptr<Truck> &trk) {
-        std::cout << "[T-REPORT], " << *trk << std::endl;
+    auto tReportReq = [] (Truck &trk) {
+        std::cout << "[T-REPORT], " << trk << std::endl;
         };
 
     std::ranges::for_each(mTrucks, tReportReq);
@@ -322,8 +1059,8 @@ void
 Lunar::MiningController::generateUnloadStationReport()
 {
     // The unload station "operator<<" is overloaded
-    auto sReportReq = [] (std::unique_ptr<UnloadStation> &stat) {
-        std::cout << "[S-REPORT], " << *stat << std::endl;
+    auto sReportReq = [] (UnloadStation &stat) {
+        std::cout << "[S-REPORT], " << stat << std::endl;
     };
 
     std::ranges::for_each(mUnloadStations, sReportReq);
@@ -338,20 +1075,39 @@ void
 Lunar::MiningController::generateSummary()
 {
     std::stringstream ss;
-    auto trksTotalDelivery {0};
-
-    //calculate total deliveries by summing up the numbers of deliveries by each truck
-    std::ranges::for_each(mTrucks, [&trksTotalDelivery] (std::unique_ptr<Truck> &trk) {
-                                    trksTotalDelivery += trk.get()->numOfDeliveries();});
 
-    auto totalRunTime = hourToMinutes(Lunar::SIMULATION_TIME_HOURS);
+    // once, the steady-state part scans the delivery logs of the whole run,
+    // the text summary is derived from it so both report the same numbers
+    auto sum = summary();
     ss  << std::setfill('-') << std::setw(40) << "\n" << "[MINING-SUMMARY], \n\t"               << std::left << std::setw(30) << std::setfill(' ')
-        << "MiningRunTime:"             << totalRunTime                         << ":min, \n\t" << std::left << std::setw(30)
-        << "NumOfUnloadStations:"       << mUnloadStations.size()               << ", \n\t"     << std::left << std::setw(30)
-        << "NumOfTrucks:"               << mTrucks.size()                       << ", \n\t"     << std::left << std::setw(30)
-        << "NumOfDelivery:"             << trksTotalDelivery                    << ", \n\t"     << std::left << std::setw(30)
-        << "AverageTruckDelivery:"      << (trksTotalDelivery / mTrucks.size()) << ", \n\t"     << std::left << std::setw(30)
-        << "AverageMiningDeliveryTime:" << (totalRunTime/ trksTotalDelivery)    << ":min\n"     << std::endl;
+        << "MiningRunTime:"             << sum.runTime                          << ":min, \n\t" << std::left << std::setw(30)
+        << "NumOfUnloadStations:"       << sum.numOfStations                    << ", \n\t"     << std::left << std::setw(30)
+        << "NumOfTrucks:"               << sum.numOfTrucks                      << ", \n\t"     << std::left << std::setw(30)
+        << "NumOfDelivery:"             << sum.deliveries                       << ", \n\t"     << std::left << std::setw(30)
+        << "DeliveredPayload:"          << sum.payload                          << ":t, \n\t"   << std::left << std::setw(30)
+        << "AverageTruckDelivery:"      << (sum.deliveries / std::max(sum.numOfTrucks, 1L)) << ", \n\t"     << std::left << std::setw(30)
+        << "AverageMiningDeliveryTime:" << ((sum.deliveries > 0) ? sum.runTime / sum.deliveries : 0) << ":min\n" << std::endl;
+
+    // statistics without the initial transient
+    if(mCfg->warmUpDetection() > 0) {
+        auto steadyRunTime = std::max<long>(PROCESS_CLOCK - sum.warmUpTime, 1);
+        ss  << "\t" << std::left << std::setw(30)
+            << "WarmUpTime:"                << sum.warmUpTime                       << ":min, \n\t" << std::left << std::setw(30)
+            << "SteadyStateDelivery:"       << sum.steadyDeliveries                 << ", \n\t"     << std::left << std::setw(30)
+            << "SteadyStateDeliveryPerHour:"<< std::fixed << std::setprecision(2)
+                                            << (sum.steadyDeliveries * 60.0 / steadyRunTime) << ", \n\t" << std::left << std::setw(30)
+            << "SteadyStateMeanWaitTime:"   << sum.steadyMeanWaitTime               << ":min\n"     << std::endl;
+    }
+
+    // current/peak memory of the subsystems, the peak RSS of the process covers everything else as well
+    auto toKb = [] (size_t bytes) { return (bytes + 1023) / 1024; };
+    ss << "\t";
+    for (auto &[sub, name] : MemorySubsystemName) {
+        auto &usage = mMemory.usage(sub);
+        ss  << std::left << std::setw(30) << ("Memory" + name + ":")
+            << toKb(usage.current()) << "/" << toKb(usage.peak()) << ":KB, \n\t";
+    }
+    ss  << std::left << std::setw(30) << "PeakRSS:" << MemoryAccount::peakRssKb() << ":KB\n" << std::endl;
 
     std::cerr << ss.rdbuf()->str() << std::endl;
 
@@ -363,8 +1119,99 @@ Lunar::MiningController::generateSummary()
         ss << "\n[Truck-SUMMARY], \n\t";
         std::cerr << ss.rdbuf()->str() << std::endl;
 
-        std::ranges::for_each(mTrucks, [] (std::unique_ptr<Truck> &trk) { std::cerr << trk.get()->summary(); });
+        std::ranges::for_each(mTrucks, [&sum] (Truck &trk) { std::cerr << trk.summary(sum.warmUpTime); });
+        std::ranges::for_each(mRetiredSummaries, [] (const std::pmr::string &sum) { std::cerr << "[RETIRED]" << sum; });
+    }
+}
+
+/**
+ * @brief Publish the truck states, the station queues and the KPIs of the minute to the live snapshot,
+ *          the readers retry while it is written and never block the simulation
+ *
+ */
+void
+Lunar::MiningController::publishLiveSnapshot()
+{
+    auto &hdr    = mLiveSnapshot.begin();
+    auto *states = mLiveSnapshot.truckStates();
+    auto *queues = mLiveSnapshot.stationQueues();
+
+    auto truckIndices   = std::min<uint32_t>(mTruckHandles.size(),   hdr.truckCapacity);
+    auto stationIndices = std::min<uint32_t>(mStationHandles.size(), hdr.stationCapacity);
+    for (uint32_t t {0}; t < truckIndices; t++) {
+        storeRelaxed(states[t], LIVE_SNAPSHOT_RETIRED);
+    }
+    for (uint32_t s {0}; s < stationIndices; s++) {
+        storeRelaxed(queues[s], int32_t {-1});
+    }
+
+    std::array<uint32_t, static_cast<size_t>(TruckState::COUNT)> inState {};
+    uint64_t deliveries    = mRetiredDeliveries;
+    uint64_t totalWaitTime = mRetiredWaitTime;
+    for (auto &trk : mTrucks) {
+        inState[static_cast<size_t>(trk.state())]++;
+        deliveries    += trk.numOfDeliveries();
+        totalWaitTime += trk.totalWaitTime();
+        if(static_cast<uint32_t>(trk.index()) < truckIndices) {
+            storeRelaxed(states[trk.index()], static_cast<uint8_t>(trk.state()));
+        }
     }
+
+    uint64_t queued {0};
+    for (auto &stat : mUnloadStations) {
+        auto len = stat.numOfTrucksInQueue();
+        queued += len;
+        if(static_cast<uint32_t>(stat.index()) < stationIndices) {
+            storeRelaxed(queues[stat.index()], static_cast<int32_t>(len));
+        }
+    }
+
+    storeRelaxed(hdr.minute,         static_cast<uint64_t>(PROCESS_CLOCK));
+    storeRelaxed(hdr.runTime,        static_cast<uint64_t>(mRunTime));
+    storeRelaxed(hdr.numOfTrucks,    static_cast<uint32_t>(mTrucks.size()));
+    storeRelaxed(hdr.numOfStations,  static_cast<uint32_t>(mUnloadStations.size()));
+    storeRelaxed(hdr.truckIndices,   static_cast<uint32_t>(mTruckHandles.size()));
+    storeRelaxed(hdr.stationIndices, static_cast<uint32_t>(mStationHandles.size()));
+    storeRelaxed(hdr.deliveries,     deliveries);
+    storeRelaxed(hdr.totalWaitTime,  totalWaitTime);
+    storeRelaxed(hdr.queuedTrucks,   queued);
+    for (size_t s {0}; s < inState.size(); s++) {
+        storeRelaxed(hdr.trucksInState[s], inState[s]);
+    }
+
+    mLiveSnapshot.end();
+}
+
+/**
+ * @brief Add the trucks per state and the station queues of the minute to the level-of-detail timeline
+ *
+ */
+void
+Lunar::MiningController::generateTimelineSample()
+{
+    TruckStateCounts inState {};
+    for (auto &trk : mTrucks) {
+        inState[static_cast<size_t>(trk.state())]++;
+    }
+
+    // by station index, closed stations are -1
+    mTimelineQueues.assign(mStationHandles.size(), -1);
+    for (auto &stat : mUnloadStations) {
+        mTimelineQueues[stat.index()] = stat.numOfTrucksInQueue();
+    }
+
+    mTimeline.sample(PROCESS_CLOCK, inState, mTimelineQueues);
+}
+
+/**
+ * @brief Report the current/peak memory of the subsystems, every MEMORY_REPORT_MINUTES simulated minutes
+ *
+ */
+void
+Lunar::MiningController::generateMemoryReport()
+{
+    std::cerr << "[MEMORY-INFO], Minute:" << PROCESS_CLOCK << ", " << mMemory.format()
+              << ", PeakRSS:" << MemoryAccount::peakRssKb() << "KB" << std::endl;
 }
 
 /**
@@ -377,7 +1224,7 @@ Lunar::MiningController::generateServiceStartUpInfo()
 {
     std::stringstream ss;
 
-    auto totalRunTime = hourToMinutes(Lunar::SIMULATION_TIME_HOURS);
+    auto totalRunTime = mRunTime;
 
     ss << "[MC-INFO], MiningRunTime:" << totalRunTime                   << "min, "
         << "NumOfUnloadStations:"     << mUnloadStations.size()         << ", "
@@ -385,5 +1232,58 @@ Lunar::MiningController::generateServiceStartUpInfo()
         << "PROCESSING_TICK:"         << Lunar::PROCESSING_TICK.count() << ", "
         << std::endl;
 
+    if(mSite.hasRoutes() || mSite.numOfClasses() > 0) {
+        ss << "[MC-INFO], MiningSites:" << mSite.numOfSites()   << ", "
+           << "TruckClasses:"           << mSite.numOfClasses() << ", "
+           << "Routed:"                 << (mSite.hasRoutes() ? "yes" : "no")
+           << std::endl;
+    }
+
+    auto est = estimate();
+    ss << "[MC-INFO], Estimate: "
+       << "Utilization:"       << std::fixed << std::setprecision(1) << est.utilization * 100.0 << "%, "
+       << "MeanWaitTime:"      << est.meanWaitTime      << "min, "
+       << "DeliveriesPerHour:" << est.deliveriesPerHour << ", "
+       << "Deliveries:"        << est.deliveries
+       << std::endl;
+
     std::cerr << ss.rdbuf()->str() << std::endl;
+}
+
+/**
+ * @brief It prints the per-phase tick profile and dumps it as JSON if PROFILE_JSON_FILE is set,
+ *          only available in builds with LUNAR_PROFILE
+ *
+ */
+void
+Lunar::MiningController::generateProfileSummary()
+{
+#ifdef LUNAR_PROFILE
+    std::cerr << mProfiler.summary() << std::endl;
+
+    auto path = mCfg->profileJsonFile();
+    if(path.empty() == false) {
+        mProfiler.dumpJson(path);
+    }
+#endif
+}
+
+/**
+ * @brief It passes the state of each truck and unload-station to the trace-event writer,
+ *          the writer only emits a span when a state changes
+ *
+ */
+void
+Lunar::MiningController::generateTraceEvents()
+{
+    for (auto &trk : mTrucks) {
+        mTraceWriter.truckState(trk.index(), trk.id(), trk.state(), PROCESS_CLOCK);
+    }
+
+    for (auto &stat : mUnloadStations) {
+        mTraceBayTrucks.clear();
+        stat.forEachUnloadingTruck([this] (const std::string &trkId) { mTraceBayTrucks.push_back(&trkId); });
+        mTraceWriter.stationState(stat.index(), stat.id(), stat.numOfBays(),
+                                  mTraceBayTrucks, stat.numOfTrucksInQueue(), PROCESS_CLOCK);
+    }
 }
\ No newline at end of file
@@ -6,10 +6,19 @@
 #include "unload_station.h"
 #include "truck.h"
 #include "unload_station_scheduler.h"
+#include "simulation_engine.h"
+#include "tick_profiler.h"
+#include "trace_event_writer.h"
+#include "site_model.h"
+#include "queue_estimator.h"
+#include "warm_up_detector.h"
+#include "memory_account.h"
+#include "live_snapshot.h"
+#include "timeline_pyramid.h"
 
 namespace Lunar {
 
-    class MiningController
+    class MiningController : public SimulationEngine
     {
         public:
             MiningController() {}
@@ -20,20 +29,75 @@ namespace Lunar {
                 virtual ~MiningController();
                 void     releaseResources();
 
-                ServiceStatus init ();
+                ServiceStatus init () override;
                 ServiceStatus start();
                 void          stop ();
 
                 void set(Lunar::Config *cfg);
 
+                void setPaced    (bool paced);
+                void setReporting(bool reporting);
+                void startServices() override;
+                void step        () override;
+                unsigned long clock() override;
+                long runTime     () override;
+                void snapshot    (EngineSnapshot &snap) override;
+                MiningSummary summary() override;
+                QueueEstimate estimate();
+
+                // runtime control of the fleet, it takes effect on the next tick
+                SlotHandle addTruck          ();
+                bool       retireTruck       (const std::string &trkId);
+                SlotHandle openUnloadStation ();
+                bool       closeUnloadStation(const std::string &statId);
+                void       scheduleFleetEvent(const FleetEvent &event);
+                int        loadFleetEvents   (const std::string &path);
+
+                // ids of the fleet by index, and the trucks that left it since the last clear, e.g. to another site
+                std::vector<std::string>        truckIds        ();
+                const std::vector<std::string> &departedTrucks  () const { return mDepartedTrucks; }
+                void                            clearDepartedTrucks()    { mDepartedTrucks.clear(); }
+
         protected:
             Config *mCfg;
-            std::list<std::unique_ptr<Truck>> mTrucks;
-            std::list<std::unique_ptr<UnloadStation>> mUnloadStations;
+            // memory by subsystem, it has to outlive the containers that allocate from it
+            MemoryAccount mMemory;
+            // the pool has to outlive the station queues that allocate from it
+            std::pmr::unsynchronized_pool_resource mQueuePool {mMemory.resource(MemorySubsystem::STATION_QUEUES)};
+            // the pool has to outlive the delivery logs of the trucks that allocate from it
+            std::pmr::unsynchronized_pool_resource mLogPool {mMemory.resource(MemorySubsystem::WAIT_HISTORY)};
+            // trucks and stations are stored by value, the handles stay valid if entities are added or removed
+            SlotMap<Truck> mTrucks {mMemory.resource(MemorySubsystem::TRUCKS)};
+            SlotMap<UnloadStation> mUnloadStations {mMemory.resource(MemorySubsystem::STATIONS)};
+
+            // handles by entity index and id, retired/closed entities leave stale handles behind
+            std::vector<SlotHandle> mTruckHandles;
+            std::vector<SlotHandle> mStationHandles;
+            std::unordered_map<std::string, SlotHandle> mTruckIds;
+            std::unordered_map<std::string, SlotHandle> mStationIds;
+
+            // pending fleet events ordered by minute, same-minute events keep their order
+            std::multimap<unsigned long, FleetEvent> mFleetEvents;
+            std::vector<SlotHandle> mRetiringTrucks;
+            std::vector<SlotHandle> mClosingStations;
+            std::vector<int>        mReroutedTrucks;
             UnloadStationScheduler mUnloadStationScheduler;
+            SiteModel mSite;
+            TraceEventWriter mTraceWriter;
+            LiveSnapshotWriter mLiveSnapshot;
+            TimelinePyramidWriter mTimeline;
+            std::vector<int> mTimelineQueues;
+            std::vector<const std::string *> mTraceBayTrucks;
 
             int  initUnloadStationService();
             int  initTruckService  ();
+            SlotHandle createUnloadStation();
+            SlotHandle createTruck ();
+            void applyFleetEvents  ();
+            void applyFleetEvent   (const FleetEvent &event);
+            void releaseRetiredTrucks();
+            void releaseDrainedStations();
+            void eraseTruck        (SlotHandle handle);
             void initServiceParams ();
             void startTrucks       ();
             void startUnloadStation();
@@ -46,14 +110,39 @@ namespace Lunar {
             void generateUnloadStationReport();
             void generateSummary    ();
             void generateServiceStartUpInfo();
+            void generateProfileSummary();
+            void generateTraceEvents();
+            void generateMemoryReport();
+            void publishLiveSnapshot();
+            void generateTimelineSample();
+            void summarizeSteadyState(MiningSummary &sum);
 
             void releaseUnloadStations();
             void releaseTrucks();
 
         private:
             bool RUN_SERVICE {false};
+            bool mPaced      {true};
+            bool mReporting  {true};
             unsigned long PROCESS_CLOCK {0};
+            long mRunTime {0};
             int mServiceErrors {0};
+            int  mMemoryReportMinutes{0};
+            bool mTickReports    {true};
+            long mExpectedDeliveries{0};
+            int  mMaxStationIdLen{0};
+            bool mServicesStarted{false};
+
+            // bookkeeping of the retired trucks, so the summary covers the whole fleet
+            long mRetiredDeliveries {0};
+            long mRetiredWaitTime   {0};
+            long mRetiredPayload    {0};
+            std::pmr::vector<std::pmr::string> mRetiredSummaries {mMemory.resource(MemorySubsystem::REPORTS)};
+            std::pmr::vector<TruckDeliveryLog> mRetiredLog      {mMemory.resource(MemorySubsystem::WAIT_HISTORY)};
+            std::vector<std::string> mDepartedTrucks;
+#ifdef LUNAR_PROFILE
+            TickProfiler mProfiler;
+#endif
 
             void tick();
     };
@@ -0,0 +1,131 @@
+#include "live_snapshot.h"
+#include "service_include.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+    struct MonitorParams {
+        std::string shm        {"/lunar_mining"};
+        long        intervalMs {1000};
+        long        count      {0};         // 0: until the simulation ends
+        long        stallPolls {10};        // 0: never, else stop after this many polls without a new minute
+    };
+
+    /**
+     * @brief Parse the command line, e.g. --shm=/lunar_mining --interval-ms=500 --count=10 --stall-polls=10
+     *
+     * @param argc
+     * @param argv
+     * @param params
+     * @return true
+     * @return false
+     */
+    bool parseArgs(int argc, char *argv[], MonitorParams &params)
+    {
+        for (int i {1}; i < argc; i++) {
+            std::string arg {argv[i]};
+            auto pos = arg.find(Lunar::CONFIG_DELIMITER);
+            if(arg.rfind("--", 0) != 0 || pos == std::string::npos) {
+                std::cerr << "[MONITOR-ERROR], Invalid argument:" << arg << std::endl;
+                return false;
+            }
+
+            auto key = arg.substr(2, pos - 2);
+            auto val = arg.substr(pos + 1);
+            try {
+                if(key == "shm")                { params.shm        = val; }
+                else if(key == "interval-ms")   { params.intervalMs = std::max(1L, std::stol(val)); }
+                else if(key == "count")         { params.count      = std::max(0L, std::stol(val)); }
+                else if(key == "stall-polls")   { params.stallPolls = std::max(0L, std::stol(val)); }
+                else {
+                    std::cerr << "[MONITOR-ERROR], Unknown argument:" << key << std::endl;
+                    return false;
+                }
+            }
+            catch (const std::exception &e) {
+                std::cerr << "[MONITOR-ERROR], Invalid value for " << key << ": " << e.what() << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Print one snapshot as a [MONITOR-INFO] line
+     *
+     * @param snap
+     * @param retries
+     */
+    void printSnapshot(const Lunar::LiveSnapshot &snap, unsigned long retries)
+    {
+        std::cout << "[MONITOR-INFO], Minute:" << snap.minute << "/" << snap.runTime
+                  << ", Trucks:" << snap.numOfTrucks << ", UnloadStations:" << snap.numOfStations;
+        for (size_t s {0}; s < snap.trucksInState.size(); s++) {
+            std::cout << ", " << Lunar::TruckStateName.at(static_cast<Lunar::TruckState>(s)) << ":" << snap.trucksInState[s];
+        }
+
+        auto meanWait = (snap.deliveries > 0) ? static_cast<double>(snap.totalWaitTime) / snap.deliveries : 0.0;
+        std::cout << ", Deliveries:" << snap.deliveries << ", MeanWaitTime:" << meanWait
+                  << ", Queued:" << snap.queuedTrucks << ", Retries:" << retries << std::endl;
+    }
+}
+
+/**
+ * @brief Live monitor of a running simulation
+ *          It maps the shared-memory snapshot of LIVE_SNAPSHOT_SHM read-only and prints it periodically,
+ *          the simulation never waits for the monitor
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char *argv[])
+{
+    MonitorParams params;
+    if(parseArgs(argc, argv, params) == false) {
+        std::cerr << "Usage: " << argv[0] << " [--shm=/lunar_mining] [--interval-ms=N] [--count=N] [--stall-polls=N]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Lunar::LiveSnapshotReader reader;
+    if(reader.open(params.shm) == false) {
+        std::cerr << "[MONITOR-ERROR], No live snapshot " << params.shm << ", is LIVE_SNAPSHOT_SHM set?" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Lunar::LiveSnapshot snap;
+    uint64_t lastMinute {0};
+    long     stalled    {0};
+    for (long n {0}; params.count == 0 || n < params.count; n++) {
+        if(n > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(params.intervalMs));
+        }
+
+        if(reader.read(snap) == false) {
+            std::cerr << "[MONITOR-ERROR], No consistent snapshot after " << Lunar::LIVE_SNAPSHOT_READ_RETRIES << " retries" << std::endl;
+            continue;
+        }
+        printSnapshot(snap, reader.retries());
+
+        // the writer publishes the end of the run and unlinks the region, the last snapshot stays mapped
+        if(snap.runState != Lunar::LiveRunState::RUNNING) {
+            std::cout << "[MONITOR-INFO], Simulation "
+                      << ((snap.runState == Lunar::LiveRunState::FINISHED) ? "finished" : "aborted") << std::endl;
+            break;
+        }
+
+        // a killed simulation publishes nothing more, the region is gone or the minute stands still
+        stalled = (n > 0 && snap.minute == lastMinute) ? stalled + 1 : 0;
+        if(Lunar::LiveSnapshotReader::exists(params.shm) == false ||
+           (params.stallPolls > 0 && stalled >= params.stallPolls)) {
+            std::cerr << "[MONITOR-ERROR], Simulation stopped publishing at minute " << snap.minute << std::endl;
+            break;
+        }
+        lastMinute = snap.minute;
+    }
+
+    return EXIT_SUCCESS;
+}
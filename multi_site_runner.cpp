@@ -0,0 +1,429 @@
+#include "multi_site_runner.h"
+
+/**
+ * @brief Load the sites of MULTI_SITE_FILE and simulate them until the run time of the main config,
+ *          each site on its own thread or all of them on one thread with MULTI_SITE_SERIAL=1
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::MultiSiteRunner::run()
+{
+    if(mCfg->simRunTimeInHours() < 1) {
+        std::cerr << "[MULTI-SITE-ERROR], Invalid SIMULATION_TIME_HOURS" << std::endl;
+        return ServiceStatus::ERROR;
+    }
+    mRunTime = static_cast<long>(mCfg->simRunTimeInHours()) * 60;
+    mSerial  = (mCfg->multiSiteSerial() == 1);
+
+    if(load(mCfg->multiSiteFile()) != ServiceStatus::SUCESS || initSites() != ServiceStatus::SUCESS) {
+        return ServiceStatus::ERROR;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if(mSerial) {
+        runSerial();
+    }
+    else {
+        runParallel();
+    }
+    generateSummary(std::chrono::steady_clock::now() - start);
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Load the multi-site file, each line is one of
+ *              site;name;config-file
+ *              route;from;to;minutes
+ *              transfer;minute;from;to;trucks
+ *          a route is one-way, its drive time has to be at least one minute,
+ *          a transfer moves 1 to FLEET_EVENT_MAX_COUNT trucks of the sending site over an existing route
+ *
+ * @param path
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::MultiSiteRunner::load(const std::string &path)
+{
+    std::ifstream inputFile(path);
+    if(inputFile.is_open() == false) {
+        std::cerr << "[MULTI-SITE-ERROR], Unable to open multi-site file " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    // the value of a number in [min, max], -1 if it isn't one
+    auto toNumber = [] (const std::string &val, long min, long max) {
+        long num {-1};
+        auto [end, ec] = std::from_chars(val.data(), val.data() + val.size(), num);
+        if(val.empty() || std::isdigit(static_cast<unsigned char>(val[0])) == 0 ||
+           ec != std::errc() || end != val.data() + val.size() || num < min || num > max) {
+            return -1L;
+        }
+        return num;
+    };
+
+    auto ret {ServiceStatus::SUCESS};
+    auto invalid = [&] (int lineNum, const std::string &line) {
+        std::cerr << "[MULTI-SITE-ERROR], " << path << ":" << lineNum << ", Invalid line:" << line << std::endl;
+        ret = ServiceStatus::ERROR;
+    };
+
+    int lineNum {0};
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        lineNum++;
+        std::erase_if(line, [] (unsigned char c) { return std::isspace(c); });
+        if(line.empty() || line[0] == Lunar::CONFIG_COMMENT_TAGE) {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::string field;
+        std::stringstream ss(line);
+        while (std::getline(ss, field, Lunar::MULTI_SITE_DELIMITER)) {
+            fields.push_back(field);
+        }
+
+        if(fields[0] == "site" && fields.size() == 3 && fields[1].empty() == false && siteIndex(fields[1]) < 0) {
+            auto site   = std::make_unique<SiteProcess>();
+            site->index = static_cast<int>(mSites.size());
+            site->name  = fields[1];
+            site->cfg   = std::make_unique<Config>(fields[2]);
+            if(site->cfg->read(fields[2]) < 0) {
+                invalid(lineNum, line);
+                continue;
+            }
+            mSites.push_back(std::move(site));
+        }
+        else if(fields[0] == "route" && fields.size() == 4) {
+            auto from      = siteIndex(fields[1]);
+            auto to        = siteIndex(fields[2]);
+            auto lookahead = toNumber(fields[3], 1, std::numeric_limits<long>::max());
+            if(from < 0 || to < 0 || from == to || lookahead < 0 || mSites[from]->outChannels.contains(to)) {
+                invalid(lineNum, line);
+                continue;
+            }
+
+            auto channel = std::make_unique<SiteChannel>();
+            channel->from      = from;
+            channel->to        = to;
+            channel->lookahead = lookahead;
+            mSites[from]->outChannels[to] = channel.get();
+            mSites[to]->inChannels.push_back(channel.get());
+            mChannels.push_back(std::move(channel));
+        }
+        else if(fields[0] == "transfer" && fields.size() == 5) {
+            auto minute = toNumber(fields[1], 0, std::numeric_limits<long>::max());
+            auto from   = siteIndex(fields[2]);
+            auto to     = siteIndex(fields[3]);
+            auto trucks = toNumber(fields[4], 1, Lunar::FLEET_EVENT_MAX_COUNT);
+            if(minute < 0 || from < 0 || to < 0 || trucks < 0 || mSites[from]->outChannels.contains(to) == false) {
+                invalid(lineNum, line);
+                continue;
+            }
+            mSites[from]->transfers.push_back(SiteTransfer(static_cast<unsigned long>(minute), to, static_cast<int>(trucks)));
+        }
+        else {
+            invalid(lineNum, line);
+        }
+    }
+
+    if(mSites.empty()) {
+        std::cerr << "[MULTI-SITE-ERROR], No site in " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    for (auto &site : mSites) {
+        std::ranges::stable_sort(site->transfers, {}, &SiteTransfer::minute);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Initialize the controller of each site, the sites run for the time of the main config,
+ *          a site without RNG_SEED is seeded from the main seed and its index
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::MultiSiteRunner::initSites()
+{
+    auto seed = mCfg->rngSeed();
+    if(seed < 0) {
+        seed = Lunar::DEFAULT_RNG_SEED;
+    }
+
+    for (auto &site : mSites) {
+        site->cfg->set(ServiceParams::SIMULATION_TIME_HOURS, mCfg->simRunTimeInHours());
+        if(site->cfg->rngSeed() < 0) {
+            site->cfg->set(ServiceParams::RNG_SEED, seed + site->index);
+        }
+
+        site->ctrl = std::make_unique<MiningController>(site->cfg.get());
+        site->ctrl->setPaced(false);
+        site->ctrl->setReporting(false);
+        if(site->ctrl->init() != ServiceStatus::SUCESS) {
+            std::cerr << "[MULTI-SITE-ERROR], Site:" << site->name << " init failed" << std::endl;
+            return ServiceStatus::ERROR;
+        }
+        site->ctrl->startServices();
+    }
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Advance each site on its own thread pinned by WORKER_PINNING,
+ *          a blocked site yields until the sites it waits for caught up
+ *
+ */
+void
+Lunar::MultiSiteRunner::runParallel()
+{
+    auto cpus = CpuTopology().workerCpus(static_cast<int>(mSites.size()), WorkerPool::pinningPolicy(*mCfg));
+
+    std::vector<std::thread> threads;
+    threads.reserve(mSites.size());
+    for (auto &site : mSites) {
+        threads.emplace_back([this, proc = site.get(), cpu = cpus[site->index]] () {
+            CpuTopology::pinCurrentThread(cpu);
+            while (proc->done == false) {
+                if(advance(*proc) == false) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Advance the sites round-robin on the calling thread, it gives the same results as runParallel()
+ *
+ */
+void
+Lunar::MultiSiteRunner::runSerial()
+{
+    auto running = mSites.size();
+    while (running > 0) {
+        running = 0;
+        for (auto &site : mSites) {
+            if(site->done == false) {
+                advance(*site);
+                running++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Simulate the next minute of the site if it is safe, i.e. no site with a route to it
+ *          can still send trucks that arrive up to that minute.
+ *          Due transfers retire trucks through the fleet events of the controller,
+ *          the trucks leave once they are done with their current task and are sent to the receiving site,
+ *          where they arrive after the drive time of the route as new trucks.
+ *
+ * @param site
+ * @return false if the site is blocked
+ */
+bool
+Lunar::MultiSiteRunner::advance(SiteProcess &site)
+{
+    receive(site);
+    if(flush(site) == false) {
+        site.blockedPolls++;
+        return false;
+    }
+
+    auto &ctrl  = *site.ctrl;
+    auto  clock = ctrl.clock();
+    if(clock > static_cast<unsigned long>(mRunTime)) {
+        site.done = true;
+        site.published.store(SiteProcess::DONE, std::memory_order_release);
+        return true;
+    }
+    site.published.store(clock, std::memory_order_release);
+
+    auto next = clock + 1;
+    for (auto *channel : site.inChannels) {
+        auto published = mSites[channel->from]->published.load(std::memory_order_acquire);
+        if(published != SiteProcess::DONE && published + channel->lookahead < next) {
+            site.blockedPolls++;
+            return false;
+        }
+    }
+
+    // the events up to the next minute are in the queues now
+    receive(site);
+    while (site.pending.empty() == false && site.pending.front().minute <= next) {
+        auto event = site.pending.front();
+        std::ranges::pop_heap(site.pending, std::greater<>());
+        site.pending.pop_back();
+
+        ctrl.scheduleFleetEvent(FleetEvent(next, FleetAction::ADD_TRUCK, "", event.trucks));
+        site.trucksIn += event.trucks;
+    }
+
+    while (site.nextTransfer < site.transfers.size() && site.transfers[site.nextTransfer].minute <= next) {
+        startTransfer(site, site.transfers[site.nextTransfer++]);
+    }
+
+    ctrl.step();
+
+    for (const auto &trkId : ctrl.departedTrucks()) {
+        auto it = site.transferring.find(trkId);
+        if(it != site.transferring.end()) {
+            send(site, it->second, ctrl.clock());
+            site.transferring.erase(it);
+        }
+    }
+    ctrl.clearDepartedTrucks();
+
+    if(flush(site)) {
+        site.published.store(ctrl.clock(), std::memory_order_release);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Drain the queues of the routes to the site into its pending events
+ *
+ * @param site
+ */
+void
+Lunar::MultiSiteRunner::receive(SiteProcess &site)
+{
+    SiteEvent event;
+    for (auto *channel : site.inChannels) {
+        while (channel->queue.pop(event)) {
+            site.pending.push_back(event);
+            std::ranges::push_heap(site.pending, std::greater<>());
+        }
+    }
+}
+
+/**
+ * @brief Move the events that didn't fit into the queues of the routes from the site
+ *
+ * @param site
+ * @return false if events are left, the site must not publish its clock
+ */
+bool
+Lunar::MultiSiteRunner::flush(SiteProcess &site)
+{
+    bool flushed {true};
+    for (auto &[to, channel] : site.outChannels) {
+        while (channel->overflow.empty() == false && channel->queue.push(channel->overflow.front())) {
+            channel->overflow.pop_front();
+        }
+        flushed = flushed && channel->overflow.empty();
+    }
+
+    return flushed;
+}
+
+/**
+ * @brief Retire the newest trucks of the site that are not transferred yet,
+ *          they are sent when they leave the site
+ *
+ * @param site
+ * @param transfer
+ */
+void
+Lunar::MultiSiteRunner::startTransfer(SiteProcess &site, const SiteTransfer &transfer)
+{
+    auto ids = site.ctrl->truckIds();
+    int  retired {0};
+    for (auto it = ids.rbegin(); it != ids.rend() && retired < transfer.trucks; it++) {
+        if(site.transferring.contains(*it)) {
+            continue;
+        }
+        site.ctrl->scheduleFleetEvent(FleetEvent(transfer.minute, FleetAction::RETIRE_TRUCK, *it));
+        site.transferring[*it] = transfer.to;
+        retired++;
+    }
+
+    if(retired < transfer.trucks) {
+        std::cerr << "[MULTI-SITE-ERROR], Site:" << site.name << ", Minute:" << transfer.minute
+                  << ", Transfer of " << transfer.trucks << " trucks, " << retired << " available" << std::endl;
+    }
+}
+
+/**
+ * @brief Send a truck that left the site in the given minute to the receiving site,
+ *          a truck that arrives after the end of the run stays in transit
+ *
+ * @param site
+ * @param to
+ * @param minute
+ */
+void
+Lunar::MultiSiteRunner::send(SiteProcess &site, int to, unsigned long minute)
+{
+    auto *channel = site.outChannels[to];
+    auto  arrival = minute + channel->lookahead;
+    site.trucksOut++;
+    if(arrival > static_cast<unsigned long>(mRunTime) + 1) {
+        mInTransit++;
+        return;
+    }
+
+    channel->overflow.push_back(SiteEvent(arrival, site.index, site.seq++, 1));
+}
+
+/**
+ * @brief Returns the index of the site with the given name
+ *
+ * @param name
+ * @return int -1 if unknown
+ */
+int
+Lunar::MultiSiteRunner::siteIndex(const std::string &name)
+{
+    auto it = std::ranges::find_if(mSites, [&name] (const auto &site) { return site->name == name; });
+    return (it != mSites.end()) ? static_cast<int>(it - mSites.begin()) : -1;
+}
+
+/**
+ * @brief Report the sites and the totals of the run
+ *
+ * @param wallTime
+ */
+void
+Lunar::MultiSiteRunner::generateSummary(std::chrono::steady_clock::duration wallTime)
+{
+    long   deliveries    {0};
+    long   totalWaitTime {0};
+    long   transferred   {0};
+    for (auto &site : mSites) {
+        auto sum = site->ctrl->summary();
+        deliveries    += sum.deliveries;
+        totalWaitTime += sum.totalWaitTime;
+        transferred   += site->trucksOut;
+
+        std::cerr << "[MULTI-SITE-INFO], Site:" << site->name << ", "
+                  << "Trucks:"       << sum.numOfTrucks << ", "
+                  << "Deliveries:"   << sum.deliveries  << ", "
+                  << "MeanWaitTime:" << std::fixed << std::setprecision(2) << sum.meanWaitTime << ", "
+                  << "TrucksIn:"     << site->trucksIn     << ", "
+                  << "TrucksOut:"    << site->trucksOut    << ", "
+                  << "BlockedPolls:" << site->blockedPolls << std::endl;
+    }
+
+    auto meanWaitTime = (deliveries > 0) ? static_cast<double>(totalWaitTime) / deliveries : 0.0;
+    auto wallMs       = std::chrono::duration<double, std::milli>(wallTime).count();
+    std::cerr << "[MULTI-SITE-SUMMARY], Sites:" << mSites.size() << ", "
+              << "Threads:"           << (mSerial ? 1 : mSites.size()) << ", "
+              << "RunTime:"           << mRunTime     << ", "
+              << "Deliveries:"        << deliveries   << ", "
+              << "MeanWaitTime:"      << std::fixed << std::setprecision(2) << meanWaitTime << ", "
+              << "TrucksTransferred:" << transferred  << ", "
+              << "InTransit:"         << mInTransit   << ", "
+              << "WallMs:"            << std::setprecision(1) << wallMs << std::endl;
+}
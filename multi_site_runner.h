@@ -0,0 +1,114 @@
+#ifndef MULTI_SITE_RUNNER_H
+#define MULTI_SITE_RUNNER_H
+
+#include "service_include.h"
+#include "config.h"
+#include "mining_controller.h"
+#include "spsc_queue.h"
+#include "worker_pool.h"
+
+#include <atomic>
+#include <deque>
+#include <chrono>
+
+namespace Lunar {
+
+    // trucks that arrive at a site from the site they were transferred from
+    struct SiteEvent {
+        unsigned long minute {0};       // arrival at the receiving site
+        int           source {0};
+        unsigned long seq    {0};       // per source, same-minute events keep their order
+        int           trucks {0};
+
+        bool operator>(const SiteEvent &other) const {
+            if(minute != other.minute) {
+                return minute > other.minute;
+            }
+            return (source != other.source) ? (source > other.source) : (seq > other.seq);
+        }
+    };
+
+    // scripted transfer of trucks from a site to another one
+    struct SiteTransfer {
+        unsigned long minute {0};
+        int           to     {0};
+        int           trucks {0};
+    };
+
+    // haul route from one site to another, its drive time is the lookahead of the events on it
+    struct SiteChannel {
+        int                    from      {0};
+        int                    to        {0};
+        long                   lookahead {0};
+        SpscQueue<SiteEvent, MULTI_SITE_CHANNEL_EVENTS> queue;
+        std::deque<SiteEvent>  overflow  {};    // producer side, events that didn't fit into the queue yet
+    };
+
+    // logical process of a site, it is advanced by one thread at a time
+    struct SiteProcess {
+        static constexpr unsigned long DONE {std::numeric_limits<unsigned long>::max()};
+
+        int                                index        {0};
+        std::string                        name         {};
+        std::unique_ptr<Config>            cfg          {};
+        std::unique_ptr<MiningController>  ctrl         {};
+        std::vector<SiteTransfer>          transfers    {};     // ordered by minute
+        size_t                             nextTransfer {0};
+        std::map<std::string, int>         transferring {};     // truck id -> receiving site
+        std::vector<SiteChannel *>         inChannels   {};
+        std::map<int, SiteChannel *>       outChannels  {};     // by receiving site
+        std::vector<SiteEvent>             pending      {};     // received events, min-heap
+        unsigned long                      seq          {0};
+        bool                               done         {false};
+        long                               trucksIn     {0};
+        long                               trucksOut    {0};
+        long                               blockedPolls {0};
+
+        // last minute whose events are in the queues, the other sites may simulate up to it plus the lookahead
+        alignas(64) std::atomic<unsigned long> published {0};
+    };
+
+    /**
+     * @brief Multi-site mode (MULTI_SITE_FILE), every site is a MiningController with its own config,
+     *          the sites exchange transferred trucks over haul routes.
+     *          The sites run as logical processes on their own threads and synchronize conservatively:
+     *          a site simulates the next minute once every site with a route to it has published a minute
+     *          that is at most one drive time earlier, so no truck can arrive in the past; there is no global barrier.
+     *          The events go through lock-free single-producer single-consumer queues, one per route,
+     *          and are applied in the order of minute, sending site and sequence, so the results don't depend on the threads.
+     */
+    class MultiSiteRunner
+    {
+        public:
+            MultiSiteRunner(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~MultiSiteRunner() {}
+
+            ServiceStatus run();
+
+        protected:
+            Config *mCfg {nullptr};
+
+            ServiceStatus load        (const std::string &path);
+            ServiceStatus initSites   ();
+            void runParallel          ();
+            void runSerial            ();
+            bool advance              (SiteProcess &site);
+            void receive              (SiteProcess &site);
+            bool flush                (SiteProcess &site);
+            void startTransfer        (SiteProcess &site, const SiteTransfer &transfer);
+            void send                 (SiteProcess &site, int to, unsigned long minute);
+            int  siteIndex            (const std::string &name);
+            void generateSummary      (std::chrono::steady_clock::duration wallTime);
+
+        private:
+            std::vector<std::unique_ptr<SiteProcess>> mSites;
+            std::vector<std::unique_ptr<SiteChannel>> mChannels;
+            long               mRunTime   {0};
+            bool               mSerial    {false};
+            std::atomic<long>  mInTransit {0};      // arrivals after the end of the run
+    };
+}
+
+#endif // MULTI_SITE_RUNNER_H
@@ -0,0 +1,64 @@
+#include "queue_estimator.h"
+
+namespace {
+    // the simulation runs in whole minutes: a bay is released on the tick after the unloading is done
+    // and the truck finishes its delivery on the tick after the release
+    constexpr double BAY_RELEASE_MINUTES {1.0};
+    constexpr double DELIVERY_MINUTES    {1.0};
+}
+
+/**
+ * @brief Solve the closed network of the truck cycle by Mean Value Analysis
+ *          The throughput is bounded by the bays (numOfBays / unload time),
+ *          the wait grows without bound once the fleet saturates the bays.
+ *          No deliveries are done before the first truck reaches the stations (startUpTime)
+ *
+ * @param model
+ * @return Lunar::QueueEstimate
+ */
+Lunar::QueueEstimate
+Lunar::QueueEstimator::estimate(const QueueModel &model)
+{
+    QueueEstimate est;
+
+    if(model.numOfTrucks < 1 || model.numOfBays < 1 || model.unloadTime <= 0.0) {
+        return est;
+    }
+
+    // Seidmann: c bays as one fast server plus the rest of the bay time as delay
+    double bays    = model.numOfBays;
+    double bayTime = model.unloadTime + BAY_RELEASE_MINUTES;
+    double demand  = bayTime / bays;
+    double delay   = bayTime - demand;
+    double think   = model.loadingTime + model.driveTime + DELIVERY_MINUTES + delay;
+
+    double queue      {0.0};
+    double response   {demand};
+    double throughput {0.0};
+    for (int n {1}; n <= model.numOfTrucks; n++) {
+        response   = demand * (1.0 + queue);
+        throughput = n / (think + response);
+        queue      = throughput * response;
+    }
+
+    // the wait is measured like the summary does, from the arrival at the stations to the delivery
+    est.offeredLoad       = model.numOfTrucks * bayTime / (bays * (think + demand));
+    est.utilization       = std::min(1.0, throughput * bayTime / bays);
+    est.meanWaitTime      = response + delay + DELIVERY_MINUTES;
+    est.deliveriesPerHour = throughput * 60.0;
+    est.deliveries        = static_cast<long>(throughput * std::max(0.0, model.runTime - model.startUpTime));
+
+    return est;
+}
+
+/**
+ * @brief Mean of the loading-time distribution, uniform over
+ *          LOADING_TIME_MIN_HOURS..LOADING_TIME_MAX_HOURS whole hours
+ *
+ * @return double minutes
+ */
+double
+Lunar::QueueEstimator::meanLoadingTime()
+{
+    return hourToMinutes(LOADING_TIME_MIN_HOURS + LOADING_TIME_MAX_HOURS) / 2.0;
+}
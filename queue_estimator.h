@@ -0,0 +1,44 @@
+#ifndef QUEUE_ESTIMATOR_H
+#define QUEUE_ESTIMATOR_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    // Mean times of the truck cycle and the size of the fleet, the input of the analytic estimate
+    struct QueueModel {
+        int    numOfTrucks {0};
+        int    numOfBays   {0};        // unload bays over all open stations
+        double loadingTime {0.0};      // mean loading minutes
+        double driveTime   {0.0};      // mean minutes from loading to the station queue
+        double unloadTime  {0.0};      // mean unload minutes
+        double startUpTime {0.0};      // minutes until the first truck reaches the stations
+        long   runTime     {0};        // simulated minutes
+    };
+
+    // Analytic estimate of a configuration
+    struct QueueEstimate {
+        double offeredLoad       {0.0};    // unload demand of the fleet / bay capacity, > 1 saturates the bays
+        double utilization       {0.0};    // busy fraction of the unload bays
+        double meanWaitTime      {0.0};    // minutes from the arrival at the stations to the delivery
+        double deliveriesPerHour {0.0};    // fleet throughput
+        long   deliveries        {0};      // expected deliveries over the run time
+    };
+
+    /**
+     * @brief Instant estimate of station utilization, queue wait and fleet throughput
+     *          The fleet is a closed queueing network: every truck cycles through loading and driving
+     *          (delay stations) and one shared queue in front of all unload bays (multi-server station).
+     *          It is solved by exact Mean Value Analysis over the fleet size,
+     *          the c bays are approximated by a single server with 1/c of the unload time
+     *          plus a delay of (c-1)/c of the unload time (Seidmann), so the cost is O(trucks)
+     */
+    class QueueEstimator
+    {
+        public:
+            static QueueEstimate estimate(const QueueModel &model);
+            static double meanLoadingTime();
+    };
+}
+
+#endif // QUEUE_ESTIMATOR_H
@@ -0,0 +1,65 @@
+#ifndef REPLICATION_STATS_H
+#define REPLICATION_STATS_H
+
+#include "service_include.h"
+#include <cmath>
+
+namespace Lunar {
+
+    /**
+     * @brief Mean, variance and 95% confidence interval of a KPI over independent replications,
+     *          updated one replication at a time (Welford), so the runner can stop once the interval is narrow enough
+     */
+    struct RunningStat {
+        long   count {0};
+        double mean  {0.0};
+        double m2    {0.0};     // sum of squared deviations from the mean
+
+        void add(double val)
+        {
+            count++;
+            double delta = val - mean;
+            mean += delta / count;
+            m2   += delta * (val - mean);
+        }
+
+        double variance() const
+        {
+            return (count > 1) ? m2 / (count - 1) : 0.0;
+        }
+
+        /**
+         * @brief Half-width of the 95% confidence interval of the mean (Student t),
+         *          infinite with less than 2 replications
+         */
+        double halfWidth() const
+        {
+            if(count < 2) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return studentT95(count - 1) * std::sqrt(variance() / count);
+        }
+
+        /**
+         * @brief Two-sided 95% quantile of the Student t distribution
+         */
+        static double studentT95(long dof)
+        {
+            static const double quantile[] {
+                12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+            const long size = sizeof(quantile) / sizeof(quantile[0]);
+
+            if(dof < 1) {
+                return std::numeric_limits<double>::infinity();
+            }
+            if(dof <= size) {
+                return quantile[dof - 1];
+            }
+            return (dof < 40) ? 2.042 : (dof < 60) ? 2.021 : (dof < 120) ? 2.000 : 1.980;
+        }
+    };
+}
+
+#endif // REPLICATION_STATS_H
@@ -0,0 +1,255 @@
+#include "result_cache.h"
+
+#include <filesystem>
+#include <set>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    // params that don't change the simulated results
+    const std::set<Lunar::ServiceParams> IgnoredParams {
+        Lunar::ServiceParams::PROCESS_SPEED_UP_BY,
+        Lunar::ServiceParams::VERIFY_MODE,
+        Lunar::ServiceParams::VERIFY_ENGINE,
+        Lunar::ServiceParams::GOLDEN_TRACE_FILE,
+        Lunar::ServiceParams::PROFILE_JSON_FILE,
+        Lunar::ServiceParams::TRACE_EVENT_FILE,
+        Lunar::ServiceParams::SWEEP_TRUCKS,
+        Lunar::ServiceParams::SWEEP_STATIONS,
+        Lunar::ServiceParams::SWEEP_REPLICATIONS,
+        Lunar::ServiceParams::SWEEP_MIN_LOAD_PERCENT,
+        Lunar::ServiceParams::SWEEP_MAX_LOAD_PERCENT,
+        Lunar::ServiceParams::SWEEP_CI_PERCENT,
+        Lunar::ServiceParams::SWEEP_MAX_REPLICATIONS,
+        Lunar::ServiceParams::SWEEP_COMMON_RANDOM_NUMBERS,
+        Lunar::ServiceParams::OPTIMIZE_DELIVERIES_PER_HOUR,
+        Lunar::ServiceParams::OPTIMIZE_MAX_WAIT_MINUTES,
+        Lunar::ServiceParams::DAEMON_SOCKET,
+        Lunar::ServiceParams::DAEMON_WORKERS,
+        Lunar::ServiceParams::RESULT_CACHE_DIR,
+        Lunar::ServiceParams::MULTI_SITE_FILE,
+        Lunar::ServiceParams::MULTI_SITE_SERIAL,
+        Lunar::ServiceParams::WORKER_PINNING,
+        Lunar::ServiceParams::MEMORY_REPORT_MINUTES,
+        Lunar::ServiceParams::LIVE_SNAPSHOT_SHM,
+        Lunar::ServiceParams::TICK_REPORTS,
+        Lunar::ServiceParams::TIMELINE_PYRAMID_FILE,
+        Lunar::ServiceParams::TIMELINE_BUCKET_MINUTES
+    };
+
+    // params naming a file, the key covers the contents of the file
+    const std::set<Lunar::ServiceParams> FileParams {
+        Lunar::ServiceParams::SITE_FILE,
+        Lunar::ServiceParams::FLEET_EVENT_FILE
+    };
+
+    const char CACHE_MAGIC[8] {'L', 'U', 'N', 'A', 'R', 'R', 'C', '1'};
+
+    // layout of an entry: header, key text, summary
+    struct EntryHeader {
+        char     magic[8];
+        uint32_t engineVersion;
+        uint32_t summarySize;
+        uint64_t keyLength;
+    };
+
+    std::string paramName(Lunar::ServiceParams param)
+    {
+        for (auto *names : {&Lunar::ConfigParam, &Lunar::ConfigStringParam}) {
+            auto it = std::ranges::find_if(*names, [param] (auto &entry) { return entry.second == param; });
+            if(it != names->end()) {
+                return it->first;
+            }
+        }
+        return std::to_string(static_cast<int>(param));
+    }
+}
+
+/**
+ * @brief Use the directory for the cache, it is created if needed
+ *
+ * @param dir
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::ResultCache::open(const std::string &dir)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if(ec || std::filesystem::is_directory(dir) == false) {
+        std::cerr << "[CACHE-ERROR], Unable to create " << dir << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    mDir = dir;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Look up the summary of the run of the config
+ *
+ * @param cfg
+ * @param sum  set on a hit
+ * @return true on a hit
+ */
+bool
+Lunar::ResultCache::lookup(Config &cfg, MiningSummary &sum)
+{
+    if(isOpen() == false || isCacheable(cfg) == false) {
+        return false;
+    }
+
+    auto key = canonicalKey(cfg);
+    int  fd  = ::open(entryPath(hash(key)).c_str(), O_RDONLY);
+    if(fd < 0) {
+        mMisses++;
+        return false;
+    }
+
+    bool hit {false};
+    struct stat st {};
+    auto size = (fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+    if(size == sizeof(EntryHeader) + key.size() + sizeof(MiningSummary)) {
+        auto *data = static_cast<const char *>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+        if(data != MAP_FAILED) {
+            EntryHeader header;
+            std::memcpy(&header, data, sizeof(header));
+            hit = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+                && header.engineVersion == ENGINE_VERSION
+                && header.summarySize   == sizeof(MiningSummary)
+                && header.keyLength     == key.size()
+                && std::memcmp(data + sizeof(header), key.data(), key.size()) == 0;
+            if(hit) {
+                std::memcpy(&sum, data + sizeof(header) + key.size(), sizeof(MiningSummary));
+            }
+            munmap(const_cast<char *>(data), size);
+        }
+    }
+    close(fd);
+
+    hit ? mHits++ : mMisses++;
+    return hit;
+}
+
+/**
+ * @brief Store the summary of the run of the config, an existing entry is replaced atomically
+ *
+ * @param cfg
+ * @param sum
+ */
+void
+Lunar::ResultCache::store(Config &cfg, const MiningSummary &sum)
+{
+    if(isOpen() == false || isCacheable(cfg) == false) {
+        return;
+    }
+
+    auto key  = canonicalKey(cfg);
+    auto path = entryPath(hash(key));
+
+    EntryHeader header {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.engineVersion = ENGINE_VERSION;
+    header.summarySize   = sizeof(MiningSummary);
+    header.keyLength     = key.size();
+
+    // unique per process and thread, the rename publishes the complete entry
+    std::stringstream tmp;
+    tmp << path << "." << getpid() << "." << std::this_thread::get_id() << ".tmp";
+
+    std::ofstream out(tmp.str(), std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(key.data(), key.size());
+    out.write(reinterpret_cast<const char *>(&sum), sizeof(sum));
+    out.close();
+
+    if(out.fail() || std::rename(tmp.str().c_str(), path.c_str()) != 0) {
+        std::cerr << "[CACHE-ERROR], Unable to write " << path << std::endl;
+        std::remove(tmp.str().c_str());
+    }
+}
+
+/**
+ * @brief Canonical text of the params that affect the results, ordered by the param,
+ *          files are represented by the hash of their contents
+ *
+ * @param cfg
+ * @return std::string
+ */
+std::string
+Lunar::ResultCache::canonicalKey(Config &cfg)
+{
+    std::stringstream ss;
+    ss << "ENGINE_VERSION=" << ENGINE_VERSION << "\n";
+
+    for (auto &[param, value] : cfg.intParams()) {
+        if(IgnoredParams.contains(param) == false) {
+            ss << paramName(param) << "=" << value << "\n";
+        }
+    }
+
+    for (auto &[param, value] : cfg.stringParams()) {
+        if(IgnoredParams.contains(param)) {
+            continue;
+        }
+        if(FileParams.contains(param)) {
+            std::ifstream file(value, std::ios::binary);
+            std::stringstream content;
+            content << file.rdbuf();
+            ss << paramName(param) << "#" << std::hex << hash(content.str()) << std::dec << "\n";
+        }
+        else {
+            ss << paramName(param) << "=" << value << "\n";
+        }
+    }
+
+    return ss.str();
+}
+
+/**
+ * @brief 64-bit FNV-1a hash
+ *
+ * @param text
+ * @return uint64_t
+ */
+uint64_t
+Lunar::ResultCache::hash(const std::string &text)
+{
+    uint64_t h {0xCBF29CE484222325ULL};
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Path of the entry of a key hash
+ *
+ * @param keyHash
+ * @return std::string
+ */
+std::string
+Lunar::ResultCache::entryPath(uint64_t keyHash)
+{
+    std::stringstream ss;
+    ss << mDir << "/" << std::hex << std::setw(16) << std::setfill('0') << keyHash << ".res";
+    return ss.str();
+}
+
+/**
+ * @brief Only seeded runs are reproducible.
+ *          The trace-event file is only written by the normal (reporting) run, which doesn't use the cache
+ *
+ * @param cfg
+ * @return true
+ * @return false
+ */
+bool
+Lunar::ResultCache::isCacheable(Config &cfg)
+{
+    return cfg.rngSeed() >= 0;
+}
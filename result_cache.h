@@ -0,0 +1,48 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "service_include.h"
+#include "config.h"
+#include "simulation_engine.h"
+
+#include <atomic>
+
+namespace Lunar {
+
+    /**
+     * @brief Content-addressed on-disk cache of run summaries (RESULT_CACHE_DIR)
+     *
+     *          The key is the canonical text of the config-params that affect the results, the contents of the
+     *          site- and fleet-event-file, ENGINE_VERSION and the seed. An entry is one file named by the hash of the key,
+     *          it repeats the key, so a hash collision is a miss. Entries are written to a temporary file and renamed,
+     *          so parallel runners never see a partial entry and lookups map the file read-only.
+     *          Unseeded runs and runs with a trace-event file are not cached.
+     */
+    class ResultCache
+    {
+        public:
+            ResultCache() {}
+            virtual ~ResultCache() {}
+
+            ServiceStatus open   (const std::string &dir);
+            bool          isOpen () const { return mDir.empty() == false; }
+            bool          lookup (Config &cfg, MiningSummary &sum);
+            void          store  (Config &cfg, const MiningSummary &sum);
+
+            long hits  () const { return mHits;   }
+            long misses() const { return mMisses; }
+
+            static std::string canonicalKey(Config &cfg);
+            static uint64_t    hash        (const std::string &text);
+
+        protected:
+            std::string mDir {};
+            std::atomic<long> mHits   {0};
+            std::atomic<long> mMisses {0};
+
+            std::string entryPath(uint64_t keyHash);
+            static bool isCacheable(Config &cfg);
+    };
+}
+
+#endif // RESULT_CACHE_H
@@ -10,26 +10,71 @@
 #include <algorithm>
 #include <ranges>
 #include <list>
+#include <deque>
+#include <memory_resource>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <limits>
 #include <thread>
 #include <random>
+#include <cstdint>
 #include <ctime>
 #include <csignal>
 #include <cctype>
+#include <charconv>
+#include <type_traits>
 
 
 namespace Lunar {
 
     // Default Parameters
 
-    const int           LOADING_TIME_MIN_HOURS{1};                // hour
-    const int           LOADING_TIME_MAX_HOURS{5};                // hour
-    const int           DRIVE_TIME_MINUTES    {30};               // 30 min
-    const int           UNLOAD_TIME_MINUTES   {5};                // 5 min
+    constexpr int       LOADING_TIME_MIN_HOURS{1};                // hour
+    constexpr int       LOADING_TIME_MAX_HOURS{5};                // hour
+    constexpr int       DRIVE_TIME_MINUTES    {30};               // 30 min
+    constexpr int       UNLOAD_TIME_MINUTES   {5};                // 5 min
+    constexpr int       UNLOAD_STATION_BAYS   {1};                // trucks a station unloads at once
     const std::string   CONFIG_FILE           {"../mining.cfg"};  // default config-file
     const char          CONFIG_COMMENT_TAGE   {'#'};              // default comment tage for config-file
     const char          CONFIG_DELIMITER      {'='};              // default delimiter for config-file
+    const char          FLEET_EVENT_DELIMITER {';'};              // delimiter of the fleet event-file "minute;action;target"
+    const int           FLEET_EVENT_MAX_COUNT {10000};            // trucks/stations added by one fleet event or moved by one transfer
+    const char          SITE_FILE_DELIMITER   {';'};              // delimiter of the site-file "class;..." and "site;..."
+    const int           SITE_MAX_PAYLOAD      {100000};           // tons of a truck class
+    const int           SITE_MAX_SPEED_PERCENT{1000};             // speed-percent of a truck class
+    const int           SITE_MAX_MINUTES      {7 * 24 * 60};      // unload minutes of a class and drive minutes of a site
+    const int           SITE_MAX_CLASS_WEIGHT {1000};             // a class with weight w takes w slots of the class cycle
+    constexpr int       TRUCK_SPEED_PERCENT   {100};              // speed of a truck relative to DRIVE_TIME_MINUTES
+    const int           BATCH_ASSIGNMENT_BUDGET_US{500};          // time budget of the batch-assignment solver per tick
+    const long          BATCH_ASSIGNMENT_MAX_CELLS{1L << 20};     // larger cost matrices fall back to greedy assignment
+    const int           DEFAULT_RNG_SEED      {1};                // seed of the verification mode if RNG_SEED is not set
+    const std::string   GOLDEN_TRACE_FILE     {"../golden.trace"};// default golden trace of the verification mode
+    const int           VERIFY_CONTEXT_MINUTES{3};                // minutes printed before the first divergence
+    const int           SWEEP_REPLICATIONS    {3};                // seeded runs per sweep configuration
+    const int           SWEEP_MIN_LOAD_PERCENT{25};               // below: over-provisioned, run once
+    const int           SWEEP_MAX_LOAD_PERCENT{150};              // above: saturated, skipped
+    const int           SWEEP_MAX_REPLICATIONS{30};               // cap of the sequential stopping
+    const int           SWEEP_MAX_TRUCKS      {100000};           // limits of the SWEEP_TRUCKS/SWEEP_STATIONS counts
+    const int           SWEEP_MAX_STATIONS    {1000};
+    const int           OPTIMIZE_MAX_STATIONS {1000};             // search limits of the capacity optimizer
+    const int           OPTIMIZE_MAX_TRUCKS   {100000};
+    const int           DAEMON_POLL_MS        {200};              // the daemon checks for a stop request at least this often
+    const int           DAEMON_READ_BYTES     {4096};
+    const size_t        DAEMON_MAX_REQUEST_BYTES{1 << 16};        // longer request lines close the connection
+    const long          DAEMON_CANCEL_CHECK_MINUTES{60};          // simulated minutes between the cancellation checks of a job
+    const int           DAEMON_MAX_TRUCKS     {100000};           // limits of a scenario request, larger ones are invalid
+    const int           DAEMON_MAX_STATIONS   {1000};
+    const int           DAEMON_MAX_HOURS      {24 * 365};
+    const uint32_t      ENGINE_VERSION        {4};                // bump it with every change of the simulated results,
+                                                                  // it invalidates the result cache
+    const char          MULTI_SITE_DELIMITER  {';'};              // delimiter of the multi-site file "site;...", "route;..." and "transfer;..."
+    const size_t        MULTI_SITE_CHANNEL_EVENTS{1024};          // capacity of the event queue between two sites, a power of two
+    const int           LIVE_SNAPSHOT_SPARE_ENTITIES{256};        // live snapshot capacity: twice the initial trucks/stations plus spare
+    const int           LIVE_SNAPSHOT_READ_RETRIES{1000};         // reader retries while the writer updates the snapshot
+    const unsigned long TIMELINE_PYRAMID_FAN_OUT{4};              // buckets of a timeline level merged into one bucket of the next level
+    const unsigned long TIMELINE_PYRAMID_TOP_BUCKETS{256};        // buckets of the coarsest timeline level at most
+    const size_t        TIMELINE_PYRAMID_MAX_LEVELS{16};
 
     static int          SIMULATION_TIME_HOURS {72};               // to speed up the simulation "decrease" SIMULATION_TIME_HOURS
                                                                   // or update the param SIMULATION_TIME_HOURS in mining.cfg
@@ -39,9 +84,11 @@ namespace Lunar {
 
     struct TruckUnloadingInfo {
         std::string   trkId      {};
+        int           trkIdx     {-1};
         unsigned long arrivalTime{0};
         unsigned int  startTime  {0};
         bool          isDone     {false};
+        int           unloadTime {UNLOAD_TIME_MINUTES};
     };
 
     enum class TruckState {
@@ -61,12 +108,81 @@ namespace Lunar {
         COUNT
     };
 
+    enum class SchedulingPolicy {
+        GREEDY = 0,
+        BATCH_ASSIGNMENT,
+        COUNT
+    };
+
+    enum class EngineType {
+        REFERENCE = 0,
+        FIXED,                  // compile-time specialized engine of the fixed layouts
+        COROUTINE,              // truck cycles as coroutines on an event scheduler
+        COUNT
+    };
+
+    enum class PinningPolicy {
+        NONE = 0,               // workers are left to the OS scheduler
+        COMPACT,                // fill the cores of one NUMA node before the next one
+        SCATTER,                // spread the workers round-robin over the NUMA nodes
+        COUNT
+    };
+
+    enum class MemorySubsystem {
+        TRUCKS = 0,             // truck storage of the slot map
+        STATIONS,               // unload-station storage of the slot map
+        STATION_QUEUES,         // queue nodes of the unload-stations (mTrucksWaiting)
+        WAIT_HISTORY,           // delivery logs of the trucks (mWaitTimeLst) and of the retired trucks
+        REPORTS,                // summaries of the retired trucks kept for the report
+        COUNT
+    };
+
+    enum class VerifyMode {
+        OFF = 0,
+        RECORD_GOLDEN,
+        VERIFY_GOLDEN,
+        SIDE_BY_SIDE,
+        COUNT
+    };
+
+    enum class FleetAction {
+        ADD_TRUCK = 0,
+        RETIRE_TRUCK,
+        OPEN_STATION,
+        CLOSE_STATION,
+        COUNT
+    };
+
+    // Scripted change of the fleet at a simulated minute,
+    // the target is a count for ADD_TRUCK/OPEN_STATION and an id for RETIRE_TRUCK/CLOSE_STATION
+    struct FleetEvent {
+        unsigned long minute {0};
+        FleetAction   action {FleetAction::ADD_TRUCK};
+        std::string   target {};    // truck/station id of RETIRE_TRUCK/CLOSE_STATION
+        int           count  {0};   // trucks/stations of ADD_TRUCK/OPEN_STATION, checked when the event is loaded
+    };
+
     enum ServiceStatus {
         ERROR   = -1,
         UNKNOWN = 0,
         SUCESS  = 1,
     };
 
+    // Attributes of a truck class, trucks are assigned to the classes by weight
+    struct TruckClass {
+        std::string name          {"default"};
+        int         payload       {0};                        // tons per delivery
+        int         speedPercent  {TRUCK_SPEED_PERCENT};      // drive times are scaled by 100/speedPercent
+        int         unloadMinutes {UNLOAD_TIME_MINUTES};
+        int         weight        {1};
+    };
+
+    struct TruckDeliveryLog {
+        int         stationIdx {0};
+        int         waitTime   {0};
+        long        doneTime   {0};     // minute the delivery was done
+    };
+
     struct TruckLog {
         std::string mId         {};
         int         mLoadingTime{0};
@@ -79,13 +195,99 @@ namespace Lunar {
         UNLOAD_STATION,
         PROCESS_SPEED_UP_BY,
         SIMULATION_TIME_HOURS,
+        SCHEDULING_POLICY,
+        BATCH_ASSIGNMENT_BUDGET_US,
+        RNG_SEED,
+        VERIFY_MODE,
+        VERIFY_ENGINE,
+        GOLDEN_TRACE_FILE,
+        PROFILE_JSON_FILE,
+        TRACE_EVENT_FILE,
+        FLEET_EVENT_FILE,
+        UNLOAD_STATION_BAYS,
+        SITE_FILE,
+        SWEEP_TRUCKS,
+        SWEEP_STATIONS,
+        SWEEP_REPLICATIONS,
+        SWEEP_MIN_LOAD_PERCENT,
+        SWEEP_MAX_LOAD_PERCENT,
+        SWEEP_CI_PERCENT,
+        SWEEP_MAX_REPLICATIONS,
+        WARMUP_DETECTION,
+        SWEEP_COMMON_RANDOM_NUMBERS,
+        OPTIMIZE_DELIVERIES_PER_HOUR,
+        OPTIMIZE_MAX_WAIT_MINUTES,
+        DAEMON_SOCKET,
+        DAEMON_WORKERS,
+        RESULT_CACHE_DIR,
+        MULTI_SITE_FILE,
+        MULTI_SITE_SERIAL,
+        WORKER_PINNING,
+        MEMORY_REPORT_MINUTES,
+        LIVE_SNAPSHOT_SHM,
+        TICK_REPORTS,
+        TIMELINE_PYRAMID_FILE,
+        TIMELINE_BUCKET_MINUTES,
+        STATION_ASSIGNMENT_COST,
         COUNT };
 
     const static std::map<std::string, ServiceParams> ConfigParam {
         {"TRUCKS",              ServiceParams::TRUCK},
         {"UNLOAD_STATIONS",     ServiceParams::UNLOAD_STATION},
         {"PROCESS_SPEED_UP_BY", ServiceParams::PROCESS_SPEED_UP_BY},
-        {"SIMULATION_TIME_HOURS",ServiceParams::SIMULATION_TIME_HOURS}
+        {"SIMULATION_TIME_HOURS",ServiceParams::SIMULATION_TIME_HOURS},
+        {"SCHEDULING_POLICY",   ServiceParams::SCHEDULING_POLICY},
+        {"BATCH_ASSIGNMENT_BUDGET_US", ServiceParams::BATCH_ASSIGNMENT_BUDGET_US},
+        {"RNG_SEED",            ServiceParams::RNG_SEED},
+        {"VERIFY_MODE",         ServiceParams::VERIFY_MODE},
+        {"VERIFY_ENGINE",       ServiceParams::VERIFY_ENGINE},
+        {"SWEEP_REPLICATIONS",  ServiceParams::SWEEP_REPLICATIONS},
+        {"SWEEP_MIN_LOAD_PERCENT", ServiceParams::SWEEP_MIN_LOAD_PERCENT},
+        {"SWEEP_MAX_LOAD_PERCENT", ServiceParams::SWEEP_MAX_LOAD_PERCENT},
+        {"SWEEP_CI_PERCENT",    ServiceParams::SWEEP_CI_PERCENT},
+        {"SWEEP_MAX_REPLICATIONS", ServiceParams::SWEEP_MAX_REPLICATIONS},
+        {"WARMUP_DETECTION",    ServiceParams::WARMUP_DETECTION},
+        {"SWEEP_COMMON_RANDOM_NUMBERS", ServiceParams::SWEEP_COMMON_RANDOM_NUMBERS},
+        {"OPTIMIZE_DELIVERIES_PER_HOUR", ServiceParams::OPTIMIZE_DELIVERIES_PER_HOUR},
+        {"OPTIMIZE_MAX_WAIT_MINUTES",    ServiceParams::OPTIMIZE_MAX_WAIT_MINUTES},
+        {"DAEMON_WORKERS",      ServiceParams::DAEMON_WORKERS},
+        {"MULTI_SITE_SERIAL",   ServiceParams::MULTI_SITE_SERIAL},
+        {"WORKER_PINNING",      ServiceParams::WORKER_PINNING},
+        {"MEMORY_REPORT_MINUTES", ServiceParams::MEMORY_REPORT_MINUTES},
+        {"TICK_REPORTS",        ServiceParams::TICK_REPORTS},
+        {"TIMELINE_BUCKET_MINUTES", ServiceParams::TIMELINE_BUCKET_MINUTES}
+    };
+
+    const static std::map<std::string, ServiceParams> ConfigStringParam {
+        {"GOLDEN_TRACE_FILE",   ServiceParams::GOLDEN_TRACE_FILE},
+        {"PROFILE_JSON_FILE",   ServiceParams::PROFILE_JSON_FILE},
+        {"TRACE_EVENT_FILE",    ServiceParams::TRACE_EVENT_FILE},
+        {"FLEET_EVENT_FILE",    ServiceParams::FLEET_EVENT_FILE},
+        {"UNLOAD_STATION_BAYS", ServiceParams::UNLOAD_STATION_BAYS},
+        {"STATION_ASSIGNMENT_COST", ServiceParams::STATION_ASSIGNMENT_COST},
+        {"SITE_FILE",           ServiceParams::SITE_FILE},
+        {"SWEEP_TRUCKS",        ServiceParams::SWEEP_TRUCKS},
+        {"SWEEP_STATIONS",      ServiceParams::SWEEP_STATIONS},
+        {"DAEMON_SOCKET",       ServiceParams::DAEMON_SOCKET},
+        {"RESULT_CACHE_DIR",    ServiceParams::RESULT_CACHE_DIR},
+        {"MULTI_SITE_FILE",     ServiceParams::MULTI_SITE_FILE},
+        {"LIVE_SNAPSHOT_SHM",   ServiceParams::LIVE_SNAPSHOT_SHM},
+        {"TIMELINE_PYRAMID_FILE", ServiceParams::TIMELINE_PYRAMID_FILE}
+    };
+
+    const static std::map<std::string, FleetAction> FleetActionName {
+        {"ADD_TRUCK",           FleetAction::ADD_TRUCK},
+        {"RETIRE_TRUCK",        FleetAction::RETIRE_TRUCK},
+        {"OPEN_STATION",        FleetAction::OPEN_STATION},
+        {"CLOSE_STATION",       FleetAction::CLOSE_STATION}
+    };
+
+    const static std::map<MemorySubsystem, std::string> MemorySubsystemName {
+        {MemorySubsystem::TRUCKS,           "Trucks"},
+        {MemorySubsystem::STATIONS,         "Stations"},
+        {MemorySubsystem::STATION_QUEUES,   "StationQueues"},
+        {MemorySubsystem::WAIT_HISTORY,     "WaitHistory"},
+        {MemorySubsystem::REPORTS,          "Reports"}
     };
 
     const static std::map<TruckState, std::string> TruckStateName {
@@ -116,6 +318,37 @@ namespace Lunar {
         int randomNum = distrib(gen);
         return hourToMinutes(randomNum); // to minutes
     }
+
+    /**
+     * @brief Small counter-based random stream (SplitMix64 over key and counter),
+     *          16 bytes of state, so each truck can carry its own stream by value
+     */
+    struct RandomStream {
+        using result_type = uint64_t;
+
+        uint64_t key     {0};
+        uint64_t counter {0};
+
+        RandomStream() {}
+        RandomStream(uint64_t seed, uint64_t stream) :
+            key(mix(seed ^ mix(stream + 0x9E3779B97F4A7C15ULL))) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() { return mix(key + (++counter) * 0x9E3779B97F4A7C15ULL); }
+
+        static uint64_t mix(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+    };
+
+    static int generateLoadingTime(RandomStream &gen) {
+        std::uniform_int_distribution<> distrib(LOADING_TIME_MIN_HOURS, LOADING_TIME_MAX_HOURS);
+        return hourToMinutes(distrib(gen)); // to minutes
+    }
 }
 
 #endif // SERVICE_INCLUDE_H
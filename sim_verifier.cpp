@@ -0,0 +1,400 @@
+#include "sim_verifier.h"
+#include "mining_controller.h"
+#include "fixed_mining_engine.h"
+#include "coroutine_mining_engine.h"
+#include "result_cache.h"
+
+namespace {
+    /**
+     * @brief Split a trace line into its fields
+     *
+     * @param line
+     * @param delimiter
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> splitTrace(const std::string &line, char delimiter)
+    {
+        std::vector<std::string> tokens;
+        std::string token;
+        std::stringstream ss(line);
+        while (std::getline(ss, token, delimiter)) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+}
+
+/**
+ * @brief Run the verification mode selected in the config-file
+ *          1: record golden trace of the reference engine
+ *          2: verify the selected engine against the golden trace
+ *          3: run the reference engine and the selected engine side by side
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationVerifier::run()
+{
+    // verification runs are always seeded
+    mSeed = mCfg->rngSeed();
+    if(mSeed < 0) {
+        mSeed = Lunar::DEFAULT_RNG_SEED;
+        mCfg->set(ServiceParams::RNG_SEED, mSeed);
+    }
+
+    auto engine = mCfg->verifyEngine();
+    if(engine < 0 || engine >= static_cast<int>(EngineType::COUNT)) {
+        std::cerr << "[VERIFY-ERROR], Unknown engine:" << engine << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    switch (static_cast<VerifyMode>(mCfg->verifyMode()))
+    {
+        case VerifyMode::RECORD_GOLDEN:
+            return recordGolden(mCfg->goldenTraceFile());
+
+        case VerifyMode::VERIFY_GOLDEN:
+            return verifyGolden(mCfg->goldenTraceFile());
+
+        case VerifyMode::SIDE_BY_SIDE:
+            return compareEngines(static_cast<EngineType>(engine));
+
+        default:
+            std::cerr << "[VERIFY-ERROR], Unknown verification mode:" << mCfg->verifyMode() << std::endl;
+            break;
+    }
+
+    return ServiceStatus::ERROR;
+}
+
+/**
+ * @brief Run the reference engine and write its per-minute snapshots and summary as golden trace
+ *
+ * @param path
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationVerifier::recordGolden(const std::string &path)
+{
+    auto engine = createEngine(EngineType::REFERENCE);
+    if(engine == nullptr) {
+        return ServiceStatus::ERROR;
+    }
+
+    std::ofstream outputFile(path);
+    if(outputFile.is_open() == false) {
+        std::cerr << "[VERIFY-ERROR], Unable to open file " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    outputFile << traceHeader(*engine, mSeed, *mCfg) << "\n";
+    while (engine->clock() <= static_cast<unsigned long>(engine->runTime())) {
+        engine->step();
+        engine->snapshot(mSnap);
+        outputFile << formatSnapshot(mSnap) << "\n";
+    }
+    outputFile << formatSummary(engine->summary()) << std::endl;
+
+    std::cerr << "[VERIFY-INFO], Golden trace written to " << path << ", Minutes:" << engine->clock() << std::endl;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Run the selected engine and compare it minute by minute against the golden trace
+ *
+ * @param path
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationVerifier::verifyGolden(const std::string &path)
+{
+    auto engine = createEngine(static_cast<EngineType>(mCfg->verifyEngine()));
+    if(engine == nullptr) {
+        return ServiceStatus::ERROR;
+    }
+
+    std::ifstream inputFile(path);
+    if(inputFile.is_open() == false) {
+        std::cerr << "[VERIFY-ERROR], Unable to open file " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    // the header is every leading comment line
+    std::string expected, line;
+    while (inputFile.peek() == Lunar::CONFIG_COMMENT_TAGE && std::getline(inputFile, line)) {
+        expected += (expected.empty() ? "" : "\n") + line;
+    }
+
+    auto header = traceHeader(*engine, mSeed, *mCfg);
+    if(expected != header) {
+        auto expLines = splitTrace(expected, '\n');
+        auto actLines = splitTrace(header,   '\n');
+        std::cerr << "[VERIFY-ERROR], Golden trace was recorded with another configuration" << std::endl;
+        for (auto &l : expLines) {
+            if(std::ranges::find(actLines, l) == actLines.end()) { std::cerr << "\tGolden:" << l << std::endl; }
+        }
+        for (auto &l : actLines) {
+            if(std::ranges::find(expLines, l) == expLines.end()) { std::cerr << "\tActual:" << l << std::endl; }
+        }
+        return ServiceStatus::ERROR;
+    }
+
+    mContext.clear();
+    while (engine->clock() <= static_cast<unsigned long>(engine->runTime())) {
+        engine->step();
+        engine->snapshot(mSnap);
+
+        auto actual = formatSnapshot(mSnap);
+        if(std::getline(inputFile, expected).fail() || expected != actual) {
+            reportDivergence(expected, actual);
+            return ServiceStatus::ERROR;
+        }
+        addContext(actual);
+    }
+
+    auto actual = formatSummary(engine->summary());
+    if(std::getline(inputFile, expected).fail() || expected != actual) {
+        reportDivergence(expected, actual);
+        return ServiceStatus::ERROR;
+    }
+
+    std::cerr << "[VERIFY-INFO], Engine matches golden trace " << path << ", Minutes:" << engine->clock() << std::endl;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Run the reference engine and the candidate engine side by side,
+ *          compare them after every minute and stop at the first divergence
+ *
+ * @param candidate
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationVerifier::compareEngines(EngineType candidate)
+{
+    auto reference = createEngine(EngineType::REFERENCE);
+    auto engine    = createEngine(candidate);
+    if(reference == nullptr || engine == nullptr) {
+        return ServiceStatus::ERROR;
+    }
+
+    mContext.clear();
+    while (reference->clock() <= static_cast<unsigned long>(reference->runTime())) {
+        reference->step();
+        engine->step();
+
+        reference->snapshot(mSnap);
+        auto expected = formatSnapshot(mSnap);
+        engine->snapshot(mSnap);
+        auto actual   = formatSnapshot(mSnap);
+
+        if(expected != actual) {
+            reportDivergence(expected, actual);
+            return ServiceStatus::ERROR;
+        }
+        addContext(actual);
+    }
+
+    auto expected = formatSummary(reference->summary());
+    auto actual   = formatSummary(engine->summary());
+    if(expected != actual) {
+        reportDivergence(expected, actual);
+        return ServiceStatus::ERROR;
+    }
+
+    std::cerr << "[VERIFY-INFO], Engine:" << static_cast<int>(candidate)
+              << " matches the reference engine, Minutes:" << reference->clock() << std::endl;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Create an unpaced, quiet engine of the given type
+ *
+ * @param type
+ * @return std::unique_ptr<Lunar::SimulationEngine>
+ */
+std::unique_ptr<Lunar::SimulationEngine>
+Lunar::SimulationVerifier::createEngine(EngineType type)
+{
+    std::unique_ptr<SimulationEngine> engine;
+
+    switch (type)
+    {
+        case EngineType::REFERENCE: {
+            auto ctrl = std::make_unique<MiningController>(mCfg);
+            ctrl->setPaced(false);
+            ctrl->setReporting(false);
+            engine = std::move(ctrl);
+        }
+        break;
+
+        case EngineType::FIXED:
+            engine = createFixedEngine(mCfg);
+            if(engine == nullptr) {
+                std::cerr << "[VERIFY-ERROR], No fixed engine for Trucks:" << mCfg->numOfTrucks()
+                          << ", UnloadStations:" << mCfg->numOfUnloadStations() << std::endl;
+                return nullptr;
+            }
+            break;
+
+        case EngineType::COROUTINE:
+            engine = std::make_unique<CoroutineMiningEngine>(mCfg);
+            break;
+
+        default:
+            std::cerr << "[VERIFY-ERROR], Unknown engine:" << static_cast<int>(type) << std::endl;
+            return nullptr;
+    }
+
+    if(engine->init() != ServiceStatus::SUCESS) {
+        std::cerr << "[VERIFY-ERROR], Engine:" << static_cast<int>(type) << " init failed" << std::endl;
+        return nullptr;
+    }
+    engine->startServices();
+
+    return engine;
+}
+
+/**
+ * @brief Header of the trace, it ties the trace to the configuration,
+ *          the summary line is followed by the canonical config key of the result cache,
+ *          one "# PARAM=value" comment line per param that affects the results
+ *
+ * @param engine
+ * @param seed
+ * @param cfg
+ * @return std::string
+ */
+std::string
+Lunar::SimulationVerifier::traceHeader(SimulationEngine &engine, int seed, Config &cfg)
+{
+    auto sum = engine.summary();
+
+    std::stringstream ss;
+    ss << "# lunar-trace v2, Trucks:" << sum.numOfTrucks << ", UnloadStations:" << sum.numOfStations
+       << ", RunTime:" << sum.runTime << ", Seed:" << seed;
+
+    for (auto &line : splitTrace(ResultCache::canonicalKey(cfg), '\n')) {
+        ss << "\n" << Lunar::CONFIG_COMMENT_TAGE << " " << line;
+    }
+
+    return ss.rdbuf()->str();
+}
+
+/**
+ * @brief Format a snapshot as trace line "minute;deliveries;truck-states;station-queues"
+ *
+ * @param snap
+ * @return std::string
+ */
+std::string
+Lunar::SimulationVerifier::formatSnapshot(const EngineSnapshot &snap)
+{
+    std::stringstream ss;
+    ss << snap.minute << ";" << snap.deliveries << ";";
+
+    for (size_t i {0}; i < snap.truckStates.size(); i++) {
+        ss << (i ? "," : "") << static_cast<int>(snap.truckStates[i]);
+    }
+    ss << ";";
+
+    for (size_t i {0}; i < snap.stationQueues.size(); i++) {
+        ss << (i ? "," : "") << snap.stationQueues[i];
+    }
+
+    return ss.rdbuf()->str();
+}
+
+/**
+ * @brief Format the summary as trace line "summary;deliveries;total-wait-time"
+ *
+ * @param sum
+ * @return std::string
+ */
+std::string
+Lunar::SimulationVerifier::formatSummary(const MiningSummary &sum)
+{
+    std::stringstream ss;
+    ss << "summary;" << sum.deliveries << ";" << sum.totalWaitTime;
+
+    return ss.rdbuf()->str();
+}
+
+/**
+ * @brief Keep the last few matching minutes as context for a divergence report
+ *
+ * @param line
+ */
+void
+Lunar::SimulationVerifier::addContext(const std::string &line)
+{
+    mContext.push_back(line);
+    if(mContext.size() > static_cast<size_t>(Lunar::VERIFY_CONTEXT_MINUTES)) {
+        mContext.pop_front();
+    }
+}
+
+/**
+ * @brief Report the first divergence with the preceding minutes and the first differing field
+ *
+ * @param expected
+ * @param actual
+ */
+void
+Lunar::SimulationVerifier::reportDivergence(const std::string &expected, const std::string &actual)
+{
+    std::cerr << "[VERIFY-DIVERGENCE], " << std::endl;
+    for (auto &line : mContext) {
+        std::cerr << "\tMatched: " << line << std::endl;
+    }
+    std::cerr << "\tExpected:" << expected << std::endl
+              << "\tActual:  " << actual   << std::endl;
+
+    auto expFields = splitTrace(expected, ';');
+    auto actFields = splitTrace(actual,   ';');
+    if(expFields.size() != actFields.size()) {
+        std::cerr << "\tTrace lines have a different layout" << std::endl;
+        return;
+    }
+
+    for (size_t f {1}; f < expFields.size(); f++) {
+        if(expFields[f] == actFields[f]) {
+            continue;
+        }
+
+        // summary and deliveries are scalar fields
+        if(expFields[0] == "summary" || f == 1) {
+            std::cerr << "\tMinute:" << expFields[0] << ", Field:" << f
+                      << ", Expected:" << expFields[f] << ", Actual:" << actFields[f] << std::endl;
+            return;
+        }
+
+        auto exp = splitTrace(expFields[f], ',');
+        auto act = splitTrace(actFields[f], ',');
+        for (size_t i {0}; i < std::max(exp.size(), act.size()); i++) {
+            auto e = (i < exp.size()) ? exp[i] : "-";
+            auto a = (i < act.size()) ? act[i] : "-";
+            if(e == a) {
+                continue;
+            }
+
+            if(f == 2) {
+                // the golden trace may be corrupt, a field that is no state is printed as it is
+                auto name = [] (const std::string &val) -> std::string {
+                    int  state {-1};
+                    auto [end, ec] = std::from_chars(val.data(), val.data() + val.size(), state);
+                    auto it = (ec != std::errc() || end != val.data() + val.size()) ? TruckStateName.end()
+                                                                                    : TruckStateName.find(static_cast<TruckState>(state));
+                    return (it != TruckStateName.end()) ? it->second : val;
+                };
+                std::cerr << "\tMinute:" << expFields[0] << ", Truck_" << (i + 1)
+                          << ", Expected:" << name(e) << ", Actual:" << name(a) << std::endl;
+            }
+            else {
+                std::cerr << "\tMinute:" << expFields[0] << ", UnloadStation_" << (i + 1)
+                          << ", TrucksInQueue Expected:" << e << ", Actual:" << a << std::endl;
+            }
+            return;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef SIM_VERIFIER_H
+#define SIM_VERIFIER_H
+
+#include "service_include.h"
+#include "config.h"
+#include "simulation_engine.h"
+
+namespace Lunar {
+    class SimulationVerifier
+    {
+        public:
+            SimulationVerifier(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~SimulationVerifier() {}
+
+            ServiceStatus run           ();
+            ServiceStatus recordGolden  (const std::string &path);
+            ServiceStatus verifyGolden  (const std::string &path);
+            ServiceStatus compareEngines(EngineType candidate);
+
+        protected:
+            Config *mCfg {nullptr};
+
+            std::unique_ptr<SimulationEngine> createEngine(EngineType type);
+
+            static std::string traceHeader    (SimulationEngine &engine, int seed, Config &cfg);
+            static std::string formatSnapshot (const EngineSnapshot &snap);
+            static std::string formatSummary  (const MiningSummary &sum);
+
+            void addContext        (const std::string &line);
+            void reportDivergence  (const std::string &expected, const std::string &actual);
+
+        private:
+            int                    mSeed    {DEFAULT_RNG_SEED};
+            std::list<std::string> mContext {};
+            EngineSnapshot         mSnap    {};
+    };
+}
+
+#endif // SIM_VERIFIER_H
@@ -0,0 +1,733 @@
+#include "simulation_daemon.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+
+std::atomic<bool> Lunar::SimulationDaemon::sStopRequested {false};
+
+/**
+ * @brief Write one response line without blocking, a closed connection drops it.
+ *          A client that does not read its responses fills the socket buffer,
+ *          it is marked closed instead of blocking the workers on mLock
+ *
+ * @param line
+ * @return true
+ * @return false
+ */
+bool
+Lunar::DaemonClient::send(const std::string &line)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    if(open == false) {
+        return false;
+    }
+
+    auto msg  = line + "\n";
+    size_t sent {0};
+    while (sent < msg.size()) {
+        auto n = ::send(fd, msg.data() + sent, msg.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(n < 0 && errno == EINTR) {
+            continue;
+        }
+        // a short write leaves a partial line, the stream of the client is broken
+        if(n <= 0 || static_cast<size_t>(n) < msg.size() - sent) {
+            open = false;
+            return false;
+        }
+        sent += n;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Destroy the Lunar:: Simulation Daemon:: Simulation Daemon object
+ *
+ */
+Lunar::SimulationDaemon::~SimulationDaemon()
+{
+    stopWorkers();
+    closeSocket();
+}
+
+/**
+ * @brief Stop the daemon from a signal handler, it only sets an atomic flag
+ *
+ */
+void
+Lunar::SimulationDaemon::requestStop()
+{
+    sStopRequested = true;
+}
+
+/**
+ * @brief Start the warm worker pool and serve clients until requestStop()
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationDaemon::run()
+{
+    if(openSocket(mCfg->daemonSocket()) != ServiceStatus::SUCESS) {
+        return ServiceStatus::ERROR;
+    }
+
+    auto cacheDir = mCfg->resultCacheDir();
+    if(cacheDir.empty() == false && mCache.open(cacheDir) != ServiceStatus::SUCESS) {
+        closeSocket();
+        return ServiceStatus::ERROR;
+    }
+
+    auto numOfWorkers = mCfg->daemonWorkers();
+    if(numOfWorkers < 1) {
+        numOfWorkers = std::max(1, CpuTopology().numOfCpus());
+    }
+    startWorkers(numOfWorkers);
+
+    std::cerr << "[DAEMON-INFO], Socket:" << mSocketPath << ", Workers:" << numOfWorkers << std::endl;
+
+    while (sStopRequested == false) {
+        pollfd pfd {mListenFd, POLLIN, 0};
+        if(poll(&pfd, 1, DAEMON_POLL_MS) <= 0) {
+            continue;
+        }
+
+        int fd = accept(mListenFd, nullptr, nullptr);
+        if(fd < 0) {
+            continue;
+        }
+
+        // reap the readers of closed connections
+        std::erase_if(mClients, [] (ClientThread &ct) {
+            if(*ct.done == false) {
+                return false;
+            }
+            ct.thread.join();
+            return true;
+        });
+
+        auto client = std::make_shared<DaemonClient>();
+        client->fd  = fd;
+        auto done   = std::make_shared<std::atomic<bool>>(false);
+        mClients.push_back({std::thread([this, client, done] () { serveClient(client); *done = true; }), done});
+    }
+
+    std::cerr << "[DAEMON-INFO], Stopping" << std::endl;
+
+    for (auto &ct : mClients) {
+        ct.thread.join();
+    }
+    mClients.clear();
+
+    stopWorkers();
+    closeSocket();
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Bind and listen on the Unix domain socket, a stale socket file is replaced
+ *
+ * @param path
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SimulationDaemon::openSocket(const std::string &path)
+{
+    sockaddr_un addr {};
+    if(path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[DAEMON-ERROR], Invalid socket path:" << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    mListenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(mListenFd < 0) {
+        std::cerr << "[DAEMON-ERROR], Unable to create socket" << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    unlink(path.c_str());
+
+    if(bind(mListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || listen(mListenFd, SOMAXCONN) < 0) {
+        std::cerr << "[DAEMON-ERROR], Unable to listen on " << path << std::endl;
+        close(mListenFd);
+        mListenFd = -1;
+        return ServiceStatus::ERROR;
+    }
+
+    mSocketPath = path;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Close the listening socket and remove the socket file
+ *
+ */
+void
+Lunar::SimulationDaemon::closeSocket()
+{
+    if(mListenFd < 0) {
+        return;
+    }
+
+    close(mListenFd);
+    unlink(mSocketPath.c_str());
+    mListenFd = -1;
+}
+
+/**
+ * @brief Start the workers once, they are pinned by WORKER_PINNING if there are enough CPUs
+ *
+ * @param numOfWorkers
+ */
+void
+Lunar::SimulationDaemon::startWorkers(int numOfWorkers)
+{
+    auto cpus = CpuTopology().workerCpus(numOfWorkers, WorkerPool::pinningPolicy(*mCfg));
+
+    mStopWorkers = false;
+    for (int w {0}; w < numOfWorkers; w++) {
+        mWorkers.emplace_back(&SimulationDaemon::worker, this, cpus[w]);
+    }
+}
+
+/**
+ * @brief Let the workers finish their current job and join them, queued jobs are dropped
+ *
+ */
+void
+Lunar::SimulationDaemon::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopWorkers = true;
+    }
+    mJobReady.notify_all();
+
+    for (auto &w : mWorkers) {
+        w.join();
+    }
+    mWorkers.clear();
+}
+
+/**
+ * @brief Worker loop, it takes the job with the highest priority
+ *
+ * @param cpu -1: not pinned
+ */
+void
+Lunar::SimulationDaemon::worker(int cpu)
+{
+    // pinned before the first job, so the simulations are allocated on the node of the worker
+    CpuTopology::pinCurrentThread(cpu);
+
+    while (true) {
+        std::shared_ptr<DaemonJob> job;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mJobReady.wait(lock, [this] () { return mStopWorkers || mJobs.empty() == false; });
+            if(mStopWorkers) {
+                return;
+            }
+            job = mJobs.top();
+            mJobs.pop();
+        }
+
+        if(job->cancelled) {
+            job->client->send(formatStatus(job->id, "cancelled"));
+            continue;
+        }
+
+        runJob(*job);
+    }
+}
+
+/**
+ * @brief Read request lines of a client until it disconnects or the daemon stops
+ *
+ * @param client
+ */
+void
+Lunar::SimulationDaemon::serveClient(std::shared_ptr<DaemonClient> client)
+{
+    std::string buffer;
+    char chunk[DAEMON_READ_BYTES];
+
+    while (sStopRequested == false && client->open) {
+        pollfd pfd {client->fd, POLLIN, 0};
+        if(poll(&pfd, 1, DAEMON_POLL_MS) <= 0) {
+            continue;
+        }
+
+        auto n = read(client->fd, chunk, sizeof(chunk));
+        if(n <= 0) {
+            break;
+        }
+        buffer.append(chunk, n);
+
+        size_t end;
+        while ((end = buffer.find('\n')) != std::string::npos) {
+            auto line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            if(line.empty() == false) {
+                handleRequest(client, line);
+            }
+        }
+
+        if(buffer.size() > DAEMON_MAX_REQUEST_BYTES) {
+            client->send(formatStatus(0, "error", "request too long"));
+            break;
+        }
+    }
+
+    // nobody is left to receive the results
+    cancelClientJobs(*client);
+
+    std::lock_guard<std::mutex> lock(client->mLock);
+    client->open = false;
+    close(client->fd);
+}
+
+/**
+ * @brief Dispatch a scenario or a cancellation
+ *
+ * @param client
+ * @param line
+ */
+void
+Lunar::SimulationDaemon::handleRequest(const std::shared_ptr<DaemonClient> &client, const std::string &line)
+{
+    std::map<std::string, std::string> fields;
+    if(parseRequest(line, fields) == false) {
+        client->send(formatStatus(0, "error", "invalid request"));
+        return;
+    }
+
+    auto cancelIt = fields.find("cancel");
+    if(cancelIt != fields.end()) {
+        long id {0};
+        if(parseLong(cancelIt->second, 0, std::numeric_limits<long>::max(), id) == false) {
+            client->send(formatStatus(0, "error", "invalid cancel id"));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(client->mLock);
+        auto it = client->jobs.find(id);
+        auto job = (it != client->jobs.end()) ? it->second.lock() : nullptr;
+        if(job) {
+            job->cancelled = true;
+        }
+        return;
+    }
+
+    auto job      = std::make_shared<DaemonJob>();
+    job->client   = client;
+    job->accepted = std::chrono::steady_clock::now();
+    if(initScenario(*job, fields) == false) {
+        client->send(formatStatus(job->id, "error", "invalid scenario"));
+        return;
+    }
+
+    // the id is the cancel handle of the job, it is unique among the jobs of the client
+    auto duplicate = false;
+    {
+        std::lock_guard<std::mutex> lock(client->mLock);
+        std::erase_if(client->jobs, [] (auto &entry) { return entry.second.expired(); });
+        duplicate = (client->jobs.emplace(job->id, job).second == false);
+    }
+    if(duplicate) {
+        client->send(formatStatus(job->id, "error", "duplicate id"));
+        return;
+    }
+
+    submit(job);
+}
+
+/**
+ * @brief Queue a job for the workers
+ *
+ * @param job
+ */
+void
+Lunar::SimulationDaemon::submit(std::shared_ptr<DaemonJob> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        job->order = mOrder++;
+        mJobs.push(std::move(job));
+    }
+    mJobReady.notify_one();
+}
+
+/**
+ * @brief Cancel the queued and running jobs of a client
+ *
+ * @param client
+ */
+void
+Lunar::SimulationDaemon::cancelClientJobs(DaemonClient &client)
+{
+    std::lock_guard<std::mutex> lock(client.mLock);
+    for (auto &[id, weak] : client.jobs) {
+        if(auto job = weak.lock()) {
+            job->cancelled = true;
+        }
+    }
+    client.jobs.clear();
+}
+
+/**
+ * @brief Run the simulation of a job, the cancellation is checked between slices of the run
+ *
+ * @param job
+ */
+void
+Lunar::SimulationDaemon::runJob(DaemonJob &job)
+{
+    auto started = std::chrono::steady_clock::now();
+
+    // complete runs of repeated scenarios are answered from the result cache
+    Config cfg("");
+    if(job.minutes <= 0 && mCache.isOpen()) {
+        scenarioConfig(job, cfg);
+        MiningSummary sum;
+        if(mCache.lookup(cfg, sum)) {
+            LunarMiningResult res {};
+            res.minute             = sum.runTime + 1;
+            res.runTime            = sum.runTime;
+            res.numOfStations      = sum.numOfStations;
+            res.numOfTrucks        = sum.numOfTrucks;
+            res.deliveries         = sum.deliveries;
+            res.totalWaitTime      = sum.totalWaitTime;
+            res.meanWaitTime       = sum.meanWaitTime;
+            res.payload            = sum.payload;
+            res.warmUpTime         = sum.warmUpTime;
+            res.steadyDeliveries   = sum.steadyDeliveries;
+            res.steadyMeanWaitTime = sum.steadyMeanWaitTime;
+            sendDone(job, res, started, true);
+            return;
+        }
+    }
+
+    LunarMiningSimulation *sim {nullptr};
+    auto status = lunar_mining_create(&job.scenario, &sim);
+    if(status != LUNAR_MINING_OK) {
+        job.client->send(formatStatus(job.id, "error", (status == LUNAR_MINING_INVALID_ARGUMENT) ? "invalid scenario" : "init failed"));
+        return;
+    }
+
+    LunarMiningResult res {};
+    long slice = (job.progress > 0) ? job.progress : DAEMON_CANCEL_CHECK_MINUTES;
+    long ran   {0};
+    while (job.cancelled == false && lunar_mining_done(sim) == 0 && (job.minutes <= 0 || ran < job.minutes)) {
+        auto minutes = (job.minutes > 0) ? std::min(slice, job.minutes - ran) : slice;
+        auto n = lunar_mining_run(sim, minutes);
+        if(n <= 0) {
+            break;
+        }
+        ran += n;
+
+        if(job.progress > 0 && lunar_mining_done(sim) == 0) {
+            lunar_mining_result(sim, &res);
+            if(job.client->send(formatResult(job, "progress", res)) == false) {
+                job.cancelled = true;
+            }
+        }
+    }
+
+    if(job.cancelled) {
+        job.client->send(formatStatus(job.id, "cancelled"));
+    }
+    else {
+        lunar_mining_result(sim, &res);
+
+        // stored before the reply, so a client resubmitting the scenario right away hits the cache
+        if(job.minutes <= 0 && mCache.isOpen()) {
+            MiningSummary sum;
+            sum.runTime            = res.runTime;
+            sum.numOfStations      = res.numOfStations;
+            sum.numOfTrucks        = res.numOfTrucks;
+            sum.deliveries         = res.deliveries;
+            sum.totalWaitTime      = res.totalWaitTime;
+            sum.meanWaitTime       = res.meanWaitTime;
+            sum.payload            = res.payload;
+            sum.warmUpTime         = res.warmUpTime;
+            sum.steadyDeliveries   = res.steadyDeliveries;
+            sum.steadyMeanWaitTime = res.steadyMeanWaitTime;
+            mCache.store(cfg, sum);
+        }
+
+        sendDone(job, res, started, false);
+    }
+
+    lunar_mining_destroy(sim);
+}
+
+/**
+ * @brief Send the final result with the time the job spent queued and running
+ *
+ * @param job
+ * @param res
+ * @param started
+ * @param cached  the result was taken from the result cache
+ */
+void
+Lunar::SimulationDaemon::sendDone(DaemonJob &job, const LunarMiningResult &res,
+                                  std::chrono::steady_clock::time_point started, bool cached)
+{
+    auto line    = formatResult(job, "done", res);
+    auto queueUs = std::chrono::duration_cast<std::chrono::microseconds>(started - job.accepted).count();
+    auto runUs   = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+    line.insert(line.size() - 1, ",\"queueUs\":" + std::to_string(queueUs) + ",\"runUs\":" + std::to_string(runUs)
+                                 + (cached ? ",\"cached\":1" : ""));
+    job.client->send(line);
+}
+
+/**
+ * @brief The config of a scenario as lunar_mining_create() sets it up, it keys the result cache
+ *
+ * @param job
+ * @param cfg
+ */
+void
+Lunar::SimulationDaemon::scenarioConfig(const DaemonJob &job, Config &cfg)
+{
+    auto &sc = job.scenario;
+    cfg.set(ServiceParams::TRUCK,                 sc.numOfTrucks);
+    cfg.set(ServiceParams::UNLOAD_STATION,        sc.numOfUnloadStations);
+    cfg.set(ServiceParams::SIMULATION_TIME_HOURS, sc.simulationHours);
+    cfg.set(ServiceParams::SCHEDULING_POLICY,     sc.schedulingPolicy);
+    cfg.set(ServiceParams::BATCH_ASSIGNMENT_BUDGET_US, sc.batchAssignmentBudgetUs);
+    cfg.set(ServiceParams::RNG_SEED,              sc.rngSeed);
+    cfg.set(ServiceParams::WARMUP_DETECTION,      sc.warmUpDetection);
+    if(sc.unloadStationBays != nullptr) {
+        cfg.set(ServiceParams::UNLOAD_STATION_BAYS, std::string(sc.unloadStationBays));
+    }
+}
+
+/**
+ * @brief Fill the scenario of a job from the request, omitted params are taken from mining.cfg
+ *
+ * @param job
+ * @param fields
+ * @return true
+ * @return false
+ */
+bool
+Lunar::SimulationDaemon::initScenario(DaemonJob &job, const std::map<std::string, std::string> &fields)
+{
+    // every value is checked as long before it is narrowed into the int fields of the scenario
+    constexpr long INT_MIN_VAL {std::numeric_limits<int>::min()};
+    constexpr long INT_MAX_VAL {std::numeric_limits<int>::max()};
+    constexpr long LONG_MAX_VAL{std::numeric_limits<long>::max()};
+
+    auto valid = true;
+    auto get = [&fields, &valid] (const char *key, long def, long min, long max) {
+        auto it = fields.find(key);
+        if(it == fields.end()) {
+            return def;
+        }
+        long val {0};
+        if(parseLong(it->second, min, max, val) == false) {
+            valid = false;
+            return def;
+        }
+        return val;
+    };
+
+    auto &sc = job.scenario;
+    lunar_mining_default_config(&sc);
+
+    job.id       = get("id",       -1, 0, LONG_MAX_VAL);
+    job.priority = get("priority", 0, INT_MIN_VAL, INT_MAX_VAL);
+    job.minutes  = get("minutes",  0, 0, LONG_MAX_VAL);
+    job.progress = get("progress", 0, 0, LONG_MAX_VAL);
+
+    auto hours  = mCfg->simRunTimeInHours();
+    auto policy = mCfg->schedulingPolicy();
+    auto budget = mCfg->batchAssignmentBudgetUs();
+    auto seed   = mCfg->rngSeed();
+
+    sc.numOfTrucks             = get("trucks",   mCfg->numOfTrucks(),         1, DAEMON_MAX_TRUCKS);
+    sc.numOfUnloadStations     = get("stations", mCfg->numOfUnloadStations(), 1, DAEMON_MAX_STATIONS);
+    sc.simulationHours         = get("hours",    (hours > 1) ? hours : sc.simulationHours, 0, DAEMON_MAX_HOURS);
+    sc.schedulingPolicy        = get("policy",   policy,                       0, INT_MAX_VAL);
+    sc.batchAssignmentBudgetUs = get("budget",   (budget >= 0) ? budget : sc.batchAssignmentBudgetUs, 0, INT_MAX_VAL);
+    sc.rngSeed                 = get("seed",     (seed >= 0) ? seed : sc.rngSeed, INT_MIN_VAL, INT_MAX_VAL);
+    sc.warmUpDetection         = get("warmup",   mCfg->warmUpDetection(),      0, INT_MAX_VAL);
+
+    if(valid == false || job.id < 0) {
+        return false;
+    }
+
+    // the bays of mining.cfg are expanded to the stations of the scenario
+    auto baysIt = fields.find("bays");
+    if(baysIt != fields.end()) {
+        job.bays = baysIt->second;
+    }
+    else {
+        for (int s {0}; s < sc.numOfUnloadStations && s < DAEMON_MAX_STATIONS; s++) {
+            job.bays += (s > 0 ? "," : "") + std::to_string(mCfg->unloadStationBays(s));
+        }
+    }
+    sc.unloadStationBays = job.bays.empty() ? nullptr : job.bays.c_str();
+
+    return true;
+}
+
+/**
+ * @brief Parse a whole string as a number within [min, max]
+ *
+ * @param str
+ * @param min
+ * @param max
+ * @param val
+ * @return true
+ * @return false  empty, trailing characters, overflow or out of range
+ */
+bool
+Lunar::SimulationDaemon::parseLong(const std::string &str, long min, long max, long &val)
+{
+    long num {0};
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), num);
+    if(str.empty() || ec != std::errc() || end != str.data() + str.size() || num < min || num > max) {
+        return false;
+    }
+
+    val = num;
+    return true;
+}
+
+/**
+ * @brief Parse a flat JSON object of number and string values, nested values are not supported
+ *
+ * @param line
+ * @param fields
+ * @return true
+ * @return false
+ */
+bool
+Lunar::SimulationDaemon::parseRequest(const std::string &line, std::map<std::string, std::string> &fields)
+{
+    size_t pos {0};
+    auto skipSpace = [&] () { while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) { pos++; } };
+    auto parseString = [&] (std::string &out) {
+        if(pos >= line.size() || line[pos] != '"') {
+            return false;
+        }
+        auto end = line.find('"', ++pos);
+        if(end == std::string::npos) {
+            return false;
+        }
+        out = line.substr(pos, end - pos);
+        pos = end + 1;
+        return true;
+    };
+
+    skipSpace();
+    if(pos >= line.size() || line[pos++] != '{') {
+        return false;
+    }
+
+    skipSpace();
+    if(pos < line.size() && line[pos] == '}') {
+        return true;
+    }
+
+    while (pos < line.size()) {
+        std::string key, value;
+        skipSpace();
+        if(parseString(key) == false) {
+            return false;
+        }
+        skipSpace();
+        if(pos >= line.size() || line[pos++] != ':') {
+            return false;
+        }
+        skipSpace();
+        if(pos < line.size() && line[pos] == '"') {
+            if(parseString(value) == false) {
+                return false;
+            }
+        }
+        else {
+            auto end = line.find_first_of(",} \t", pos);
+            if(end == std::string::npos) {
+                return false;
+            }
+            value = line.substr(pos, end - pos);
+            pos   = end;
+        }
+        fields[key] = value;
+
+        skipSpace();
+        if(pos >= line.size()) {
+            return false;
+        }
+        if(line[pos] == '}') {
+            return true;
+        }
+        if(line[pos++] != ',') {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Format a progress or final result line
+ *
+ * @param job
+ * @param status
+ * @param res
+ * @return std::string
+ */
+std::string
+Lunar::SimulationDaemon::formatResult(const DaemonJob &job, const char *status, const LunarMiningResult &res)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << "{\"id\":"                 << job.id
+       << ",\"status\":\""           << status << "\""
+       << ",\"minute\":"             << res.minute
+       << ",\"runTime\":"            << res.runTime
+       << ",\"trucks\":"             << res.numOfTrucks
+       << ",\"stations\":"           << res.numOfStations
+       << ",\"deliveries\":"         << res.deliveries
+       << ",\"meanWaitTime\":"       << res.meanWaitTime
+       << ",\"payload\":"            << res.payload;
+    if(job.scenario.warmUpDetection > 0) {
+        ss << ",\"warmUpTime\":"         << res.warmUpTime
+           << ",\"steadyDeliveries\":"   << res.steadyDeliveries
+           << ",\"steadyMeanWaitTime\":" << res.steadyMeanWaitTime;
+    }
+    ss << "}";
+
+    return ss.str();
+}
+
+/**
+ * @brief Format a status line without results
+ *
+ * @param id
+ * @param status
+ * @param detail
+ * @return std::string
+ */
+std::string
+Lunar::SimulationDaemon::formatStatus(long id, const char *status, const std::string &detail)
+{
+    std::stringstream ss;
+    ss << "{\"id\":" << id << ",\"status\":\"" << status << "\"";
+    if(detail.empty() == false) {
+        ss << ",\"error\":\"" << detail << "\"";
+    }
+    ss << "}";
+
+    return ss.str();
+}
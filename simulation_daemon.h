@@ -0,0 +1,116 @@
+#ifndef SIMULATION_DAEMON_H
+#define SIMULATION_DAEMON_H
+
+#include "service_include.h"
+#include "config.h"
+#include "lunar_mining_api.h"
+#include "result_cache.h"
+#include "worker_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <chrono>
+
+namespace Lunar {
+
+    struct DaemonJob;
+
+    // Connection of a client, responses of the workers and the reader are serialized by mLock
+    struct DaemonClient {
+        int                                       fd   {-1};
+        std::atomic<bool>                         open {true};
+        std::mutex                                mLock;
+        std::map<long, std::weak_ptr<DaemonJob>>  jobs;      // by the id chosen by the client
+
+        bool send(const std::string &line);
+    };
+
+    // Scenario of a client request, higher priorities run first, equal priorities in arrival order
+    struct DaemonJob {
+        long              id        {0};
+        int               priority  {0};
+        unsigned long     order     {0};
+        long              minutes   {0};     // 0: run to completion
+        long              progress  {0};     // minutes between progress lines, 0: result only
+        std::string       bays      {};
+        LunarMiningConfig scenario  {};
+        std::atomic<bool> cancelled {false};
+        std::chrono::steady_clock::time_point accepted {};
+        std::shared_ptr<DaemonClient>         client   {};
+    };
+
+    /**
+     * @brief Long-running simulation service on a Unix domain socket (DAEMON_SOCKET)
+     *
+     *          Clients send one flat JSON object per line, a scenario
+     *              {"id":1,"priority":2,"trucks":100,"stations":4,"hours":24,"progress":60}
+     *          or a cancellation {"cancel":1}. Omitted scenario params are taken from mining.cfg.
+     *          The worker threads are started once and stay warm, each job runs an embedded simulation
+     *          and streams {"id":..,"status":"progress"|"done"|"cancelled"|"error",..} lines back.
+     */
+    class SimulationDaemon
+    {
+        public:
+            SimulationDaemon(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~SimulationDaemon();
+
+            ServiceStatus run();
+            static void   requestStop();
+
+        protected:
+            Config *mCfg {nullptr};
+            ResultCache mCache;
+
+            ServiceStatus openSocket   (const std::string &path);
+            void closeSocket           ();
+            void startWorkers          (int numOfWorkers);
+            void stopWorkers           ();
+            void worker                (int cpu);
+            void serveClient           (std::shared_ptr<DaemonClient> client);
+            void handleRequest         (const std::shared_ptr<DaemonClient> &client, const std::string &line);
+            void submit                (std::shared_ptr<DaemonJob> job);
+            void cancelClientJobs      (DaemonClient &client);
+            void runJob                (DaemonJob &job);
+            bool initScenario          (DaemonJob &job, const std::map<std::string, std::string> &fields);
+            void sendDone              (DaemonJob &job, const LunarMiningResult &res,
+                                        std::chrono::steady_clock::time_point started, bool cached);
+
+            static void scenarioConfig (const DaemonJob &job, Config &cfg);
+
+            static bool parseRequest   (const std::string &line, std::map<std::string, std::string> &fields);
+            static bool parseLong      (const std::string &str, long min, long max, long &val);
+            static std::string formatResult(const DaemonJob &job, const char *status, const LunarMiningResult &res);
+            static std::string formatStatus(long id, const char *status, const std::string &detail = "");
+
+        private:
+            struct JobOrder {
+                bool operator()(const std::shared_ptr<DaemonJob> &a, const std::shared_ptr<DaemonJob> &b) const {
+                    return (a->priority != b->priority) ? (a->priority < b->priority) : (a->order > b->order);
+                }
+            };
+
+            int         mListenFd   {-1};
+            std::string mSocketPath {};
+            bool        mStopWorkers{false};
+            unsigned long mOrder    {0};
+
+            std::mutex              mLock;
+            std::condition_variable mJobReady;
+            std::priority_queue<std::shared_ptr<DaemonJob>, std::vector<std::shared_ptr<DaemonJob>>, JobOrder> mJobs;
+            std::vector<std::thread> mWorkers;
+
+            struct ClientThread {
+                std::thread                        thread;
+                std::shared_ptr<std::atomic<bool>> done;
+            };
+            std::vector<ClientThread> mClients;
+
+            static std::atomic<bool> sStopRequested;
+    };
+}
+
+#endif // SIMULATION_DAEMON_H
@@ -0,0 +1,50 @@
+#ifndef SIMULATION_ENGINE_H
+#define SIMULATION_ENGINE_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    // Per-minute state of an engine, trucks and stations are ordered by their index
+    struct EngineSnapshot {
+        unsigned long           minute       {0};
+        long                    deliveries   {0};
+        std::vector<TruckState> truckStates  {};
+        std::vector<int>        stationQueues{};
+    };
+
+    // Final results of a simulation run
+    struct MiningSummary {
+        long   runTime        {0};
+        long   numOfStations  {0};
+        long   numOfTrucks    {0};
+        long   deliveries     {0};
+        long   totalWaitTime  {0};
+        double meanWaitTime   {0.0};
+        long   payload        {0};      // tons delivered
+        long   warmUpTime     {0};      // minutes truncated from the steady-state statistics
+        long   steadyDeliveries{0};     // deliveries done after the warm-up
+        double steadyMeanWaitTime{0.0}; // mean wait of the deliveries done after the warm-up
+    };
+
+    /**
+     * @brief Common interface of the simulation engines,
+     *          the MiningController is the reference engine,
+     *          faster engines have to produce the same snapshots for the same seed
+     */
+    class SimulationEngine
+    {
+        public:
+            virtual ~SimulationEngine() {}
+
+            virtual ServiceStatus init    () = 0;
+            virtual void          startServices() = 0;
+            virtual void          step    () = 0;
+            virtual unsigned long clock   () = 0;
+            virtual long          runTime () = 0;
+            virtual void          snapshot(EngineSnapshot &snap) = 0;
+            virtual MiningSummary summary () = 0;
+    };
+}
+
+#endif // SIMULATION_ENGINE_H
@@ -0,0 +1,189 @@
+#include "site_model.h"
+
+namespace {
+    /**
+     * @brief Split a line of the site-file into its fields
+     *
+     * @param line
+     * @param delimiter
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> splitFields(const std::string &line, char delimiter)
+    {
+        std::vector<std::string> tokens;
+        std::string token;
+        std::stringstream ss(line);
+        while (std::getline(ss, token, delimiter)) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Parse an unsigned decimal field
+     *
+     * @param val
+     * @param min
+     * @param max
+     * @return int -1 if the field is no number or out of [min, max]
+     */
+    int toNumber(const std::string &val, int min, int max)
+    {
+        int num {-1};
+        auto [end, ec] = std::from_chars(val.data(), val.data() + val.size(), num);
+        if(val.empty() || std::isdigit(static_cast<unsigned char>(val[0])) == 0 ||
+           ec != std::errc() || end != val.data() + val.size() || num < min || num > max) {
+            return -1;
+        }
+        return num;
+    }
+}
+
+/**
+ * @brief Load the site-file
+ *          truck classes:    class;name;payload-tons;speed-percent;unload-minutes;weight
+ *          drive times:      site;name;minutes-to-station-1,minutes-to-station-2,...
+ *          all sites need the same number of stations
+ *
+ * @param path
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SiteModel::load(const std::string &path)
+{
+    std::ifstream inputFile(path);
+    if(inputFile.is_open() == false) {
+        std::cerr << "[SITE-ERROR], Unable to open file " << path << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    int lineNum {0};
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        lineNum++;
+        std::erase_if(line, [] (unsigned char c) { return std::isspace(c); });
+        if(line.empty() || line[0] == Lunar::CONFIG_COMMENT_TAGE) {
+            continue;
+        }
+
+        auto fields = splitFields(line, Lunar::SITE_FILE_DELIMITER);
+        auto ret    = false;
+        if(fields[0] == "class") {
+            ret = addClass(fields);
+        }
+        else if(fields[0] == "site") {
+            ret = addSite(fields);
+        }
+
+        if(ret == false) {
+            std::cerr << "[SITE-ERROR], " << path << ":" << lineNum << ", Invalid line:" << line << std::endl;
+            return ServiceStatus::ERROR;
+        }
+    }
+
+    // trucks are assigned to the classes round-robin, a class with weight w gets w slots
+    for (int c {0}; c < static_cast<int>(mClasses.size()); c++) {
+        mClassCycle.insert(mClassCycle.end(), mClasses[c].weight, c);
+    }
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Add a truck class "class;name;payload-tons;speed-percent;unload-minutes;weight"
+ *
+ * @param fields
+ * @return true
+ * @return false
+ */
+bool
+Lunar::SiteModel::addClass(const std::vector<std::string> &fields)
+{
+    if(fields.size() != 6) {
+        return false;
+    }
+
+    TruckClass cls(fields[1], toNumber(fields[2], 0, SITE_MAX_PAYLOAD),      toNumber(fields[3], 1, SITE_MAX_SPEED_PERCENT),
+                              toNumber(fields[4], 1, SITE_MAX_MINUTES),      toNumber(fields[5], 1, SITE_MAX_CLASS_WEIGHT));
+    if(cls.payload < 0 || cls.speedPercent < 0 || cls.unloadMinutes < 0 || cls.weight < 0) {
+        return false;
+    }
+
+    mClasses.push_back(cls);
+    return true;
+}
+
+/**
+ * @brief Add a mining site "site;name;minutes-to-station-1,minutes-to-station-2,..."
+ *
+ * @param fields
+ * @return true
+ * @return false
+ */
+bool
+Lunar::SiteModel::addSite(const std::vector<std::string> &fields)
+{
+    if(fields.size() != 3) {
+        return false;
+    }
+
+    auto minutes = splitFields(fields[2], ',');
+    if(minutes.empty() || std::ranges::any_of(minutes, [] (auto &val) { return toNumber(val, 0, SITE_MAX_MINUTES) < 0; })) {
+        return false;
+    }
+
+    if(mNumOfSites == 0) {
+        mNumOfStations = minutes.size();
+    }
+    else if(static_cast<int>(minutes.size()) != mNumOfStations) {
+        return false;
+    }
+
+    for (auto &val : minutes) {
+        mDriveTimes.push_back(toNumber(val, 0, SITE_MAX_MINUTES));
+    }
+    mSiteNames.push_back(fields[1]);
+    mNumOfSites++;
+
+    return true;
+}
+
+/**
+ * @brief Returns the name of the site
+ *
+ * @param site
+ * @return const std::string&
+ */
+const std::string &
+Lunar::SiteModel::siteName(int site) const
+{
+    return mSiteNames.at(site);
+}
+
+/**
+ * @brief Returns the home site of the truck, trucks are spread over the sites round-robin
+ *
+ * @param trkIdx
+ * @return int
+ */
+int
+Lunar::SiteModel::siteOf(int trkIdx) const
+{
+    return (mNumOfSites > 0) ? trkIdx % mNumOfSites : 0;
+}
+
+/**
+ * @brief Returns the class of the truck, the default class if the site-file has no classes
+ *
+ * @param trkIdx
+ * @return const Lunar::TruckClass&
+ */
+const Lunar::TruckClass &
+Lunar::SiteModel::truckClass(int trkIdx) const
+{
+    if(mClassCycle.empty()) {
+        return mDefaultClass;
+    }
+
+    return mClasses[mClassCycle[trkIdx % mClassCycle.size()]];
+}
@@ -0,0 +1,63 @@
+#ifndef SITE_MODEL_H
+#define SITE_MODEL_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    /**
+     * @brief Truck classes and mining-site x unload-station drive times loaded from the site-file
+     *          The drive times are kept in one dense row-major matrix, a row per site,
+     *          so a dispatch decision scans one contiguous row
+     */
+    class SiteModel
+    {
+        public:
+            SiteModel() {}
+
+            virtual ~SiteModel() {}
+
+            ServiceStatus load(const std::string &path);
+
+            bool hasRoutes   () const { return mNumOfSites > 0; }
+            int  numOfSites  () const { return mNumOfSites; }
+            int  numOfClasses() const { return mClasses.size(); }
+            int  numOfStationColumns() const { return mNumOfStations; }
+
+            const std::string &siteName(int site) const;
+            int  siteOf      (int trkIdx) const;
+            const TruckClass &truckClass(int trkIdx) const;
+
+            /**
+             * @brief Drive time (minutes) from the site to the station,
+             *          stations without a column use DRIVE_TIME_MINUTES
+             */
+            int driveTime(int site, int stationIdx) const
+            {
+                if(stationIdx < 0 || stationIdx >= mNumOfStations) {
+                    return Lunar::DRIVE_TIME_MINUTES;
+                }
+                return mDriveTimes[static_cast<size_t>(site) * mNumOfStations + stationIdx];
+            }
+
+            // drive times from the site to the stations 0 .. numOfStationColumns()-1
+            const int *driveRow(int site) const
+            {
+                return mDriveTimes.data() + static_cast<size_t>(site) * mNumOfStations;
+            }
+
+        private:
+            int                      mNumOfSites    {0};
+            int                      mNumOfStations {0};
+            std::vector<int>         mDriveTimes    {};
+            std::vector<std::string> mSiteNames     {};
+            std::vector<TruckClass>  mClasses       {};
+            std::vector<int>         mClassCycle    {};     // class index per truck, repeated by weight
+            TruckClass               mDefaultClass  {};
+
+            bool addClass(const std::vector<std::string> &fields);
+            bool addSite (const std::vector<std::string> &fields);
+    };
+}
+
+#endif // SITE_MODEL_H
@@ -0,0 +1,166 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    /**
+     * @brief Stable reference to an entity in a SlotMap,
+     *          the generation detects handles of erased entities
+     */
+    struct SlotHandle {
+        static const uint32_t INVALID {std::numeric_limits<uint32_t>::max()};
+
+        uint32_t index      {INVALID};
+        uint32_t generation {0};
+
+        bool valid() const { return index != INVALID; }
+        bool operator==(const SlotHandle &other) const = default;
+    };
+
+    /**
+     * @brief Generational slot map
+     *          The entities are stored by value in a contiguous vector (cache-friendly iteration, cheap copies),
+     *          handles stay valid across insert/erase of other entities.
+     *          insert, erase and lookup are O(1), erase moves the last entity into the gap.
+     *
+     * @tparam T entity type, has to be nothrow move constructible
+     */
+    template <typename T>
+    class SlotMap
+    {
+        // otherwise the vector copies every entity when it grows, and the copies allocate from the default resource
+        static_assert(std::is_nothrow_move_constructible_v<T>, "SlotMap entities need a noexcept move constructor");
+
+        public:
+            using iterator       = typename std::pmr::vector<T>::iterator;
+            using const_iterator = typename std::pmr::vector<T>::const_iterator;
+
+            SlotMap() {}
+
+            // the entities and the slots allocate from res, e.g. to account the memory of the entities
+            explicit SlotMap(std::pmr::memory_resource *res) :
+                mData(res), mDataSlot(res), mSlots(res) {}
+
+            virtual ~SlotMap() {}
+
+            /**
+             * @brief Construct an entity in place and return its handle
+             */
+            template <typename... Args>
+            SlotHandle emplace(Args &&...args)
+            {
+                uint32_t slotIdx {0};
+                if(mFreeHead != SlotHandle::INVALID) {
+                    slotIdx   = mFreeHead;
+                    mFreeHead = mSlots[slotIdx].dataIdx;
+                }
+                else {
+                    slotIdx = mSlots.size();
+                    mSlots.push_back(Slot());
+                }
+
+                mData.emplace_back(std::forward<Args>(args)...);
+                mDataSlot.push_back(slotIdx);
+                mSlots[slotIdx].dataIdx = mData.size() - 1;
+                mVersion++;
+
+                return SlotHandle(slotIdx, mSlots[slotIdx].generation);
+            }
+
+            /**
+             * @brief Erase the entity, the last entity is moved into its place
+             *
+             * @return false if the handle is stale
+             */
+            bool erase(SlotHandle handle)
+            {
+                if(contains(handle) == false) {
+                    return false;
+                }
+
+                auto dataIdx = mSlots[handle.index].dataIdx;
+                auto lastIdx = static_cast<uint32_t>(mData.size() - 1);
+                if(dataIdx != lastIdx) {
+                    mData[dataIdx]     = std::move(mData[lastIdx]);
+                    mDataSlot[dataIdx] = mDataSlot[lastIdx];
+                    mSlots[mDataSlot[dataIdx]].dataIdx = dataIdx;
+                }
+                mData.pop_back();
+                mDataSlot.pop_back();
+
+                // invalidate the handle and put the slot on the free list
+                mSlots[handle.index].generation++;
+                mSlots[handle.index].dataIdx = mFreeHead;
+                mFreeHead = handle.index;
+                mVersion++;
+
+                return true;
+            }
+
+            /**
+             * @brief Returns the entity or nullptr if the handle is stale
+             */
+            T *get(SlotHandle handle)
+            {
+                return contains(handle) ? &mData[mSlots[handle.index].dataIdx] : nullptr;
+            }
+
+            bool contains(SlotHandle handle) const
+            {
+                return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation &&
+                       mSlots[handle.index].dataIdx < mData.size() && mDataSlot[mSlots[handle.index].dataIdx] == handle.index;
+            }
+
+            /**
+             * @brief Returns the handle of the entity at the position pos of the contiguous storage
+             */
+            SlotHandle handleAt(size_t pos) const
+            {
+                auto slotIdx = mDataSlot[pos];
+                return SlotHandle(slotIdx, mSlots[slotIdx].generation);
+            }
+
+            T &at(size_t pos)             { return mData[pos]; }
+
+            void reserve(size_t n)
+            {
+                mData.reserve(n);
+                mDataSlot.reserve(n);
+                mSlots.reserve(n);
+            }
+
+            void clear()
+            {
+                while (mData.empty() == false) {
+                    erase(handleAt(mData.size() - 1));
+                }
+            }
+
+            size_t size () const          { return mData.size(); }
+            bool   empty() const          { return mData.empty(); }
+
+            // it changes on every insert/erase, users caching positions or pointers re-sync on change
+            unsigned long version() const { return mVersion; }
+
+            iterator       begin()        { return mData.begin(); }
+            iterator       end  ()        { return mData.end(); }
+            const_iterator begin() const  { return mData.begin(); }
+            const_iterator end  () const  { return mData.end(); }
+
+        private:
+            struct Slot {
+                uint32_t dataIdx    {0};    // position in mData, next free slot if the slot is free
+                uint32_t generation {0};
+            };
+
+            std::pmr::vector<T>        mData     {};
+            std::pmr::vector<uint32_t> mDataSlot {};
+            std::pmr::vector<Slot>     mSlots    {};
+            uint32_t              mFreeHead {SlotHandle::INVALID};
+            unsigned long         mVersion  {0};
+    };
+}
+
+#endif // SLOT_MAP_H
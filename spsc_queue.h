@@ -0,0 +1,82 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "service_include.h"
+
+#include <atomic>
+#include <array>
+
+namespace Lunar {
+
+    /**
+     * @brief Bounded lock-free queue of one producer and one consumer thread.
+     *          The producer owns the tail, the consumer the head, each side caches the index of the other one
+     *          and reloads it only if the queue looks full resp. empty. The indices are on their own cache lines.
+     *
+     * @tparam T        copyable item
+     * @tparam Capacity power of two
+     */
+    template <typename T, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity has to be a power of two");
+
+        public:
+            SpscQueue() {}
+            SpscQueue(const SpscQueue &) = delete;
+            SpscQueue &operator=(const SpscQueue &) = delete;
+            virtual ~SpscQueue() {}
+
+            /**
+             * @brief Producer side
+             *
+             * @return false if the queue is full
+             */
+            bool push(const T &item)
+            {
+                auto tail = mTail.load(std::memory_order_relaxed);
+                if(tail - mHeadCache == Capacity) {
+                    mHeadCache = mHead.load(std::memory_order_acquire);
+                    if(tail - mHeadCache == Capacity) {
+                        return false;
+                    }
+                }
+
+                mItems[tail & (Capacity - 1)] = item;
+                mTail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Consumer side
+             *
+             * @return false if the queue is empty
+             */
+            bool pop(T &item)
+            {
+                auto head = mHead.load(std::memory_order_relaxed);
+                if(head == mTailCache) {
+                    mTailCache = mTail.load(std::memory_order_acquire);
+                    if(head == mTailCache) {
+                        return false;
+                    }
+                }
+
+                item = mItems[head & (Capacity - 1)];
+                mHead.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+        private:
+            // consumer
+            alignas(64) std::atomic<size_t> mHead      {0};
+                        size_t              mTailCache {0};
+            // producer
+            alignas(64) std::atomic<size_t> mTail      {0};
+                        size_t              mHeadCache {0};
+
+            alignas(64) std::array<T, Capacity> mItems {};
+    };
+}
+
+#endif // SPSC_QUEUE_H
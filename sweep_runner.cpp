@@ -0,0 +1,407 @@
+#include "sweep_runner.h"
+#include "mining_controller.h"
+#include "fixed_mining_engine.h"
+
+#include <atomic>
+
+/**
+ * @brief Run the sweep over SWEEP_TRUCKS x SWEEP_STATIONS,
+ *          a list that is not set falls back to TRUCKS resp. UNLOAD_STATIONS
+ *
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SweepRunner::run()
+{
+    // sweeps are always seeded, see runSeed()
+    mSeed = mCfg->rngSeed();
+    if(mSeed < 0) {
+        mSeed = Lunar::DEFAULT_RNG_SEED;
+    }
+
+    auto fleets   = parseCounts(mCfg->sweepTrucks(),   mCfg->numOfTrucks(),         SWEEP_MAX_TRUCKS);
+    auto stations = parseCounts(mCfg->sweepStations(), mCfg->numOfUnloadStations(), SWEEP_MAX_STATIONS);
+    if(fleets.empty() || stations.empty()) {
+        std::cerr << "[SWEEP-ERROR], Invalid SWEEP_TRUCKS/SWEEP_STATIONS" << std::endl;
+        return ServiceStatus::ERROR;
+    }
+
+    mNumOfConfigs = static_cast<int>(fleets.size() * stations.size());
+
+    // the runs of a configuration are simulated on a pinned worker pool, one worker per CPU
+    mPool = std::make_unique<WorkerPool>(0, WorkerPool::pinningPolicy(*mCfg));
+
+    auto cacheDir = mCfg->resultCacheDir();
+    if(cacheDir.empty() == false && mCache.open(cacheDir) != ServiceStatus::SUCESS) {
+        return ServiceStatus::ERROR;
+    }
+
+    // each configuration is paired with the previous station count of the same fleet
+    auto ret {ServiceStatus::SUCESS};
+    int  configIdx {0};
+    std::vector<SweepResult> prevRow;
+    std::vector<SweepResult> row;
+    for (auto numOfStations : stations) {
+        row.clear();
+        for (auto numOfTrucks : fleets) {
+            SweepResult res;
+            res.configIdx     = configIdx++;
+            res.numOfTrucks   = numOfTrucks;
+            res.numOfStations = numOfStations;
+            if(runConfig(res) != ServiceStatus::SUCESS) {
+                ret = ServiceStatus::ERROR;
+            }
+
+            if(prevRow.empty() == false) {
+                auto paired = formatPaired(res, prevRow[row.size()]);
+                if(paired.empty() == false) {
+                    std::cerr << paired << std::endl;
+                }
+            }
+            row.push_back(std::move(res));
+        }
+        prevRow.swap(row);
+    }
+
+    std::cerr << "[SWEEP-SUMMARY], Configurations:" << mNumOfConfigs << ", "
+              << "Skipped:"  << mSkipped  << ", "
+              << "RunOnce:"  << mReduced  << ", "
+              << "Runs:"     << mRuns     << " of " << mFullRuns;
+    if(mCfg->sweepCiPercent() > 0) {
+        std::cerr << ", NotConverged:" << mNotConverged;
+    }
+    if(mCache.isOpen()) {
+        std::cerr << ", CacheHits:" << mCache.hits();
+    }
+    std::cerr << std::endl;
+
+    return ret;
+}
+
+/**
+ * @brief Estimate a configuration and simulate it with as many runs as the estimate asks for,
+ *          with SWEEP_CI_PERCENT the runs continue until the confidence intervals converge
+ *          or SWEEP_MAX_REPLICATIONS is reached
+ *
+ * @param res
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SweepRunner::runConfig(SweepResult &res)
+{
+    mCfg->set(ServiceParams::TRUCK,          res.numOfTrucks);
+    mCfg->set(ServiceParams::UNLOAD_STATION, res.numOfStations);
+
+    auto fullRuns  = std::max(1, mCfg->sweepReplications());
+    auto ciPercent = mCfg->sweepCiPercent();
+    auto maxRuns   = (ciPercent > 0) ? std::max(fullRuns, mCfg->sweepMaxReplications()) : fullRuns;
+
+    // the estimate decides before the first minute is simulated
+    mCfg->set(ServiceParams::RNG_SEED, runSeed(res, 0));
+    {
+        MiningController ctrl(mCfg);
+        ctrl.setPaced(false);
+        ctrl.setReporting(false);
+        if(ctrl.init() != ServiceStatus::SUCESS) {
+            std::cerr << "[SWEEP-ERROR], Trucks:" << res.numOfTrucks << ", Stations:" << res.numOfStations
+                      << " init failed" << std::endl;
+            return ServiceStatus::ERROR;
+        }
+        res.estimate = ctrl.estimate();
+    }
+
+    std::string note;
+    auto runs = replications(res.estimate, note);
+    if(runs < fullRuns) {
+        maxRuns = runs;
+    }
+
+    // the planned runs are simulated as one batch on the worker pool, the runs of the sequential stopping
+    // one batch per pool size; the results are taken in run order, so the runs after convergence are dropped
+    bool converged {false};
+    for (int first {0}; first < maxRuns && converged == false; ) {
+        auto batch = (first < runs) ? runs - first : std::min(mPool->numOfWorkers(), maxRuns - first);
+
+        std::vector<Config> cfgs(batch, *mCfg);
+        std::vector<MiningSummary> sums(batch);
+        std::vector<int> simulated;
+        std::atomic<bool> failed {false};
+        for (int b {0}; b < batch; b++) {
+            cfgs[b].set(ServiceParams::RNG_SEED, runSeed(res, first + b));
+
+            // repeated studies take the run from the result cache
+            if(mCache.lookup(cfgs[b], sums[b])) {
+                continue;
+            }
+
+            simulated.push_back(b);
+            mPool->submit([&cfg = cfgs[b], &sum = sums[b], &failed] () {
+                if(simulate(cfg, sum) != ServiceStatus::SUCESS) {
+                    failed = true;
+                }
+            });
+        }
+        mPool->wait();
+
+        if(failed) {
+            std::cerr << "[SWEEP-ERROR], Trucks:" << res.numOfTrucks << ", Stations:" << res.numOfStations
+                      << " init failed" << std::endl;
+            return ServiceStatus::ERROR;
+        }
+        for (auto b : simulated) {
+            mCache.store(cfgs[b], sums[b]);
+        }
+
+        for (int b {0}; b < batch; b++) {
+            if(ciPercent > 0 && first + b >= runs && isConverged(res, ciPercent)) {
+                converged = true;
+                break;
+            }
+
+            // with warm-up detection the wait is taken without the initial transient
+            auto &sum     = sums[b];
+            auto waitTime = (mCfg->warmUpDetection() > 0) ? sum.steadyMeanWaitTime : sum.meanWaitTime;
+            if(mCfg->warmUpDetection() > 0) {
+                res.warmUpTime.add(sum.warmUpTime);
+            }
+            res.deliveries.add(sum.deliveries);
+            res.meanWaitTime.add(waitTime);
+            res.runDeliveries.push_back(sum.deliveries);
+            res.runWaitTimes.push_back(waitTime);
+            res.runs++;
+        }
+        first += batch;
+    }
+
+    if(ciPercent > 0 && res.runs > 1) {
+        res.converged = isConverged(res, ciPercent);
+        mNotConverged += res.converged ? 0 : 1;
+    }
+
+    mRuns     += res.runs;
+    mFullRuns += std::max(fullRuns, res.runs);
+
+    std::cerr << formatResult(res, note) << std::endl;
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Simulate one run on the calling worker, so its storage is allocated on the node of the worker.
+ *          The fixed layouts run on the compile-time specialized engine, it gives the same results
+ *
+ * @param cfg
+ * @param sum
+ * @return Lunar::ServiceStatus
+ */
+Lunar::ServiceStatus
+Lunar::SweepRunner::simulate(Config &cfg, MiningSummary &sum)
+{
+    MiningController ctrl(&cfg);
+    ctrl.setPaced(false);
+    ctrl.setReporting(false);
+
+    SimulationEngine *engine = &ctrl;
+    auto fixed = createFixedEngine(&cfg);
+    if(fixed != nullptr && fixed->init() == ServiceStatus::SUCESS) {
+        engine = fixed.get();
+    }
+    else if(ctrl.init() != ServiceStatus::SUCESS) {
+        return ServiceStatus::ERROR;
+    }
+
+    engine->startServices();
+    while (engine->clock() <= static_cast<unsigned long>(engine->runTime())) {
+        engine->step();
+    }
+    sum = engine->summary();
+
+    return ServiceStatus::SUCESS;
+}
+
+/**
+ * @brief Seed of run r of a configuration
+ *          common random numbers (default): RNG_SEED + r for every configuration,
+ *          the loading times come from per-truck streams keyed by the truck index,
+ *          so truck i sees the same loading times in run r of every configuration.
+ *          SWEEP_COMMON_RANDOM_NUMBERS=0: a distinct seed per configuration and run (independent streams)
+ *
+ * @param res
+ * @param run
+ * @return int
+ */
+int
+Lunar::SweepRunner::runSeed(const SweepResult &res, int run)
+{
+    if(mCfg->sweepCommonRandomNumbers() > 0) {
+        return mSeed + run;
+    }
+    return mSeed + run * mNumOfConfigs + res.configIdx;
+}
+
+/**
+ * @brief Check if the 95% confidence intervals of the deliveries and the mean wait
+ *          are within ciPercent of their means
+ *
+ * @param res
+ * @param ciPercent
+ * @return true
+ * @return false
+ */
+bool
+Lunar::SweepRunner::isConverged(const SweepResult &res, int ciPercent)
+{
+    auto target = ciPercent / 100.0;
+    return res.deliveries.halfWidth()   <= target * std::abs(res.deliveries.mean)
+        && res.meanWaitTime.halfWidth() <= target * std::abs(res.meanWaitTime.mean);
+}
+
+/**
+ * @brief Number of runs of a configuration by its estimated load,
+ *          0: clearly saturated, 1: clearly over-provisioned, else SWEEP_REPLICATIONS
+ *
+ * @param est
+ * @param note reason of the pruning
+ * @return int
+ */
+int
+Lunar::SweepRunner::replications(const QueueEstimate &est, std::string &note)
+{
+    auto load    = est.offeredLoad * 100.0;
+    auto maxLoad = mCfg->sweepMaxLoadPercent();
+    auto minLoad = mCfg->sweepMinLoadPercent();
+
+    if(maxLoad > 0 && load > maxLoad) {
+        note = "saturated";
+        mSkipped++;
+        return 0;
+    }
+
+    if(minLoad > 0 && load < minLoad) {
+        note = "over-provisioned";
+        mReduced++;
+        return 1;
+    }
+
+    return std::max(1, mCfg->sweepReplications());
+}
+
+/**
+ * @brief Parse a comma separated list of counts within [1, max], an empty list gives the fallback count
+ *
+ * @param counts
+ * @param fallback
+ * @param max
+ * @return std::vector<int> empty if a count is invalid
+ */
+std::vector<int>
+Lunar::SweepRunner::parseCounts(const std::string &counts, int fallback, int max)
+{
+    std::vector<int> vals;
+    if(counts.empty()) {
+        if(fallback > 0) {
+            vals.push_back(fallback);
+        }
+        return vals;
+    }
+
+    std::string count;
+    std::stringstream ss(counts);
+    while (std::getline(ss, count, ',')) {
+        int val {0};
+        auto [end, ec] = std::from_chars(count.data(), count.data() + count.size(), val);
+        if(count.empty() || ec != std::errc() || end != count.data() + count.size() || val < 1 || val > max) {
+            std::cerr << "[SWEEP-ERROR], Invalid count:" << count << ", 1.." << max << std::endl;
+            return {};
+        }
+        vals.push_back(val);
+    }
+
+    return vals;
+}
+
+/**
+ * @brief One line per configuration, the estimate next to the simulated means
+ *
+ * @param res
+ * @param note
+ * @return std::string
+ */
+std::string
+Lunar::SweepRunner::formatResult(const SweepResult &res, const std::string &note)
+{
+    std::stringstream ss;
+
+    ss << "[SWEEP-INFO], Trucks:"  << res.numOfTrucks   << ", "
+       << "Stations:"              << res.numOfStations << ", "
+       << std::fixed << std::setprecision(1)
+       << "EstLoad:"               << res.estimate.offeredLoad * 100.0 << "%, "
+       << "EstUtilization:"        << res.estimate.utilization * 100.0 << "%, "
+       << "EstMeanWaitTime:"       << res.estimate.meanWaitTime        << "min, "
+       << "EstDeliveries:"         << res.estimate.deliveries          << ", "
+       << "Runs:"                  << res.runs;
+
+    if(res.runs > 0) {
+        ss << ", Deliveries:"      << res.deliveries.mean
+           << ", MeanWaitTime:"    << res.meanWaitTime.mean << "min";
+    }
+    if(res.warmUpTime.count > 0) {
+        ss << ", WarmUpTime:"      << res.warmUpTime.mean << "min";
+    }
+    if(res.runs > 1) {
+        ss << ", DeliveriesCI:+-"  << res.deliveries.halfWidth()
+           << ", MeanWaitTimeCI:+-" << res.meanWaitTime.halfWidth() << "min";
+    }
+    if(res.converged) {
+        ss << ", Converged";
+    }
+    if(note.empty() == false) {
+        ss << ", Pruned:"          << note;
+    }
+
+    return ss.rdbuf()->str();
+}
+
+/**
+ * @brief Paired differences of a configuration against the base configuration over their common runs,
+ *          run r of both is one pair. The variance reduction compares the variance of the difference
+ *          to the one of independent runs (var(a) + var(b)), it is ~1 without common random numbers
+ *
+ * @param res
+ * @param base
+ * @return std::string empty if there is no common run
+ */
+std::string
+Lunar::SweepRunner::formatPaired(const SweepResult &res, const SweepResult &base)
+{
+    auto pairs = std::min(res.runDeliveries.size(), base.runDeliveries.size());
+    if(pairs == 0) {
+        return "";
+    }
+
+    RunningStat deliveries, waitTime, resDeliveries, baseDeliveries;
+    for (size_t r {0}; r < pairs; r++) {
+        deliveries.add(res.runDeliveries[r] - base.runDeliveries[r]);
+        waitTime.add  (res.runWaitTimes[r]  - base.runWaitTimes[r]);
+        resDeliveries.add (res.runDeliveries[r]);
+        baseDeliveries.add(base.runDeliveries[r]);
+    }
+
+    std::stringstream ss;
+    ss << "[SWEEP-PAIRED], Trucks:" << res.numOfTrucks  << ", "
+       << "Stations:"               << res.numOfStations << " vs " << base.numOfStations << ", "
+       << "Pairs:"                  << pairs << ", "
+       << std::fixed << std::setprecision(1) << std::showpos
+       << "DeliveriesDiff:"         << deliveries.mean << ", "
+       << "MeanWaitTimeDiff:"       << waitTime.mean   << "min"
+       << std::noshowpos;
+
+    if(pairs > 1) {
+        ss << ", DeliveriesDiffCI:+-"   << deliveries.halfWidth()
+           << ", MeanWaitTimeDiffCI:+-" << waitTime.halfWidth() << "min";
+        if(deliveries.variance() > 0.0) {
+            ss << ", VarianceReduction:" << (resDeliveries.variance() + baseDeliveries.variance()) / deliveries.variance();
+        }
+    }
+
+    return ss.rdbuf()->str();
+}
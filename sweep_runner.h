@@ -0,0 +1,74 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include "service_include.h"
+#include "config.h"
+#include "simulation_engine.h"
+#include "queue_estimator.h"
+#include "replication_stats.h"
+#include "result_cache.h"
+#include "worker_pool.h"
+
+namespace Lunar {
+
+    // Result of one fleet-size x station-count configuration of the sweep
+    struct SweepResult {
+        int           configIdx     {0};
+        int           numOfTrucks   {0};
+        int           numOfStations {0};
+        QueueEstimate estimate      {};
+        int           runs          {0};
+        RunningStat   deliveries    {};        // over the runs
+        RunningStat   meanWaitTime  {};        // over the runs, after the warm-up with WARMUP_DETECTION
+        RunningStat   warmUpTime    {};        // over the runs with WARMUP_DETECTION
+        bool          converged     {false};   // confidence intervals within SWEEP_CI_PERCENT
+        std::vector<double> runDeliveries  {};   // per run, paired by the run index
+        std::vector<double> runWaitTimes   {};
+    };
+
+    /**
+     * @brief Runs every combination of SWEEP_TRUCKS x SWEEP_STATIONS unpaced and seeded,
+     *          the analytic estimate prunes the configurations before they are simulated:
+     *          saturated ones are skipped, over-provisioned ones run once.
+     *          With SWEEP_CI_PERCENT the remaining ones run until the confidence intervals converge.
+     *          With common random numbers run r of every configuration uses the same seed, so truck i
+     *          sees the same loading times in every configuration and the differences are paired
+     */
+    class SweepRunner
+    {
+        public:
+            SweepRunner(Config *cfg) :
+                mCfg(cfg) {}
+
+            virtual ~SweepRunner() {}
+
+            ServiceStatus run();
+
+        protected:
+            Config *mCfg {nullptr};
+            ResultCache mCache;
+            std::unique_ptr<WorkerPool> mPool;
+
+            ServiceStatus runConfig(SweepResult &res);
+            int  runSeed           (const SweepResult &res, int run);
+            int  replications      (const QueueEstimate &est, std::string &note);
+
+            static ServiceStatus simulate (Config &cfg, MiningSummary &sum);
+            static bool isConverged       (const SweepResult &res, int ciPercent);
+
+            static std::vector<int> parseCounts(const std::string &counts, int fallback, int max);
+            static std::string formatResult   (const SweepResult &res, const std::string &note);
+            static std::string formatPaired   (const SweepResult &res, const SweepResult &base);
+
+        private:
+            int mSeed         {DEFAULT_RNG_SEED};
+            int mSkipped      {0};
+            int mReduced      {0};
+            int mRuns         {0};
+            int mFullRuns     {0};
+            int mNotConverged {0};
+            int mNumOfConfigs {0};
+    };
+}
+
+#endif // SWEEP_RUNNER_H
@@ -0,0 +1,134 @@
+#include "tick_profiler.h"
+
+/**
+ * @brief Add a sample to the histogram
+ *
+ * @param ns
+ */
+void
+Lunar::PhaseHistogram::add(unsigned long ns)
+{
+    int bucket {0};
+    while (bucket < BUCKETS - 1 && (ns >> bucket) != 0) {
+        bucket++;
+    }
+
+    buckets[bucket]++;
+    count++;
+    total += ns;
+    min    = std::min(min, ns);
+    max    = std::max(max, ns);
+}
+
+/**
+ * @brief Returns the upper bound (ns) of the bucket that holds the percentile p [0..1]
+ *
+ * @param p
+ * @return unsigned long
+ */
+unsigned long
+Lunar::PhaseHistogram::percentile(double p) const
+{
+    if(count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<unsigned long>(p * count);
+    unsigned long seen {0};
+    for (int b {0}; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if(seen > rank) {
+            return std::min(max, (1UL << b));
+        }
+    }
+
+    return max;
+}
+
+/**
+ * @brief Add the duration of one phase execution
+ *
+ * @param phase
+ * @param ns
+ */
+void
+Lunar::TickProfiler::add(ProfilePhase phase, unsigned long ns)
+{
+    mPhases[static_cast<int>(phase)].add(ns);
+}
+
+/**
+ * @brief Reset all histograms
+ *
+ */
+void
+Lunar::TickProfiler::reset()
+{
+    for (auto &phase : mPhases) {
+        phase = PhaseHistogram();
+    }
+}
+
+/**
+ * @brief Generate the per-phase latency summary
+ *
+ * @return std::string
+ */
+std::string
+Lunar::TickProfiler::summary()
+{
+    std::stringstream ss;
+
+    ss << "[PROFILE-SUMMARY], \n";
+    for (int p {0}; p < static_cast<int>(ProfilePhase::COUNT); p++) {
+        auto &h = mPhases[p];
+        ss << "\t" << std::left << std::setw(20) << ProfilePhaseName.find(static_cast<ProfilePhase>(p))->second
+           << "Calls:"    << h.count                                << ", "
+           << "Total:"    << h.total / 1000                         << ":us, "
+           << "Mean:"     << (h.count ? h.total / h.count : 0)      << ":ns, "
+           << "Min:"      << (h.count ? h.min : 0)                  << ":ns, "
+           << "P50<="     << h.percentile(0.50)                     << ":ns, "
+           << "P99<="     << h.percentile(0.99)                     << ":ns, "
+           << "Max:"      << h.max                                  << ":ns\n";
+    }
+
+    return ss.rdbuf()->str();
+}
+
+/**
+ * @brief Dump the per-phase histograms as JSON
+ *
+ * @param path
+ * @return true
+ * @return false
+ */
+bool
+Lunar::TickProfiler::dumpJson(const std::string &path)
+{
+    std::ofstream outputFile(path);
+    if(outputFile.is_open() == false) {
+        std::cerr << "[PROFILE-ERROR], Unable to open file " << path << std::endl;
+        return false;
+    }
+
+    outputFile << "{\n  \"phases\": [\n";
+    for (int p {0}; p < static_cast<int>(ProfilePhase::COUNT); p++) {
+        auto &h = mPhases[p];
+        outputFile << "    {\"phase\": \"" << ProfilePhaseName.find(static_cast<ProfilePhase>(p))->second << "\""
+                   << ", \"calls\": "    << h.count
+                   << ", \"total_ns\": " << h.total
+                   << ", \"min_ns\": "   << (h.count ? h.min : 0)
+                   << ", \"max_ns\": "   << h.max
+                   << ", \"p50_ns\": "   << h.percentile(0.50)
+                   << ", \"p90_ns\": "   << h.percentile(0.90)
+                   << ", \"p99_ns\": "   << h.percentile(0.99)
+                   << ", \"buckets_log2_ns\": [";
+        for (int b {0}; b < PhaseHistogram::BUCKETS; b++) {
+            outputFile << (b ? ", " : "") << h.buckets[b];
+        }
+        outputFile << "]}" << ((p + 1 < static_cast<int>(ProfilePhase::COUNT)) ? "," : "") << "\n";
+    }
+    outputFile << "  ]\n}" << std::endl;
+
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    enum class ProfilePhase {
+        TRUCK_TICK = 0,
+        UNLOAD_STATION_TICK,
+        SCHEDULER_TICK,
+        REPORT,
+        COUNT
+    };
+
+    const static std::map<ProfilePhase, std::string> ProfilePhaseName {
+        {ProfilePhase::TRUCK_TICK,          "TruckTick"},
+        {ProfilePhase::UNLOAD_STATION_TICK, "UnloadStationTick"},
+        {ProfilePhase::SCHEDULER_TICK,      "SchedulerTick"},
+        {ProfilePhase::REPORT,              "Report"}
+    };
+
+    /**
+     * @brief Latency histogram of one phase, bucket b counts samples with bit-width b (ns < 2^b)
+     */
+    struct PhaseHistogram {
+        static const int BUCKETS {48};
+
+        unsigned long count  {0};
+        unsigned long total  {0};
+        unsigned long min    {std::numeric_limits<unsigned long>::max()};
+        unsigned long max    {0};
+        unsigned long buckets[BUCKETS] {};
+
+        void          add       (unsigned long ns);
+        unsigned long percentile(double p) const;
+    };
+
+    class TickProfiler
+    {
+        public:
+            TickProfiler() {}
+
+            virtual ~TickProfiler() {}
+
+            void add   (ProfilePhase phase, unsigned long ns);
+            void reset ();
+
+            std::string summary();
+            bool        dumpJson(const std::string &path);
+
+        private:
+            PhaseHistogram mPhases[static_cast<int>(ProfilePhase::COUNT)] {};
+    };
+
+    /**
+     * @brief It measures the life time of the scope and adds it to the phase of the profiler
+     */
+    class ScopedPhaseTimer
+    {
+        public:
+            ScopedPhaseTimer(TickProfiler &profiler, ProfilePhase phase) :
+                mProfiler(profiler), mPhase(phase), mBegin(std::chrono::steady_clock::now()) {}
+
+            ~ScopedPhaseTimer()
+            {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mBegin);
+                mProfiler.add(mPhase, ns.count());
+            }
+
+        private:
+            TickProfiler &mProfiler;
+            ProfilePhase  mPhase;
+            std::chrono::steady_clock::time_point mBegin;
+    };
+}
+
+// The instrumentation is compiled out entirely unless LUNAR_PROFILE is defined (cmake -DLUNAR_PROFILE=ON)
+#define LUNAR_PROFILE_CONCAT_(a, b) a##b
+#define LUNAR_PROFILE_CONCAT(a, b)  LUNAR_PROFILE_CONCAT_(a, b)
+
+#ifdef LUNAR_PROFILE
+    #define LUNAR_PROFILE_SCOPE(profiler, phase) \
+        Lunar::ScopedPhaseTimer LUNAR_PROFILE_CONCAT(lunarPhaseTimer, __LINE__)(profiler, phase)
+#else
+    #define LUNAR_PROFILE_SCOPE(profiler, phase)
+#endif
+
+#endif // TICK_PROFILER_H
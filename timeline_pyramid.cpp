@@ -0,0 +1,335 @@
+#include "timeline_pyramid.h"
+
+#include <cstdio>
+
+namespace {
+
+    template <typename T>
+    void writeValue(std::ostream &out, T value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool readValue(std::istream &in, T &value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+    }
+
+    const size_t HEADER_SIZE      {sizeof(Lunar::TIMELINE_PYRAMID_MAGIC) + 6 * sizeof(uint32_t) + sizeof(uint64_t)};
+    const size_t LEVEL_ENTRY_SIZE {2 * sizeof(uint32_t) + sizeof(uint64_t)};
+    const size_t STATION_SIZE     {2 * sizeof(int32_t) + sizeof(float)};
+}
+
+/**
+ * @brief Destroy the Lunar:: Timeline Pyramid Writer:: Timeline Pyramid Writer object
+ *
+ */
+Lunar::TimelinePyramidWriter::~TimelinePyramidWriter()
+{
+    close();
+}
+
+/**
+ * @brief Set up the levels for the run time and open their spool files next to the pyramid file
+ *
+ * @param path
+ * @param lastMinute the last minute that is sampled
+ * @param bucketMinutes of level 0, at least 1
+ * @return false if a spool file can't be created
+ */
+bool
+Lunar::TimelinePyramidWriter::open(const std::string &path, unsigned long lastMinute, int bucketMinutes)
+{
+    close();
+
+    mPath          = path;
+    mLastMinute    = lastMinute;
+    mNumOfStations = 0;
+
+    // add levels until the coarsest one gives the overview of the run in a few buckets
+    unsigned long width = std::max(1, bucketMinutes);
+    do {
+        auto &level = mLevels.emplace_back();
+        level.bucketMinutes = width;
+        level.spoolPath     = path + ".L" + std::to_string(mLevels.size() - 1) + ".tmp";
+        level.spool.open(level.spoolPath, std::ios::binary | std::ios::trunc);
+        if(level.spool.is_open() == false) {
+            std::cerr << "[PYRAMID-ERROR], Unable to open file " << level.spoolPath << std::endl;
+            removeSpools();
+            return false;
+        }
+        width *= TIMELINE_PYRAMID_FAN_OUT;
+    } while (lastMinute / (width / TIMELINE_PYRAMID_FAN_OUT) + 1 > TIMELINE_PYRAMID_TOP_BUCKETS &&
+             mLevels.size() < TIMELINE_PYRAMID_MAX_LEVELS);
+
+    return true;
+}
+
+/**
+ * @brief Flush the open buckets and write the pyramid file, the spool files are removed
+ *
+ * @return false if the pyramid file couldn't be written
+ */
+bool
+Lunar::TimelinePyramidWriter::close()
+{
+    if(isOpen() == false) {
+        return true;
+    }
+
+    // a flush merges the bucket into the level above, so the levels are flushed bottom up
+    for (size_t l {0}; l < mLevels.size(); l++) {
+        flush(l);
+        mLevels[l].spool.close();
+    }
+
+    auto done = assemble();
+    removeSpools();
+
+    return done;
+}
+
+/**
+ * @brief Add the state counts and the station queues of a minute to the open bucket of level 0
+ *
+ * @param minute
+ * @param trucksInState
+ * @param stationQueues
+ */
+void
+Lunar::TimelinePyramidWriter::sample(unsigned long minute, const TruckStateCounts &trucksInState,
+                                     const std::vector<int> &stationQueues)
+{
+    rollOver(0, minute);
+
+    auto &bucket = mLevels.front().open;
+    bucket.samples++;
+    for (size_t s {0}; s < trucksInState.size(); s++) {
+        bucket.stateSum[s] += trucksInState[s];
+    }
+
+    mNumOfStations = std::max(mNumOfStations, stationQueues.size());
+    if(bucket.stations.size() < stationQueues.size()) {
+        bucket.stations.resize(stationQueues.size());
+    }
+    for (size_t s {0}; s < stationQueues.size(); s++) {
+        auto len = stationQueues[s];
+        if(len < 0) {
+            continue;
+        }
+
+        auto &stat = bucket.stations[s];
+        stat.min  = (stat.samples > 0) ? std::min(stat.min, len) : len;
+        stat.max  = (stat.samples > 0) ? std::max(stat.max, len) : len;
+        stat.sum += len;
+        stat.samples++;
+    }
+}
+
+/**
+ * @brief Close the open bucket of the level if the minute is beyond it and start the bucket of the minute
+ *
+ * @param level
+ * @param minute
+ */
+void
+Lunar::TimelinePyramidWriter::rollOver(size_t level, unsigned long minute)
+{
+    auto &lvl = mLevels[level];
+    if(lvl.open.samples > 0 && minute >= lvl.open.start + lvl.bucketMinutes) {
+        flush(level);
+    }
+    if(lvl.open.samples == 0) {
+        lvl.open.start = minute / lvl.bucketMinutes * lvl.bucketMinutes;
+    }
+}
+
+/**
+ * @brief Spool the open bucket of the level and merge it into the bucket of the level above
+ *
+ * @param level
+ */
+void
+Lunar::TimelinePyramidWriter::flush(size_t level)
+{
+    auto &lvl = mLevels[level];
+    if(lvl.open.samples == 0) {
+        return;
+    }
+
+    writeValue(lvl.spool, static_cast<uint32_t>(lvl.open.start / lvl.bucketMinutes));
+    writeValue(lvl.spool, static_cast<uint32_t>(lvl.open.stations.size()));
+    writeRecord(lvl.spool, lvl.open);
+
+    if(level + 1 < mLevels.size()) {
+        rollOver(level + 1, lvl.open.start);
+        merge(mLevels[level + 1].open, lvl.open);
+    }
+
+    // the station aggregates keep their capacity, the next bucket doesn't allocate
+    lvl.open.samples = 0;
+    lvl.open.stateSum.fill(0);
+    std::ranges::fill(lvl.open.stations, StationAggregate());
+}
+
+/**
+ * @brief Merge a closed bucket into the bucket of the level above
+ *
+ * @param dst
+ * @param src
+ */
+void
+Lunar::TimelinePyramidWriter::merge(Bucket &dst, const Bucket &src)
+{
+    dst.samples += src.samples;
+    for (size_t s {0}; s < src.stateSum.size(); s++) {
+        dst.stateSum[s] += src.stateSum[s];
+    }
+
+    if(dst.stations.size() < src.stations.size()) {
+        dst.stations.resize(src.stations.size());
+    }
+    for (size_t s {0}; s < src.stations.size(); s++) {
+        const auto &from = src.stations[s];
+        auto       &to   = dst.stations[s];
+        if(from.samples == 0) {
+            continue;
+        }
+
+        to.min      = (to.samples > 0) ? std::min(to.min, from.min) : from.min;
+        to.max      = (to.samples > 0) ? std::max(to.max, from.max) : from.max;
+        to.sum     += from.sum;
+        to.samples += from.samples;
+    }
+}
+
+/**
+ * @brief Write the record of a bucket with its own stations
+ *
+ * @param out
+ * @param bucket
+ */
+void
+Lunar::TimelinePyramidWriter::writeRecord(std::ostream &out, const Bucket &bucket)
+{
+    writeValue(out, bucket.samples);
+    for (auto sum : bucket.stateSum) {
+        writeValue(out, static_cast<float>((bucket.samples > 0) ? static_cast<double>(sum) / bucket.samples : 0.0));
+    }
+
+    for (const auto &stat : bucket.stations) {
+        if(stat.samples == 0) {
+            writeEmptyStations(out, 1);
+            continue;
+        }
+        writeValue(out, stat.min);
+        writeValue(out, stat.max);
+        writeValue(out, static_cast<float>(static_cast<double>(stat.sum) / stat.samples));
+    }
+}
+
+/**
+ * @brief Write the entries of stations that weren't open in a bucket
+ *
+ * @param out
+ * @param count
+ */
+void
+Lunar::TimelinePyramidWriter::writeEmptyStations(std::ostream &out, size_t count)
+{
+    for (size_t s {0}; s < count; s++) {
+        writeValue(out, int32_t {-1});
+        writeValue(out, int32_t {-1});
+        writeValue(out, float {-1.0f});
+    }
+}
+
+/**
+ * @brief Write the header, the level table and the levels (coarsest first) from the spool files.
+ *          The records get the same size: the buckets missing in a spool file are written empty,
+ *          the stations opened after a bucket are padded.
+ *
+ * @return true
+ * @return false
+ */
+bool
+Lunar::TimelinePyramidWriter::assemble()
+{
+    std::ofstream out(mPath, std::ios::binary | std::ios::trunc);
+    if(out.is_open() == false) {
+        std::cerr << "[PYRAMID-ERROR], Unable to open file " << mPath << std::endl;
+        return false;
+    }
+
+    auto numOfStates = static_cast<size_t>(TruckState::COUNT);
+    auto recordSize  = sizeof(uint32_t) + numOfStates * sizeof(float) + mNumOfStations * STATION_SIZE;
+    auto bucketsOf   = [this] (const Level &lvl) { return mLastMinute / lvl.bucketMinutes + 1; };
+
+    out.write(TIMELINE_PYRAMID_MAGIC, sizeof(TIMELINE_PYRAMID_MAGIC));
+    writeValue(out, TIMELINE_PYRAMID_VERSION);
+    writeValue(out, static_cast<uint32_t>(mLevels.size()));
+    writeValue(out, static_cast<uint32_t>(numOfStates));
+    writeValue(out, static_cast<uint32_t>(mNumOfStations));
+    writeValue(out, static_cast<uint32_t>(recordSize));
+    writeValue(out, static_cast<uint32_t>(mLevels.front().bucketMinutes));
+    writeValue(out, static_cast<uint64_t>(mLastMinute));
+
+    uint64_t offset = HEADER_SIZE + mLevels.size() * LEVEL_ENTRY_SIZE;
+    for (auto it = mLevels.rbegin(); it != mLevels.rend(); it++) {
+        writeValue(out, static_cast<uint32_t>(it->bucketMinutes));
+        writeValue(out, static_cast<uint32_t>(bucketsOf(*it)));
+        writeValue(out, offset);
+        offset += bucketsOf(*it) * recordSize;
+    }
+
+    Bucket empty;
+    std::vector<char> record;
+    for (auto it = mLevels.rbegin(); it != mLevels.rend(); it++) {
+        std::ifstream spool(it->spoolPath, std::ios::binary);
+        uint32_t next {0};
+        uint32_t idx  {0};
+        uint32_t numOfStations {0};
+        while (readValue(spool, idx) && readValue(spool, numOfStations) && idx < bucketsOf(*it)) {
+            for (; next < idx; next++) {
+                writeRecord(out, empty);
+                writeEmptyStations(out, mNumOfStations);
+            }
+
+            record.resize(sizeof(uint32_t) + numOfStates * sizeof(float) + numOfStations * STATION_SIZE);
+            if(spool.read(record.data(), record.size()).good() == false) {
+                break;
+            }
+            out.write(record.data(), record.size());
+            writeEmptyStations(out, mNumOfStations - numOfStations);
+            next++;
+        }
+        for (; next < bucketsOf(*it); next++) {
+            writeRecord(out, empty);
+            writeEmptyStations(out, mNumOfStations);
+        }
+    }
+
+    if(out.good() == false) {
+        std::cerr << "[PYRAMID-ERROR], Unable to write file " << mPath << std::endl;
+        return false;
+    }
+
+    std::cerr << "[PYRAMID-INFO], File:" << mPath << ", Levels:" << mLevels.size()
+              << ", Bytes:" << offset << std::endl;
+    return true;
+}
+
+/**
+ * @brief Remove the spool files and drop the levels
+ *
+ */
+void
+Lunar::TimelinePyramidWriter::removeSpools()
+{
+    for (auto &lvl : mLevels) {
+        lvl.spool.close();
+        std::remove(lvl.spoolPath.c_str());
+    }
+    mLevels.clear();
+}
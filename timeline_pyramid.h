@@ -0,0 +1,86 @@
+#ifndef TIMELINE_PYRAMID_H
+#define TIMELINE_PYRAMID_H
+
+#include "service_include.h"
+
+#include <array>
+
+namespace Lunar {
+
+    const char     TIMELINE_PYRAMID_MAGIC[8] {'L', 'U', 'N', 'A', 'R', 'L', 'O', 'D'};
+    const uint32_t TIMELINE_PYRAMID_VERSION  {1};
+
+    using TruckStateCounts = std::array<uint32_t, static_cast<size_t>(TruckState::COUNT)>;
+
+    /**
+     * @brief Level-of-detail timeline of a run: per time bucket the mean number of trucks in each state and
+     *          the min/max/mean queue length of each unload station, at several zoom levels.
+     *          Level 0 has buckets of bucketMinutes, each next level merges TIMELINE_PYRAMID_FAN_OUT buckets of the level below,
+     *          up to the level of at most TIMELINE_PYRAMID_TOP_BUCKETS buckets.
+     *          Only the open bucket of each level is kept in memory, a closed bucket is spooled to a temporary file of its level.
+     *          close() writes the pyramid file, the coarsest level first:
+     *
+     *          header: magic "LUNARLOD", uint32 version, numOfLevels, numOfStates, numOfStations, recordSize, bucketMinutes,
+     *                  uint64 lastMinute (host byte order, the states in the order of TruckState)
+     *          levels: uint32 bucketMinutes, numOfBuckets, uint64 offset of the records, coarsest first
+     *          records of a level, bucket i starts at minute i * bucketMinutes:
+     *                  uint32 samples (sampled minutes, 0: no data), float mean trucks per state,
+     *                  per station int32 min, int32 max, float mean queue length (-1: the station wasn't open)
+     */
+    class TimelinePyramidWriter
+    {
+        public:
+            TimelinePyramidWriter() {}
+            TimelinePyramidWriter(const TimelinePyramidWriter &) = delete;
+            TimelinePyramidWriter &operator=(const TimelinePyramidWriter &) = delete;
+            virtual ~TimelinePyramidWriter();
+
+            bool open  (const std::string &path, unsigned long lastMinute, int bucketMinutes);
+            bool close ();
+            bool isOpen() const { return mLevels.empty() == false; }
+
+            // one sample per simulated minute, stationQueues by station index, -1: closed station
+            void sample(unsigned long minute, const TruckStateCounts &trucksInState, const std::vector<int> &stationQueues);
+
+            size_t numOfLevels() const { return mLevels.size(); }
+
+        protected:
+            struct StationAggregate {
+                int32_t  min     {0};
+                int32_t  max     {0};
+                uint64_t sum     {0};
+                uint32_t samples {0};
+            };
+
+            struct Bucket {
+                unsigned long                 start    {0};
+                uint32_t                      samples  {0};
+                std::array<uint64_t, static_cast<size_t>(TruckState::COUNT)> stateSum {};
+                std::vector<StationAggregate> stations {};
+            };
+
+            struct Level {
+                unsigned long bucketMinutes {0};
+                uint32_t      numOfBuckets  {0};    // spooled, incl. the empty ones before a bucket
+                Bucket        open          {};
+                std::string   spoolPath     {};
+                std::ofstream spool         {};
+            };
+
+            void rollOver (size_t level, unsigned long minute);
+            void flush    (size_t level);
+            void merge    (Bucket &dst, const Bucket &src);
+            void writeRecord       (std::ostream &out, const Bucket &bucket);
+            void writeEmptyStations(std::ostream &out, size_t count);
+            bool assemble ();
+            void removeSpools();
+
+        private:
+            std::string        mPath          {};
+            unsigned long      mLastMinute    {0};
+            size_t             mNumOfStations {0};      // station indices seen
+            std::vector<Level> mLevels        {};
+    };
+}
+
+#endif // TIMELINE_PYRAMID_H
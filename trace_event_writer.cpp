@@ -0,0 +1,267 @@
+#include "trace_event_writer.h"
+
+/**
+ * @brief Destroy the Lunar:: Trace Event Writer:: Trace Event Writer object
+ *
+ */
+Lunar::TraceEventWriter::~TraceEventWriter()
+{
+    close();
+}
+
+/**
+ * @brief Open the trace file and write the trace header
+ *
+ * @param path
+ * @return true
+ * @return false
+ */
+bool
+Lunar::TraceEventWriter::open(const std::string &path)
+{
+    mOutputFile.open(path);
+    if(mOutputFile.is_open() == false) {
+        std::cerr << "[TRACE-ERROR], Unable to open file " << path << std::endl;
+        return false;
+    }
+
+    mFirstEvent = true;
+    mOutputFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    beginEvent();
+    mOutputFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << TRUCK_PID   << ",\"args\":{\"name\":\"Trucks\"}}";
+    beginEvent();
+    mOutputFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << STATION_PID << ",\"args\":{\"name\":\"UnloadStations\"}}";
+
+    return true;
+}
+
+/**
+ * @brief Close all open spans at the last seen minute and terminate the JSON document
+ *
+ */
+void
+Lunar::TraceEventWriter::close()
+{
+    if(mOutputFile.is_open() == false) {
+        return;
+    }
+
+    auto end = mLastMinute + 1;
+    for (int t {0}; t < static_cast<int>(mTruckSpans.size()); t++) {
+        auto &span = mTruckSpans[t];
+        if(span.state >= 0) {
+            writeSpan(TRUCK_PID, t + 1, TruckStateName.find(static_cast<TruckState>(span.state))->second, span, end);
+        }
+    }
+    for (int s {0}; s < static_cast<int>(mBaySpans.size()); s++) {
+        for (int b {0}; b < static_cast<int>(mBaySpans[s].size()); b++) {
+            auto &span = mBaySpans[s][b];
+            if(span.state >= 0) {
+                writeSpan(STATION_PID, stationTid(s, b), UnloadStationStateName.at(UnloadStationState::UNLOADING), span, end);
+            }
+        }
+    }
+
+    mOutputFile << "]}" << std::endl;
+    mOutputFile.close();
+
+    mTruckSpans.clear();
+    mBaySpans.clear();
+    mStationQueues.clear();
+}
+
+/**
+ * @brief Check if the trace is open
+ *
+ * @return true
+ * @return false
+ */
+bool
+Lunar::TraceEventWriter::isOpen()
+{
+    return mOutputFile.is_open();
+}
+
+/**
+ * @brief Update the state of a truck, the previous span is written if the state changed.
+ *          IDEL and UNLOADING_DONE are instantaneous and don't open a span.
+ *
+ * @param idx
+ * @param trkId
+ * @param state
+ * @param minute
+ */
+void
+Lunar::TraceEventWriter::truckState(int idx, const std::string &trkId, TruckState state, unsigned long minute)
+{
+    if(mOutputFile.is_open() == false) {
+        return;
+    }
+
+    if(idx >= static_cast<int>(mTruckSpans.size())) {
+        mTruckSpans.resize(idx + 1);
+        writeThread(TRUCK_PID, idx + 1, trkId);
+    }
+
+    mLastMinute = std::max(mLastMinute, minute);
+
+    auto &span = mTruckSpans[idx];
+    int   next = (state == TruckState::IDEL || state == TruckState::UNLOADING_DONE) ? -1 : static_cast<int>(state);
+    if(span.state == next) {
+        return;
+    }
+
+    if(span.state >= 0) {
+        writeSpan(TRUCK_PID, idx + 1, TruckStateName.find(static_cast<TruckState>(span.state))->second, span, minute);
+    }
+
+    span.state = next;
+    span.start = minute;
+}
+
+/**
+ * @brief Update the bays of an unload-station, a bay span is written when its truck leaves the bay
+ *          and a truck that entered a bay takes the first free bay track.
+ *          The queue length is written as counter track whenever it changes.
+ *
+ * @param idx
+ * @param statId
+ * @param numOfBays
+ * @param unloadingTrucks trucks in the bays
+ * @param queueLen
+ * @param minute
+ */
+void
+Lunar::TraceEventWriter::stationState(int idx, const std::string &statId, int numOfBays,
+                                      const std::vector<const std::string *> &unloadingTrucks, int queueLen, unsigned long minute)
+{
+    if(mOutputFile.is_open() == false) {
+        return;
+    }
+
+    if(idx >= static_cast<int>(mBaySpans.size())) {
+        mBaySpans.resize(idx + 1);
+        mStationQueues.resize(idx + 1, -1);
+        writeThread(STATION_PID, stationTid(idx), statId);
+    }
+
+    auto &bays = mBaySpans[idx];
+    for (int b = bays.size(); b < numOfBays; b++) {
+        bays.emplace_back();
+        writeThread(STATION_PID, stationTid(idx, b), statId + " Bay " + std::to_string(b + 1));
+    }
+
+    mLastMinute = std::max(mLastMinute, minute);
+
+    if(mStationQueues[idx] != queueLen) {
+        mStationQueues[idx] = queueLen;
+        writeCounter(stationTid(idx), statId, queueLen, minute);
+    }
+
+    auto isUnloading = [&unloadingTrucks] (const std::string &trkId) {
+        return std::ranges::any_of(unloadingTrucks, [&trkId] (const std::string *id) { return *id == trkId; });
+    };
+
+    // the trucks that left their bay
+    for (int b {0}; b < static_cast<int>(bays.size()); b++) {
+        auto &span = bays[b];
+        if(span.state >= 0 && isUnloading(span.detail) == false) {
+            writeSpan(STATION_PID, stationTid(idx, b), UnloadStationStateName.at(UnloadStationState::UNLOADING), span, minute);
+            span.state = -1;
+            span.detail.clear();
+        }
+    }
+
+    // the trucks that entered a bay
+    for (auto *trkId : unloadingTrucks) {
+        if(std::ranges::any_of(bays, [trkId] (const Span &span) { return span.state >= 0 && span.detail == *trkId; })) {
+            continue;
+        }
+
+        auto free = std::ranges::find_if(bays, [] (const Span &span) { return span.state < 0; });
+        if(free == bays.end()) {
+            continue;
+        }
+        free->state  = static_cast<int>(UnloadStationState::UNLOADING);
+        free->start  = minute;
+        free->detail = *trkId;
+    }
+}
+
+/**
+ * @brief Write the separator between two events
+ *
+ */
+void
+Lunar::TraceEventWriter::beginEvent()
+{
+    mOutputFile << (mFirstEvent ? "\n" : ",\n");
+    mFirstEvent = false;
+}
+
+/**
+ * @brief Write a complete event ("X") for the span [span.start, end)
+ *
+ * @param pid
+ * @param tid
+ * @param name
+ * @param span
+ * @param end
+ */
+void
+Lunar::TraceEventWriter::writeSpan(int pid, long tid, const std::string &name, const Span &span, unsigned long end)
+{
+    beginEvent();
+    mOutputFile << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+                << ",\"ts\":"  << toMicroSeconds(span.start)
+                << ",\"dur\":" << toMicroSeconds(end - span.start);
+    if(span.detail.empty() == false) {
+        mOutputFile << ",\"args\":{\"truck\":\"" << span.detail << "\"}";
+    }
+    mOutputFile << "}";
+}
+
+/**
+ * @brief Write the name of a truck/station track
+ *
+ * @param pid
+ * @param tid
+ * @param name
+ */
+void
+Lunar::TraceEventWriter::writeThread(int pid, long tid, const std::string &name)
+{
+    beginEvent();
+    mOutputFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+                << ",\"args\":{\"name\":\"" << name << "\"}}";
+}
+
+/**
+ * @brief Write the queue length of a station as counter event ("C")
+ *
+ * @param tid
+ * @param statId
+ * @param queueLen
+ * @param minute
+ */
+void
+Lunar::TraceEventWriter::writeCounter(long tid, const std::string &statId, int queueLen, unsigned long minute)
+{
+    beginEvent();
+    mOutputFile << "{\"name\":\"" << statId << " TrucksInQueue\",\"ph\":\"C\",\"pid\":" << STATION_PID
+                << ",\"tid\":" << tid << ",\"ts\":" << toMicroSeconds(minute)
+                << ",\"args\":{\"trucks\":" << queueLen << "}}";
+}
+
+/**
+ * @brief Trace timestamps are in micro-seconds of simulated time
+ *
+ * @param minute
+ * @return unsigned long
+ */
+unsigned long
+Lunar::TraceEventWriter::toMicroSeconds(unsigned long minute)
+{
+    return minute * 60UL * 1000000UL;
+}
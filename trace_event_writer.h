@@ -0,0 +1,59 @@
+#ifndef TRACE_EVENT_WRITER_H
+#define TRACE_EVENT_WRITER_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    /**
+     * @brief It streams truck and unload-station timelines as Chrome trace-event JSON
+     *          (chrome://tracing, ui.perfetto.dev).
+     *          A span is written when the entity leaves the state, so the memory is bounded
+     *          by the number of entities and not by the length of the run.
+     *          Each bay of a station has its own track, so a multi-bay station shows all the trucks it unloads at once.
+     */
+    class TraceEventWriter
+    {
+        public:
+            TraceEventWriter() {}
+
+            virtual ~TraceEventWriter();
+
+            bool open (const std::string &path);
+            void close();
+            bool isOpen();
+
+            void truckState  (int idx, const std::string &trkId, TruckState state, unsigned long minute);
+            void stationState(int idx, const std::string &statId, int numOfBays,
+                              const std::vector<const std::string *> &unloadingTrucks, int queueLen, unsigned long minute);
+
+        protected:
+            struct Span {
+                int           state  {-1};
+                unsigned long start  {0};
+                std::string   detail {};
+            };
+
+            static const int  TRUCK_PID    {1};
+            static const int  STATION_PID  {2};
+            static const long STATION_TIDS {1L << 20};     // tids of a station: the queue track and one per bay
+
+            void beginEvent   ();
+            void writeSpan    (int pid, long tid, const std::string &name, const Span &span, unsigned long end);
+            void writeThread  (int pid, long tid, const std::string &name);
+            void writeCounter (long tid, const std::string &statId, int queueLen, unsigned long minute);
+
+            static unsigned long toMicroSeconds(unsigned long minute);
+            static long stationTid(int idx, int bay = -1) { return (idx + 1) * STATION_TIDS + bay + 1; }
+
+        private:
+            std::ofstream     mOutputFile;
+            bool              mFirstEvent {true};
+            unsigned long     mLastMinute {0};
+            std::vector<Span> mTruckSpans;
+            std::vector<std::vector<Span>> mBaySpans;
+            std::vector<int>  mStationQueues;
+    };
+}
+
+#endif // TRACE_EVENT_WRITER_H
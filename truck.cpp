@@ -38,18 +38,31 @@ Lunar::Truck::tick()
    switch (mState)
    {
       case TruckState::IDEL:
+         // the clock restarts with every cycle, the offset keeps the minute of the service clock
+         mClockOffset += PROCESS_CLOCK;
          PROCESS_CLOCK = 0;
          startLoading();
       break;
 
       case TruckState::LOADING:
-         if(isLoadingDone()) {
+         if(isLoadingDone() && mRouted) {
+            // routed trucks ask for an unload-station at the site
+            mUnLoadStationArrivalTime = PROCESS_CLOCK;
+            mState = TruckState::WAITING_FOR_UNLOAD_STATION;
+         }
+         else if(isLoadingDone()) {
             startDriving();
          }
       break;
 
       case TruckState::DRIVING:
-         if(isDrivingDone()) {
+         if(isDrivingDone() && hasUnloadingStation()) {
+            // arrived at the assigned unload-station, join its queue
+            mUnLoadStationArrivalTime = PROCESS_CLOCK;
+            mUnloadingStartTime       = PROCESS_CLOCK;
+            mState = TruckState::UNLOADING;
+         }
+         else if(isDrivingDone()) {
             mUnLoadStationArrivalTime = PROCESS_CLOCK;
             mState = TruckState::WAITING_FOR_UNLOAD_STATION;
          }
@@ -85,7 +98,7 @@ Lunar::Truck::startLoading()
 {
    mLoadingStartTime = PROCESS_CLOCK;
    mState            = TruckState::LOADING;
-   mLoadingTime      = generateLoadingTime();
+   mLoadingTime      = mSeeded ? generateLoadingTime(mRng) : generateLoadingTime();
 }
 
 /**
@@ -168,7 +181,7 @@ Lunar::Truck::drivingTimeLeft()
       return 0;
    }
 
-   return (mDrivingStartTime + Lunar::DRIVE_TIME_MINUTES) - PROCESS_CLOCK;
+   return (mDrivingStartTime + mDriveTime) - PROCESS_CLOCK;
 }
 
 /**
@@ -181,7 +194,7 @@ bool
 Lunar::Truck::isDrivingDone()
 {
    if(mState == TruckState::DRIVING &&
-      (PROCESS_CLOCK >= (mDrivingStartTime + Lunar::DRIVE_TIME_MINUTES))) {
+      (PROCESS_CLOCK >= (mDrivingStartTime + mDriveTime))) {
       return true;
    }
 
@@ -216,13 +229,26 @@ Lunar::Truck::timeWaitingForUnLoadStation()
 
 /**
  * @brief Callback-method for scheduler to assign unload-station
- *          and initialize parameters for the unloading task
+ *          and initialize parameters for the unloading task,
+ *          a routed truck drives to the station first
  * @param sId
+ * @param sIdx
+ * @param driveTime drive time to the station, 0 if the truck is at the station already
  */
 void
-Lunar::Truck::assignUnloadStation(std::string sId)
+Lunar::Truck::assignUnloadStation(const std::string &sId, int sIdx, int driveTime)
 {
    mUnloadStationId    = sId;
+   mUnloadStationIdx   = sIdx;
+   mDetourTime         = 0;
+
+   if(driveTime > 0) {
+      mDriveTime        = driveTime;
+      mDrivingStartTime = PROCESS_CLOCK;
+      mState            = TruckState::DRIVING;
+      return;
+   }
+
    mState              = TruckState::UNLOADING;
    mUnloadingStartTime = PROCESS_CLOCK;
 }
@@ -242,9 +268,9 @@ Lunar::Truck::hasUnloadingStation()
 /**
  * @brief Return the truck's unload-station
  *
- * @return std::string
+ * @return const std::string&
  */
-std::string
+const std::string &
 Lunar::Truck::unloadStationID()
 {
    return mUnloadStationId;
@@ -282,6 +308,35 @@ Lunar::Truck::unloadingDone()
    mState = TruckState::UNLOADING_DONE;
 }
 
+/**
+ * @brief Callback method for the controller if the truck was taken off the queue of its unload-station,
+ *          the truck waits for the scheduler to assign another unload-station
+ *
+ */
+void
+Lunar::Truck::releaseUnloadStation()
+{
+   if(mState != TruckState::UNLOADING && mState != TruckState::DRIVING) {
+      return;
+   }
+
+   mUnloadStationId.clear();
+   mUnloadStationIdx   = -1;
+   mUnloadingStartTime = 0;
+
+   // a routed truck on its way turns back and is dispatched again right away,
+   // the road to the next station leads over its site, so the minutes driven so far are added to that drive
+   if(mState == TruckState::DRIVING && mRouted) {
+      mDetourTime               = PROCESS_CLOCK - mDrivingStartTime;
+      mUnLoadStationArrivalTime = PROCESS_CLOCK;
+      mState = TruckState::WAITING_FOR_UNLOAD_STATION;
+   }
+   // an unrouted truck on its way keeps driving and asks for a station when it arrives
+   else if(mState == TruckState::UNLOADING) {
+      mState = TruckState::WAITING_FOR_UNLOAD_STATION;
+   }
+}
+
 /**
  * @brief Calculates how much of the unloading time left
  *
@@ -291,7 +346,7 @@ long
 Lunar::Truck::unloadingTimeLeft()
 {
    if(mState == TruckState::UNLOADING) {
-      return (mUnloadingStartTime + Lunar::UNLOAD_TIME_MINUTES) - PROCESS_CLOCK;
+      return (mUnloadingStartTime + mUnloadTime) - PROCESS_CLOCK;
    }
 
    return 0;
@@ -320,52 +375,41 @@ Lunar::Truck::numOfDeliveries()
 }
 
 /**
- * @brief Construct a new Lunar:: Truck:: Truck object
+ * @brief Returns the sum of the wait times of all deliveries
  *
- * @param trk
+ * @return long
  */
-Lunar::Truck::Truck(const Truck &trk)
+long
+Lunar::Truck::totalWaitTime()
 {
-   mId               = trk.mId;
-   mState            = trk.mState;
-   mLoadingStartTime = trk.mLoadingStartTime;
-   mLoadingTime      = trk.mLoadingTime;
-   mDrivingStartTime = trk.mDrivingStartTime;
-   mUnLoadStationArrivalTime = trk.mUnLoadStationArrivalTime;
-   mUnloadingStartTime = trk.mUnloadingStartTime;
-   mUnloadStationId    = trk.mUnloadingStartTime;
-   mDeliveryCompleted  = trk.mDeliveryCompleted;
-   PROCESS_CLOCK       = trk.PROCESS_CLOCK;
-   mServiceErrors      = trk.mServiceErrors;
+   return mTotalWaitTime;
 }
 
+/**
+ * @brief Reserve the unload-station id, so the truck doesn't allocate while the simulation runs
+ *
+ * @param stationIdLen
+ */
+void
+Lunar::Truck::reserve(int stationIdLen)
+{
+   mUnloadStationId.reserve(stationIdLen);
+}
 
 /**
- * @brief  Assignment operator
+ * @brief Pre-allocate the chunks of n delivery log entries in the memory resource,
+ *          a pool keeps the released chunks, so the logs of the fleet draw from them while the simulation runs
  *
- * @param trk
- * @return Lunar::Truck&
+ * @param historyRes
+ * @param n
  */
-Lunar::Truck &
-Lunar::Truck::operator=(const Truck &trk)
+void
+Lunar::Truck::reserveLogEntries(std::pmr::memory_resource *historyRes, long n)
 {
-   if(this == &trk) {
-      return *this;
+   std::pmr::deque<TruckDeliveryLog> entries(historyRes);
+   for (long i {0}; i < n; i++) {
+      entries.emplace_back();
    }
-
-   mId               = trk.mId;
-   mState            = trk.mState;
-   mLoadingStartTime = trk.mLoadingStartTime;
-   mLoadingTime      = trk.mLoadingTime;
-   mDrivingStartTime = trk.mDrivingStartTime;
-   mUnLoadStationArrivalTime = trk.mUnLoadStationArrivalTime;
-   mUnloadingStartTime = trk.mUnloadingStartTime;
-   mUnloadStationId    = trk.mUnloadingStartTime;
-   mDeliveryCompleted  = trk.mDeliveryCompleted;
-   PROCESS_CLOCK       = trk.PROCESS_CLOCK;
-   mServiceErrors      = trk.mServiceErrors;
-
-   return *this;
 }
 
 /**
@@ -378,7 +422,8 @@ Lunar::Truck::finalizeDelivery()
    mDeliveryCompleted++;
 
    auto waitTime = PROCESS_CLOCK - mUnLoadStationArrivalTime;
-   mWaitTimeLst.push_back(std::pair<std::string, int>(mUnloadStationId, waitTime));
+   mWaitTimeLst.push_back(TruckDeliveryLog(mUnloadStationIdx, waitTime, mClockOffset + PROCESS_CLOCK));
+   mTotalWaitTime += waitTime;
    reset();
 }
 
@@ -394,16 +439,18 @@ Lunar::Truck::reset()
    mDrivingStartTime = 0;
    mUnLoadStationArrivalTime = 0;
    mUnloadingStartTime = 0;
-   mUnloadStationId    = "";
+   mUnloadStationId.clear();
+   mUnloadStationIdx   = -1;
+   mDetourTime         = 0;
    mState              = TruckState::IDEL;
 }
 
 /**
  * @brief Return truck-id
  *
- * @return std::string
+ * @return const std::string&
  */
-std::string
+const std::string &
 Lunar::Truck::id()
 {
    return mId;
@@ -420,6 +467,126 @@ Lunar::Truck::setId(std::string name)
    mId = name;
 }
 
+/**
+ * @brief Set truck index, position of the truck in the fleet
+ *
+ * @param idx
+ */
+void
+Lunar::Truck::setIndex(int idx)
+{
+   mIndex = idx;
+}
+
+/**
+ * @brief Return truck index
+ *
+ * @return int
+ */
+int
+Lunar::Truck::index()
+{
+   return mIndex;
+}
+
+/**
+ * @brief Seed the truck's own loading-time generator,
+ *          the stream is keyed by the truck index so every engine draws the same loading times
+ *          regardless of the order it ticks the trucks
+ *
+ * @param seed
+ */
+void
+Lunar::Truck::setRandomSeed(unsigned long seed)
+{
+   mRng    = RandomStream(seed, mIndex);
+   mSeeded = true;
+}
+
+/**
+ * @brief Set the attributes of the truck class
+ *
+ * @param cls
+ */
+void
+Lunar::Truck::setClass(const TruckClass &cls)
+{
+   mPayload      = cls.payload;
+   mSpeedPercent = std::max(cls.speedPercent, 1);
+   mUnloadTime   = cls.unloadMinutes;
+   mDriveTime    = scaledDriveTime(Lunar::DRIVE_TIME_MINUTES);
+}
+
+/**
+ * @brief Set the mining site the truck loads at
+ *
+ * @param site
+ * @param routed true: the truck is dispatched at the site and drives to the assigned station
+ */
+void
+Lunar::Truck::setHomeSite(int site, bool routed)
+{
+   mHomeSite = site;
+   mRouted   = routed;
+}
+
+/**
+ * @brief Return the mining site the truck loads at
+ *
+ * @return int
+ */
+int
+Lunar::Truck::homeSite()
+{
+   return mHomeSite;
+}
+
+/**
+ * @brief Return the minutes the truck needs back to its site before its next drive,
+ *          non-zero after its station closed while it was on the way
+ *
+ * @return int
+ */
+int
+Lunar::Truck::detourTime()
+{
+   return mDetourTime;
+}
+
+/**
+ * @brief Return the payload (tons) per delivery
+ *
+ * @return int
+ */
+int
+Lunar::Truck::payload()
+{
+   return mPayload;
+}
+
+/**
+ * @brief Return the unloading time of the truck
+ *
+ * @return int
+ */
+int
+Lunar::Truck::unloadTime()
+{
+   return mUnloadTime;
+}
+
+/**
+ * @brief Scale a drive time by the speed of the truck
+ *
+ * @param minutes drive time at TRUCK_SPEED_PERCENT
+ * @return int
+ */
+int
+Lunar::Truck::scaledDriveTime(int minutes)
+{
+   return (minutes * Lunar::TRUCK_SPEED_PERCENT + mSpeedPercent - 1) / mSpeedPercent;
+}
+
 /**
  * @brief Return truck current state
  *
@@ -494,29 +661,62 @@ Lunar::Truck::report()
 }
 
 /**
- * @brief Generate simple summary of all deliveries
+ * @brief Generate simple summary of all deliveries,
+ *          with a warm-up the deliveries done after it are summarized as steady-state
  *
+ * @param warmUpTime minute of the service clock, 0: no warm-up
  * @return std::string
  */
 std::string
-Lunar::Truck::summary()
+Lunar::Truck::summary(long warmUpTime)
 {
    std::stringstream ss;
 
    auto runTime      {Lunar::hourToMinutes(Lunar::SIMULATION_TIME_HOURS)};
    int avgDelivery   = (mDeliveryCompleted > 0) ? (runTime/ mDeliveryCompleted) : 0;
-   int totalWaitTime {0};
-
-   if(mWaitTimeLst.size() > 0) {
-      std::ranges::for_each(mWaitTimeLst, [&totalWaitTime] (std::pair<std::string, int> &t)
-                           { totalWaitTime += t.second; });
-   }
+   long totalWaitTime {mTotalWaitTime};
 
    ss << "[T-SUMMARY], " << mId << ", TotalRunTime:"<< runTime << ":min, "
       << "NumOfDelivery:"        << mDeliveryCompleted         << ", "
       << "AverageDeliveryTime:"  << avgDelivery                << ":min, "
-      << "TotalWaitTime:"        << totalWaitTime              << ":min"
-      << std::endl;
+      << "TotalWaitTime:"        << totalWaitTime              << ":min";
+
+   if(warmUpTime > 0) {
+      int  steadyDeliveries {0};
+      long steadyWaitTime   {0};
+      for (auto &log : mWaitTimeLst) {
+         if(log.doneTime > warmUpTime) {
+            steadyDeliveries++;
+            steadyWaitTime += log.waitTime;
+         }
+      }
+      ss << ", SteadyStateDelivery:" << steadyDeliveries << ", "
+         << "SteadyStateWaitTime:"   << steadyWaitTime   << ":min";
+   }
+   ss << std::endl;
 
    return ss.rdbuf()->str();
 }
+
+/**
+ * @brief Set the minute of the service clock the truck is started,
+ *          the delivery log is kept in minutes of the service clock
+ *
+ * @param minute
+ */
+void
+Lunar::Truck::setStartTime(unsigned long minute)
+{
+   mClockOffset = minute;
+}
+
+/**
+ * @brief Returns the station, wait and done minute of each delivery
+ *
+ * @return const std::pmr::deque<Lunar::TruckDeliveryLog>&
+ */
+const std::pmr::deque<Lunar::TruckDeliveryLog> &
+Lunar::Truck::deliveryLog()
+{
+   return mWaitTimeLst;
+}
@@ -9,9 +9,13 @@ namespace Lunar {
         public:
             Truck() {}
 
-            Truck(std::string id) : mId(id) {}
-            Truck(const Truck &trk);
-            Truck &operator=(const Truck &trk);
+            Truck(std::string id, std::pmr::memory_resource *historyRes = std::pmr::get_default_resource()) :
+                mId(id), mWaitTimeLst(historyRes) {}
+            Truck(const Truck &trk)            = default;
+            // the moved log keeps its resource, noexcept lets the SlotMap storage move the trucks when it grows
+            Truck(Truck &&trk) noexcept        = default;
+            Truck &operator=(const Truck &trk) = default;
+            Truck &operator=(Truck &&trk)      = default;
 
             virtual ~Truck();
 
@@ -19,7 +23,17 @@ namespace Lunar {
             void tick ();
             void reset();
             void setId (std::string id);
-            std::string id();
+            const std::string &id();
+            void setIndex(int idx);
+            int  index ();
+            void setRandomSeed(unsigned long seed);
+            void setClass   (const TruckClass &cls);
+            void setHomeSite(int site, bool routed);
+            int  homeSite   ();
+            int  detourTime ();
+            int  payload    ();
+            int  unloadTime ();
+            int  scaledDriveTime(int minutes);
 
             void setState   (TruckState stat);
             TruckState state();
@@ -32,16 +46,23 @@ namespace Lunar {
 
             bool isWaitingForUnloadStation();
             long timeWaitingForUnLoadStation();
-            void assignUnloadStation(std::string sId);
+            void assignUnloadStation(const std::string &sId, int sIdx, int driveTime = 0);
             bool hasUnloadingStation();
-            std::string unloadStationID();
+            const std::string &unloadStationID();
             long unloadingTimeLeft();
             void unloadingDone();
+            void releaseUnloadStation();
 
             int  numOfDeliveries();
+            long totalWaitTime  ();
+            void reserve        (int stationIdLen);
 
             std::string report();
-            std::string summary();
+            std::string summary(long warmUpTime = 0);
+            void setStartTime   (unsigned long minute);
+            const std::pmr::deque<TruckDeliveryLog> &deliveryLog();
+
+            static void reserveLogEntries(std::pmr::memory_resource *historyRes, long n);
 
         protected:
             friend std::ostream &operator<<(std::ostream &os, Lunar::Truck &trk)
@@ -54,6 +75,9 @@ namespace Lunar {
             unsigned long PROCESS_CLOCK{0};
 
             std::string mId    {};
+            int         mIndex {0};
+            bool        mSeeded{false};
+            RandomStream mRng  {};
             TruckState  mState {TruckState::IDEL};
             std::string mUnloadStationId {};
             int  mLoadingTime       {0};
@@ -63,8 +87,19 @@ namespace Lunar {
             long mUnloadingStartTime{0};
             int  mDeliveryCompleted {0};
             int  mServiceErrors     {0};
-
-            std::list<std::pair<std::string, int>> mWaitTimeLst {};
+            int  mUnloadStationIdx  {-1};
+            long mTotalWaitTime     {0};
+            int  mPayload           {0};
+            int  mSpeedPercent      {Lunar::TRUCK_SPEED_PERCENT};
+            int  mUnloadTime        {Lunar::UNLOAD_TIME_MINUTES};
+            int  mDriveTime         {Lunar::DRIVE_TIME_MINUTES};
+            int  mHomeSite          {0};
+            bool mRouted            {false};     // the truck is dispatched at the site and drives to its station
+            int  mDetourTime        {0};         // minutes back to the site after the station closed on the way
+            unsigned long mClockOffset{0};       // minute of the service clock the current cycle started
+
+            // the log grows a chunk at a time with the deliveries, the chunks come from the resource passed by the owner
+            std::pmr::deque<TruckDeliveryLog> mWaitTimeLst {};
 
             bool isLoadingDone      ();
             void startDriving       ();
@@ -12,14 +12,36 @@ Lunar::UnloadStation::~UnloadStation()
 /**
  * @brief Return stationd id
  *
- * @return std::string
+ * @return const std::string&
  */
-std::string
+const std::string &
 Lunar::UnloadStation::id()
 {
    return mId;
 }
 
+/**
+ * @brief Set station index, position of the station in the site
+ *
+ * @param idx
+ */
+void
+Lunar::UnloadStation::setIndex(int idx)
+{
+   mIndex = idx;
+}
+
+/**
+ * @brief Return station index
+ *
+ * @return int
+ */
+int
+Lunar::UnloadStation::index()
+{
+   return mIndex;
+}
+
 /**
  * @brief Returns station state
  *
@@ -55,9 +77,9 @@ Lunar::UnloadStation::start()
 /**
  * @brief It provides a simple state-machine to determine the next service-stage
  *          Service-Stages:
- *             |-idel
- *             |-unloading
- *             |-unloading-done
+ *             |-idel           all bays are free
+ *             |-unloading      at least one bay is unloading
+ *             |-unloading-done at least one truck is done and waits to be released
  *
  *    It is the execution time slice
  */
@@ -68,19 +90,12 @@ Lunar::UnloadStation::tick()
    switch (mState)
    {
       case UnloadStationState::IDEL:
-         if(startUnloading()) {
-            mState = UnloadStationState::UNLOADING;
-         }
-         break;
-
       case UnloadStationState::UNLOADING:
-         if(isUnloadingDone()) {
-            mState = Lunar::UnloadStationState::UNLOADING_DONE;
-            mUnloadsCompleted++;
-         }
-         break;
-
       case UnloadStationState::UNLOADING_DONE:
+         // complete the trucks that reached their deadline, then fill the free bays
+         isUnloadingDone();
+         startUnloading();
+         updateState();
          break;
 
       default:
@@ -92,28 +107,92 @@ Lunar::UnloadStation::tick()
 
 /**
  * @brief Checks if unloading is done
- *          if it is done, update the state of truck in queue
+ *          the trucks whose deadline is reached are flagged as done
  *
- * @return true
+ * @return true  if a truck in the bays is done
  * @return false
  */
 bool
 Lunar::UnloadStation::isUnloadingDone()
 {
-   if(mTrucksWaiting.empty() || mState != UnloadStationState::UNLOADING) {
-      return false;
+   while (mBayDeadlines.empty() == false && mBayDeadlines.front().deadline <= PROCESS_CLOCK) {
+      auto trkIdx = mBayDeadlines.front().trkIdx;
+      std::ranges::pop_heap(mBayDeadlines, std::greater<>());
+      mBayDeadlines.pop_back();
+
+      // the bays are the front of the queue
+      auto bay = mTrucksWaiting.begin();
+      for (int b {0}; b < mBusyBays; b++, bay++) {
+         if(bay->trkIdx == trkIdx && bay->isDone == false) {
+            bay->isDone = true;
+            mDoneBays++;
+            mUnloadsCompleted++;
+            break;
+         }
+      }
    }
 
-   if(unloadingTimeLeft() <= 0) {
-      mTrucksWaiting.front().isDone = true;
+   return mDoneBays > 0;
+}
+
+/**
+ * @brief Set the state from the occupancy of the bays
+ *
+ */
+void
+Lunar::UnloadStation::updateState()
+{
+   if(mDoneBays > 0) {
+      mState = UnloadStationState::UNLOADING_DONE;
+   }
+   else if(mBusyBays > 0) {
+      mState = UnloadStationState::UNLOADING;
    }
+   else {
+      mState = UnloadStationState::IDEL;
+   }
+}
+
+/**
+ * @brief Set the number of bays, the station unloads that many trucks at once from one queue
+ *
+ * @param bays
+ */
+void
+Lunar::UnloadStation::setNumOfBays(int bays)
+{
+   mNumOfBays = std::max(bays, 1);
+   mBayDeadlines.reserve(mNumOfBays);
+   mBayFreeTime.reserve(mNumOfBays);
+}
 
-   return  mTrucksWaiting.front().isDone;
+/**
+ * @brief Return the number of bays
+ *
+ * @return int
+ */
+int
+Lunar::UnloadStation::numOfBays()
+{
+   return mNumOfBays;
+}
+
+/**
+ * @brief Return the number of bays with a truck in it
+ *
+ * @return int
+ */
+int
+Lunar::UnloadStation::numOfBusyBays()
+{
+   return mBusyBays;
 }
 
 
 /**
- * @brief Calculate total waiting time
+ * @brief Calculate the waiting time of a truck that joins the queue now,
+ *          the time until a bay is free after the trucks in the bays and in the queue are unloaded.
+ *          With one bay it is the sum of the remaining unloading times
  *
  * @return long
  */
@@ -124,30 +203,83 @@ Lunar::UnloadStation::totalWaitTime()
       return 0;
    }
 
-   long mTotalWaitTime {0};
+   drainQueue();
+
+   return *std::ranges::min_element(mBayFreeTime);
+}
 
-   //sum all trucks waiting for unloading
-   auto sumTotalWaitTime = [&] (TruckUnloadingInfo &trk) {
+/**
+ * @brief Calculate the waiting times of trucks that join the queue now one after the other,
+ *          each of them takes the bay that is free first after the queue and the trucks before it,
+ *          the trucks joining take unloadTime each
+ *
+ * @param unloadTime
+ * @param waits      one wait per joining truck, sized by the caller
+ */
+void
+Lunar::UnloadStation::slotWaitTimes(long unloadTime, std::vector<long> &waits)
+{
+   drainQueue();
+
+   for (auto &wait : waits) {
+      auto bay = std::ranges::min_element(mBayFreeTime);
+      wait  = *bay;
+      *bay += unloadTime;
+   }
+}
+
+/**
+ * @brief Calculate the time until each bay is free after the trucks in the bays and in the queue are unloaded,
+ *          into mBayFreeTime
+ *
+ */
+void
+Lunar::UnloadStation::drainQueue()
+{
+   // remaining time of each bay
+   mBayFreeTime.assign(mNumOfBays, 0);
+   size_t bay {0};
+
+   auto addTruckToBays = [&] (TruckUnloadingInfo &trk) {
          //skip if truck is done
          if(trk.isDone) {
+            bay++;
             return;
          }
          else if(trk.startTime > 0) {
             //calculate the remaining time of the active unloading truck
-            auto leftTime = (trk.startTime + Lunar::UNLOAD_TIME_MINUTES) - PROCESS_CLOCK;
-            if(leftTime > 0) {
-               mTotalWaitTime += leftTime;
-            }
+            auto leftTime = (trk.startTime + trk.unloadTime) - static_cast<long>(PROCESS_CLOCK);
+            mBayFreeTime[bay++ % mNumOfBays] = std::max(leftTime, 0L);
          }
          else {
-            //else add the default unloading-time
-            mTotalWaitTime += Lunar::UNLOAD_TIME_MINUTES;
+            //else the waiting truck takes the bay that is free first
+            *std::ranges::min_element(mBayFreeTime) += trk.unloadTime;
          }
       };
 
-   std::for_each(mTrucksWaiting.begin(), mTrucksWaiting.end(), sumTotalWaitTime);
+   std::for_each(mTrucksWaiting.begin(), mTrucksWaiting.end(), addTruckToBays);
+}
+
+/**
+ * @brief Set the station-specific cost (minutes) used by the batch-assignment scheduler
+ *
+ * @param cost
+ */
+void
+Lunar::UnloadStation::setAssignmentCost(int cost)
+{
+   mAssignmentCost = cost;
+}
 
-   return mTotalWaitTime;
+/**
+ * @brief Return the station-specific assignment cost
+ *
+ * @return int
+ */
+int
+Lunar::UnloadStation::assignmentCost()
+{
+   return mAssignmentCost;
 }
 
 /**
@@ -161,24 +293,42 @@ Lunar::UnloadStation::numOfTrucksInQueue()
    return mTrucksWaiting.size();
 }
 
+/**
+ * @brief Return the id of the truck that is unloaded, empty if the station is idle
+ *
+ * @return std::string
+ */
+std::string
+Lunar::UnloadStation::activeTruckId()
+{
+   if(mTrucksWaiting.empty() || mBusyBays == 0) {
+      return "";
+   }
+
+   return mTrucksWaiting.front().trkId;
+}
+
 /**
  * @brief Add truck to the waiting queue
  *
  * @param trkId
+ * @param trkIdx
+ * @param travelTime minutes until the truck arrives at the station
+ * @param unloadTime
  * @return true
  * @return false
  */
 bool
-Lunar::UnloadStation::addTruck(std::string trkId)
+Lunar::UnloadStation::addTruck(const std::string &trkId, int trkIdx, int travelTime, int unloadTime)
 {
    // if the waiting queue is empty, just add it
    if(mTrucksWaiting.empty()) {
-      mTrucksWaiting.push_back(TruckUnloadingInfo(trkId, PROCESS_CLOCK));
+      mTrucksWaiting.push_back(TruckUnloadingInfo(trkId, trkIdx, PROCESS_CLOCK + travelTime, 0, false, unloadTime));
       return true;
    }
 
    // check if the truck is alreading in the waiting queue
-   auto check = [trkId] (TruckUnloadingInfo &trk) -> bool {
+   auto check = [&trkId] (TruckUnloadingInfo &trk) -> bool {
       auto found {false};
       (trk.trkId == trkId) ? found = true : found = false;
       return found;
@@ -193,7 +343,7 @@ Lunar::UnloadStation::addTruck(std::string trkId)
    }
 
    // add the truck to the waiting queue with its arrival time
-   mTrucksWaiting.push_back(TruckUnloadingInfo(trkId, PROCESS_CLOCK));
+   mTrucksWaiting.push_back(TruckUnloadingInfo(trkId, trkIdx, PROCESS_CLOCK + travelTime, 0, false, unloadTime));
 
    return true;
 }
@@ -210,7 +360,7 @@ Lunar::UnloadStation::unloadingTime()
 }
 
 /**
- * @brief Start unloading next truck in the waiting queue
+ * @brief Start unloading the next trucks in the waiting queue on the free bays
  *
  * @return true
  * @return false
@@ -218,18 +368,36 @@ Lunar::UnloadStation::unloadingTime()
 bool
 Lunar::UnloadStation::startUnloading()
 {
-   if(mTrucksWaiting.empty()) {
+   if(mBusyBays >= mNumOfBays || static_cast<int>(mTrucksWaiting.size()) <= mBusyBays) {
       return false;
    }
 
-   // sort the waiting queue based on arrival time
-   mTrucksWaiting.sort(sortBasedOnArrivalTime);
+   // sort the waiting part of the queue (behind the bays) based on arrival time,
+   // splicing moves the nodes, so it doesn't allocate
+   std::pmr::list<TruckUnloadingInfo> waiting(mTrucksWaiting.get_allocator());
+   waiting.splice(waiting.begin(), mTrucksWaiting, std::next(mTrucksWaiting.begin(), mBusyBays), mTrucksWaiting.end());
+   waiting.sort(sortBasedOnArrivalTime);
+   mTrucksWaiting.splice(mTrucksWaiting.end(), waiting);
 
    // truck with the longest waiting time is in front
-   // start the unloading by assiging the start time
-   mTrucksWaiting.front().startTime = PROCESS_CLOCK;
+   // start the unloading of the trucks that arrived by assiging the start time,
+   // the started truck is moved behind the busy bays
+   auto started {false};
+   auto trk = std::next(mTrucksWaiting.begin(), mBusyBays);
+   while (mBusyBays < mNumOfBays && trk != mTrucksWaiting.end()) {
+      auto next = std::next(trk);
+      if(trk->arrivalTime <= PROCESS_CLOCK) {
+         mTrucksWaiting.splice(std::next(mTrucksWaiting.begin(), mBusyBays), mTrucksWaiting, trk);
+         trk->startTime = PROCESS_CLOCK;
+         mBayDeadlines.push_back(BayDeadline(PROCESS_CLOCK + trk->unloadTime, trk->trkIdx));
+         std::ranges::push_heap(mBayDeadlines, std::greater<>());
+         mBusyBays++;
+         started = true;
+      }
+      trk = next;
+   }
 
-   return true;
+   return started;
 }
 
 /**
@@ -240,12 +408,12 @@ Lunar::UnloadStation::startUnloading()
 int
 Lunar::UnloadStation::unloadingTimeLeft()
 {
-   if(mTrucksWaiting.empty() || mState != UnloadStationState::UNLOADING) {
+   if(mBayDeadlines.empty() || mState != UnloadStationState::UNLOADING) {
       return 0;
    }
 
-   // calculate the expected runtime left by adding the default unloading time to start-time mins the current process-clock
-   auto tm = (mTrucksWaiting.front().startTime + Lunar::UNLOAD_TIME_MINUTES) - PROCESS_CLOCK;
+   // the expected runtime left of the bay that is done first
+   long tm = mBayDeadlines.front().deadline - PROCESS_CLOCK;
    if(tm < 0) {
       tm = -1;
    }
@@ -254,31 +422,109 @@ Lunar::UnloadStation::unloadingTimeLeft()
 }
 
 /**
- * @brief Release truck that is done unloading and return its id
+ * @brief Release truck that is done unloading and return its index
  *
- * @return std::string
+ * @return int -1 if no truck is done
  */
-std::string
+int
 Lunar::UnloadStation::releaseTruck()
 {
-   std::string trkId {""};
+   int trkIdx {-1};
 
    if(mTrucksWaiting.empty()) {
       mServiceErrors++;
       std::cerr << "[S-ERORR], " << __FUNCTION__ << ":" << __LINE__ << ", " << mId << ", Waiting Queue:EMPTY" << std::endl;
    }
-   else if(mTrucksWaiting.front().isDone) {
-      // check it the active true is flaged as done,
-      // if true,
-      //    save the truck id and
+   else if(mDoneBays > 0) {
+      // find the first bay with a truck that is flaged as done,
+      //    save the truck index and
       //    remove the truck from waiting queue and
-      //    change the state to the idel state for the next run
-      trkId = mTrucksWaiting.front().trkId;
-      mTrucksWaiting.pop_front();
-      mState = UnloadStationState::IDEL;
+      //    update the state for the next run
+      auto bay = std::ranges::find_if(mTrucksWaiting, [] (TruckUnloadingInfo &trk) { return trk.isDone; });
+      trkIdx = bay->trkIdx;
+      mTrucksWaiting.erase(bay);
+      mBusyBays--;
+      mDoneBays--;
+      updateState();
+   }
+
+   return trkIdx;
+}
+
+/**
+ * @brief Remove a truck from the waiting queue,
+ *          the truck that is unloaded can't be removed
+ *
+ * @param trkIdx
+ * @return true  if the truck is not in the queue anymore
+ * @return false if the truck is unloaded right now
+ */
+bool
+Lunar::UnloadStation::removeTruck(int trkIdx)
+{
+   auto it = std::ranges::find_if(mTrucksWaiting, [trkIdx] (TruckUnloadingInfo &trk) { return trk.trkIdx == trkIdx; });
+   if(it == mTrucksWaiting.end()) {
+      return true;
+   }
+
+   if(std::distance(mTrucksWaiting.begin(), it) < mBusyBays) {
+      return false;
+   }
+
+   mTrucksWaiting.erase(it);
+   return true;
+}
+
+/**
+ * @brief Remove all trucks that are not unloaded yet from the waiting queue,
+ *          their indexes are appended to trkIdxs so the scheduler can re-route them
+ *
+ * @param trkIdxs
+ */
+void
+Lunar::UnloadStation::rerouteWaitingTrucks(std::vector<int> &trkIdxs)
+{
+   // the trucks in the bays are unloaded
+   auto it = std::next(mTrucksWaiting.begin(), mBusyBays);
+
+   while (it != mTrucksWaiting.end()) {
+      trkIdxs.push_back(it->trkIdx);
+      it = mTrucksWaiting.erase(it);
    }
+}
 
-   return trkId;
+/**
+ * @brief Close the station, the scheduler doesn't assign new trucks to a closed station
+ *
+ */
+void
+Lunar::UnloadStation::close()
+{
+   mOpen = false;
+}
+
+/**
+ * @brief Check if the station accepts new trucks
+ *
+ * @return true
+ * @return false
+ */
+bool
+Lunar::UnloadStation::isOpen()
+{
+   return mOpen;
+}
+
+/**
+ * @brief Check if a closed station has unloaded its last truck
+ *
+ * @return true
+ * @return false
+ */
+bool
+Lunar::UnloadStation::isDrained()
+{
+   return mOpen == false && mTrucksWaiting.empty() && mBusyBays == 0;
 }
 
 /**
@@ -296,6 +542,22 @@ Lunar::UnloadStation::sortBasedOnArrivalTime(TruckUnloadingInfo &trk1,
    return (trk1.arrivalTime > trk2.arrivalTime) ? true : false;
 }
 
+/**
+ * @brief Pre-allocate n queue nodes in the memory resource,
+ *          a pool keeps the released nodes, so the queues don't allocate while the simulation runs
+ *
+ * @param queueRes
+ * @param n
+ */
+void
+Lunar::UnloadStation::reserveQueueNodes(std::pmr::memory_resource *queueRes, int n)
+{
+   std::pmr::list<TruckUnloadingInfo> nodes(queueRes);
+   for (int i {0}; i < n; i++) {
+      nodes.emplace_back();
+   }
+}
+
 /**
  * @brief release waiting queue
  *
@@ -304,6 +566,9 @@ void
 Lunar::UnloadStation::releaseResources()
 {
    mTrucksWaiting.clear();
+   mBayDeadlines.clear();
+   mBusyBays = 0;
+   mDoneBays = 0;
 }
 
 /**
@@ -331,6 +596,9 @@ Lunar::UnloadStation::report()
       ss << (mTrucksWaiting.size() ? mTrucksWaiting.front().trkId : "[S-ERORR]") << " Unloading, ";
       ss << "UnloadingTimeLeft:" << unloadingTimeLeft()  << ":min, ";
       ss << "TrucksInQueue:"     << mTrucksWaiting.size()<< ", ";
+      if(mNumOfBays > 1) {
+         ss << "BusyBays:"       << mBusyBays << "/" << mNumOfBays << ", ";
+      }
       ss << "TotalWaitTime:"     << totalWaitTime()      << ":min";
       break;
 
@@ -7,8 +7,14 @@ namespace Lunar {
     class UnloadStation
     {
         public:
-            UnloadStation (std::string id) :
-                mId(id) {}
+            UnloadStation (std::string id,
+                           std::pmr::memory_resource *queueRes = std::pmr::get_default_resource()) :
+                mId(id), mTrucksWaiting(queueRes) { setNumOfBays(Lunar::UNLOAD_STATION_BAYS); }
+
+            UnloadStation (const UnloadStation &stat)            = default;
+            UnloadStation (UnloadStation &&stat) noexcept        = default;
+            UnloadStation &operator=(const UnloadStation &stat)  = default;
+            UnloadStation &operator=(UnloadStation &&stat)       = default;
 
             virtual ~UnloadStation   ();
 
@@ -16,7 +22,12 @@ namespace Lunar {
             void tick ();
 
             void setId(std::string id);
-            std::string id();
+            const std::string &id();
+            void setIndex(int idx);
+            int  index ();
+            void setNumOfBays(int bays);
+            int  numOfBays   ();
+            int  numOfBusyBays();
 
             void setState(UnloadStationState stat);
             UnloadStationState state();
@@ -26,12 +37,34 @@ namespace Lunar {
             bool isUnloadingDone    ();
             int  unloadingTimeLeft  ();
             int  numOfTrucksInQueue ();
+            std::string activeTruckId();
             long totalWaitTime      ();
+            void slotWaitTimes      (long unloadTime, std::vector<long> &waits);
+            void setAssignmentCost  (int cost);
+            int  assignmentCost     ();
 
-            bool        addTruck    (std::string trkId);
-            std::string releaseTruck();
+            bool        addTruck    (const std::string &trkId, int trkIdx,
+                                     int travelTime = 0, int unloadTime = Lunar::UNLOAD_TIME_MINUTES);
+            int         releaseTruck();
+            bool        removeTruck (int trkIdx);
+            void        rerouteWaitingTrucks(std::vector<int> &trkIdxs);
+            void        close       ();
+            bool        isOpen      ();
+            bool        isDrained   ();
             std::string report      ();
 
+            static void reserveQueueNodes(std::pmr::memory_resource *queueRes, int n);
+
+            // call fn with the id of each truck in a bay, the bays hold the first numOfBusyBays() trucks of the queue
+            template <typename Fn>
+            void forEachUnloadingTruck(Fn &&fn)
+            {
+                int bay {0};
+                for (auto it = mTrucksWaiting.begin(); it != mTrucksWaiting.end() && bay < mBusyBays; it++, bay++) {
+                    fn(it->trkId);
+                }
+            }
+
         protected:
             void releaseResources();
 
@@ -44,14 +77,35 @@ namespace Lunar {
         private:
             unsigned long PROCESS_CLOCK {0};
             std::string mId             {};
+            int  mIndex                 {0};
             UnloadStationState mState   {UnloadStationState::IDEL};
             int  mUnloadingTime         {Lunar::UNLOAD_TIME_MINUTES};
             long mUnloadsCompleted      {0};
+            int  mAssignmentCost        {0};
+            bool mOpen                  {true};
+
+            // the first mBusyBays trucks of the queue are in the bays,
+            // their unloading deadlines are kept in a min-heap
+            struct BayDeadline {
+                unsigned long deadline {0};
+                int           trkIdx   {-1};
+
+                bool operator>(const BayDeadline &other) const { return deadline > other.deadline; }
+            };
+
+            int  mNumOfBays             {Lunar::UNLOAD_STATION_BAYS};
+            int  mBusyBays              {0};
+            int  mDoneBays              {0};
+            std::vector<BayDeadline> mBayDeadlines;
+            std::vector<long>        mBayFreeTime;      // scratch of the wait estimate
             int  mServiceErrors         {0};
 
-            std::list<TruckUnloadingInfo> mTrucksWaiting;
+            // queue nodes come from the memory resource passed by the owner, e.g. a shared pool
+            std::pmr::list<TruckUnloadingInfo> mTrucksWaiting;
 
             static bool sortBasedOnArrivalTime(TruckUnloadingInfo &trk1, TruckUnloadingInfo &trk2);
+            void updateState();
+            void drainQueue ();
     };
 }
 
@@ -6,9 +6,15 @@
  * @param unloadStations
  */
 void
-Lunar::UnloadStationScheduler::setUnloadStations(std::list<std::unique_ptr<UnloadStation>> *unloadStations)
+Lunar::UnloadStationScheduler::setUnloadStations(SlotMap<UnloadStation> *unloadStations)
 {
     mUnloadStations = unloadStations;
+    mStationOrder.clear();
+    mStationVersion = std::numeric_limits<unsigned long>::max();
+
+    for (size_t pos {0}; mUnloadStations != nullptr && pos < mUnloadStations->size(); pos++) {
+        stationAdded(mUnloadStations->handleAt(pos));
+    }
 }
 
 /**
@@ -17,9 +23,89 @@ Lunar::UnloadStationScheduler::setUnloadStations(std::list<std::unique_ptr<Unloa
  * @param trks
  */
 void
-Lunar::UnloadStationScheduler::setTrucks(std::list<std::unique_ptr<Truck>> *trks)
+Lunar::UnloadStationScheduler::setTrucks(SlotMap<Truck> *trks)
 {
     mTrucks = trks;
+    mTruckOrder.clear();
+    mTruckByIndex.clear();
+    mTruckVersion = std::numeric_limits<unsigned long>::max();
+
+    for (size_t pos {0}; mTrucks != nullptr && pos < mTrucks->size(); pos++) {
+        truckAdded(mTrucks->handleAt(pos));
+    }
+}
+
+/**
+ * @brief Append a truck added to the slot map after setTrucks() to the scheduling order, O(1)
+ *
+ * @param handle
+ */
+void
+Lunar::UnloadStationScheduler::truckAdded(SlotHandle handle)
+{
+    auto trk = (mTrucks != nullptr) ? mTrucks->get(handle) : nullptr;
+    if(trk == nullptr) {
+        return;
+    }
+
+    mTruckOrder.push_back(OrderEntry<Truck>(0, handle, trk));
+
+    // truck index -> handle, the unload-stations release trucks by their index
+    auto idx = trk->index();
+    if(idx >= static_cast<int>(mTruckByIndex.size())) {
+        mTruckByIndex.resize(idx + 1);
+    }
+    mTruckByIndex[idx] = handle;
+}
+
+/**
+ * @brief Append an unload-station added to the slot map after setUnloadStations() to the scheduling order, O(1)
+ *
+ * @param handle
+ */
+void
+Lunar::UnloadStationScheduler::stationAdded(SlotHandle handle)
+{
+    auto stat = (mUnloadStations != nullptr) ? mUnloadStations->get(handle) : nullptr;
+    if(stat != nullptr) {
+        mStationOrder.push_back(OrderEntry<UnloadStation>(0, handle, stat));
+    }
+}
+
+/**
+ * @brief set the site model, with drive times the scheduler dispatches the trucks at their site
+ *
+ * @param site
+ */
+void
+Lunar::UnloadStationScheduler::setSiteModel(const SiteModel *site)
+{
+    mSite = site;
+}
+
+/**
+ * @brief Set the policy used to assign waiting trucks to unload-stations
+ *
+ * @param policy
+ * @param budget time budget of the batch-assignment solver per tick
+ */
+void
+Lunar::UnloadStationScheduler::setSchedulingPolicy(SchedulingPolicy policy,
+                                                   std::chrono::microseconds budget)
+{
+    mPolicy      = policy;
+    mBatchBudget = budget;
+}
+
+/**
+ * @brief Returns how many times the batch-assignment fell back to the greedy assignment
+ *
+ * @return long
+ */
+long
+Lunar::UnloadStationScheduler::batchFallbacks()
+{
+    return mBatchFallbacks;
 }
 
 /**
@@ -31,10 +117,37 @@ Lunar::UnloadStationScheduler::setTrucks(std::list<std::unique_ptr<Truck>> *trks
 void
 Lunar::UnloadStationScheduler::tick()
 {
+    if(prepareTick() == false) {
+        return;
+    }
+
     checkForUnloadingDone();
     checkForUnloadingRequest();
 }
 
+/**
+ * @brief It checks that there is something to schedule and sizes the scratch buffers
+ *
+ * @return true
+ * @return false if there is nothing to schedule
+ */
+bool
+Lunar::UnloadStationScheduler::prepareTick()
+{
+    if(mUnloadStations == nullptr || mTrucks == nullptr ||
+        mUnloadStations->empty()   || mTrucks->empty()) {
+         return false;
+    }
+
+    // the sort scratch buffers and the done list are sized up front,
+    // the first unsorted tick may come long after the warm-up
+    mStationScratch.reserve(mStationOrder.size());
+    mTruckScratch.reserve(mTruckOrder.size());
+    mTrkDone.reserve(mTruckOrder.size());
+
+    return true;
+}
+
 /**
  * @brief This method iterate through unload-stations
  *          and creates a list of trucks that are done with unloading
@@ -43,41 +156,34 @@ Lunar::UnloadStationScheduler::tick()
 void
 Lunar::UnloadStationScheduler::checkForUnloadingDone()
 {
-    if(mUnloadStations == nullptr || mTrucks == nullptr ||
-        mUnloadStations->empty()   || mTrucks->empty()) {
-         return;
-    }
-
-    std::vector<std::string> trkDone;
+    // the list is a member to keep its capacity between ticks
+    mTrkDone.clear();
 
     // iterate through unload-stations
-    // and add the trucks that are done unloading into the list
-    for (auto statItr = mUnloadStations->begin(); statItr != mUnloadStations->end(); statItr++) {
-
-        std::string tmp = Lunar::UnloadStationStateName.find(statItr->get()->state())->second;
-        if(statItr->get()->state() == UnloadStationState::UNLOADING_DONE) {
-            auto tId = statItr->get()->releaseTruck();
-            trkDone.push_back(tId);
+    // and add the trucks that are done unloading into the list,
+    // a multi-bay station can finish several trucks in the same minute
+    // the station order is refreshed by the sort, until then a station is looked up by its handle
+    for (auto &entry : mStationOrder) {
+        auto stat = mUnloadStations->get(entry.handle);
+        while (stat != nullptr && stat->state() == UnloadStationState::UNLOADING_DONE) {
+            mTrkDone.push_back(stat->releaseTruck());
         }
     }
 
-    if(trkDone.empty()) {
+    if(mTrkDone.empty()) {
         return;
     }
 
-    auto count {0};
     //iterate through the list and updating truck's state accordingly
-    for( auto &t : trkDone) {
-        auto itr = std::find_if(mTrucks->begin(), mTrucks->end(), [&t] (std::unique_ptr<Truck> &trk) {
-                                bool found {false};
-                                (trk.get()->id() == t) ? found = true : found = false;
-                                return found;});
-
-            if(itr != mTrucks->end()) {
-                if(itr->get()->hasUnloadingStation()) {
-                    itr->get()->unloadingDone();
-                }
-            }
+    for( auto idx : mTrkDone) {
+        if(idx < 0 || idx >= static_cast<int>(mTruckByIndex.size())) {
+            continue;
+        }
+
+        auto trk = mTrucks->get(mTruckByIndex[idx]);
+        if(trk != nullptr && trk->hasUnloadingStation()) {
+            trk->unloadingDone();
+        }
     }
 }
 
@@ -89,69 +195,330 @@ Lunar::UnloadStationScheduler::checkForUnloadingDone()
 void
 Lunar::UnloadStationScheduler::checkForUnloadingRequest()
 {
-    if(mUnloadStations == nullptr || mTrucks == nullptr ||
-        mUnloadStations->empty()   || mTrucks->empty()) {
-         return;
+    // sort the unload stations based on least waiting time
+    sortStationsForWaitTime();
+    sortTrucksForWaitTime();
+
+    // solve the arrivals of this minute as one min-cost assignment,
+    // fall back to the greedy assignment if the solver can't make it in time
+    if(mPolicy == SchedulingPolicy::BATCH_ASSIGNMENT && assignBatch()) {
+        return;
     }
 
-    // sort the unload stations based on least waiting time
-    mUnloadStations->sort(decrementSortingForWaitTime);
-    mTrucks->sort(incrementSortingForWaitTime);
+    // with drive times the nearest station is not the one with the least wait
+    if(mSite != nullptr && mSite->hasRoutes()) {
+        assignRouted();
+        return;
+    }
+
+    size_t statPos {0};
 
-    auto statItr = mUnloadStations->begin();
-    auto trkItr  = mTrucks->begin();
+    // closed stations don't take new trucks
+    auto nextOpenStation = [this, &statPos] () -> UnloadStation * {
+        for (int pass {0}; pass < 2; pass++) {
+            while (statPos < mStationOrder.size() && mStationOrder[statPos].entity->isOpen() == false) {
+                statPos++;
+            }
+            if(statPos < mStationOrder.size()) {
+                return mStationOrder[statPos].entity;
+            }
+            sortStationsForWaitTime();
+            statPos = 0;
+        }
+        return nullptr;
+    };
 
     // iterate through the trucks list
     // find truck in the waiting state
     // assign unload-station with least waiting-time to the truck in the waiting state
-    for (auto trkItr = mTrucks->begin(); trkItr != mTrucks->end(); trkItr++) {
+    for (auto &entry : mTruckOrder) {
 
         // if we reached the end of the station list
         // sort the unload stations again
-        if(statItr == mUnloadStations->end()) {
-            mUnloadStations->sort(decrementSortingForWaitTime);
-            statItr = mUnloadStations->begin();
+        if(statPos == mStationOrder.size()) {
+            sortStationsForWaitTime();
+            statPos = 0;
         }
 
-        if (trkItr->get()->state()               == TruckState::WAITING_FOR_UNLOAD_STATION &&
-            trkItr->get()->hasUnloadingStation() == false) {
+        auto trk = entry.entity;
+        if (trk->state()               == TruckState::WAITING_FOR_UNLOAD_STATION &&
+            trk->hasUnloadingStation() == false) {
 
-                trkItr->get()->assignUnloadStation(statItr->get()->id());
-                statItr->get()->addTruck(trkItr->get()->id());
-                statItr++;
+                auto stat = nextOpenStation();
+                if(stat == nullptr) {
+                    return;
+                }
+                trk->assignUnloadStation(stat->id(), stat->index());
+                stat->addTruck(trk->id(), trk->index(), 0, trk->unloadTime());
+                statPos++;
         }
     }
 }
 
 
 /**
- * @brief It is sort algorithm to sort unload stations based on least wait time
+ * @brief This method collects all trucks waiting for an unload-station in this minute
+ *          and solves the truck->station assignment as a min-cost problem.
+ *          Each station offers one slot per waiting truck, the cost of the j-th slot is
+ *          the time until a bay of the station is free after its queue and j more trucks, plus the station-specific cost.
+ *          The queue drains with the unloading times of its trucks, the j trucks with the mean unloading time of the batch.
+ *          Ties are broken towards the longest-waiting trucks getting the earlier slots.
  *
- * @param stat1
- * @param stat2
- * @return true
- * @return false
+ * @return true  if the batch got assigned
+ * @return false if the greedy assignment has to handle the batch
  */
 bool
-Lunar::UnloadStationScheduler::decrementSortingForWaitTime(std::unique_ptr<UnloadStation> &stat1,
-                                                           std::unique_ptr<UnloadStation> &stat2)
+Lunar::UnloadStationScheduler::assignBatch()
+{
+    mBatchTrucks.clear();
+    for (auto &entry : mTruckOrder) {
+        auto trk = entry.entity;
+        if(trk->state() == TruckState::WAITING_FOR_UNLOAD_STATION && trk->hasUnloadingStation() == false) {
+            mBatchTrucks.push_back(trk);
+        }
+    }
+
+    // a single arrival is the same for both policies
+    if(mBatchTrucks.size() < 2) {
+        return false;
+    }
+
+    mBatchStations.clear();
+    for (auto &entry : mStationOrder) {
+        if(entry.entity->isOpen()) {
+            mBatchStations.push_back(entry.entity);
+        }
+    }
+
+    if(mBatchStations.empty()) {
+        return false;
+    }
+
+    int rows = mBatchTrucks.size();
+    int cols = mBatchStations.size() * rows;
+    if(static_cast<long>(rows) * cols > Lunar::BATCH_ASSIGNMENT_MAX_CELLS) {
+        mBatchFallbacks++;
+        return false;
+    }
+
+    int numOfStats = mBatchStations.size();
+    mBatchDrive.resize(static_cast<size_t>(rows) * numOfStats);
+    for (int r {0}; r < rows; r++) {
+        for (int s {0}; s < numOfStats; s++) {
+            mBatchDrive[r * numOfStats + s] = driveTime(mBatchTrucks[r], mBatchStations[s]);
+        }
+    }
+
+    // the trucks are in longest-waiting-first order, truck r has the priority rows - r.
+    // The tie-break j * priority is minimal if the earlier slots go to the higher priorities,
+    // the costs are scaled above the largest sum of tie-breaks so it never outweighs a minute of wait
+    long scale = static_cast<long>(rows - 1) * rows * (rows + 1) / 2 + 1;
+
+    // the slot cost can't depend on the trucks in the earlier slots, they unload with the mean time of the batch
+    long unloadTime {0};
+    for (auto trk : mBatchTrucks) {
+        unloadTime += trk->unloadTime();
+    }
+    unloadTime = (unloadTime + rows / 2) / rows;
+
+    // a routed truck joins the queue when it arrives, so it waits for max(drive, wait)
+    mBatchCost.resize(static_cast<size_t>(rows) * cols);
+    mBatchSlotWait.resize(rows);
+    for (int s {0}; s < numOfStats; s++) {
+        mBatchStations[s]->slotWaitTimes(unloadTime, mBatchSlotWait);
+        for (int j {0}; j < rows; j++) {
+            long slotWait = mBatchSlotWait[j];
+            for (int r {0}; r < rows; r++) {
+                long cost = std::max<long>(slotWait, mBatchDrive[r * numOfStats + s]) + mBatchStations[s]->assignmentCost();
+                mBatchCost[r * cols + s * rows + j] = cost * scale + static_cast<long>(j) * (rows - r);
+            }
+        }
+    }
+
+    if(mSolver.solve(mBatchCost, rows, cols, mBatchBudget) != ServiceStatus::SUCESS) {
+        mBatchFallbacks++;
+        return false;
+    }
+
+    // hand out the stations in slot order so each station queue keeps the planned order
+    mBatchSlots.clear();
+    for (int r {0}; r < rows; r++) {
+        mBatchSlots.emplace_back(mSolver.assignment()[r], r);
+    }
+    std::ranges::sort(mBatchSlots);
+
+    for (auto &[col, r] : mBatchSlots) {
+        auto stat  = mBatchStations[col / rows];
+        auto drive = mBatchDrive[r * numOfStats + col / rows];
+        mBatchTrucks[r]->assignUnloadStation(stat->id(), stat->index(), drive);
+        stat->addTruck(mBatchTrucks[r]->id(), mBatchTrucks[r]->index(), drive, mBatchTrucks[r]->unloadTime());
+    }
+
+    return true;
+}
+
+/**
+ * @brief This method dispatches the waiting trucks at their site.
+ *          Each truck gets the open station it can start unloading at first,
+ *          max(drive time, wait of the station); the wait of the chosen station grows by the truck's unloading time.
+ *          The stations are scanned by index along the drive-time row of the truck's site,
+ *          ties go to the station with the least wait like in the greedy assignment
+ *
+ */
+void
+Lunar::UnloadStationScheduler::assignRouted()
+{
+    // station index -> position in the wait order
+    mRoutedPos.clear();
+    for (int pos {0}; pos < static_cast<int>(mStationOrder.size()); pos++) {
+        auto stat = mStationOrder[pos].entity;
+        if(stat->index() >= static_cast<int>(mRoutedPos.size())) {
+            mRoutedPos.resize(stat->index() + 1, -1);
+        }
+        mRoutedPos[stat->index()] = stat->isOpen() ? pos : -1;
+    }
+
+    int columns = std::min<int>(mSite->numOfStationColumns(), mRoutedPos.size());
+    for (auto &entry : mTruckOrder) {
+        auto trk = entry.entity;
+        if (trk->state() != TruckState::WAITING_FOR_UNLOAD_STATION || trk->hasUnloadingStation()) {
+            continue;
+        }
+
+        auto row = mSite->driveRow(trk->homeSite());
+        int  bestPos   {-1};
+        long bestCost  {std::numeric_limits<long>::max()};
+        int  bestDrive {0};
+        for (int s {0}; s < static_cast<int>(mRoutedPos.size()); s++) {
+            auto pos = mRoutedPos[s];
+            if(pos < 0) {
+                continue;
+            }
+
+            auto drive = trk->detourTime() + trk->scaledDriveTime((s < columns) ? row[s] : Lunar::DRIVE_TIME_MINUTES);
+            auto cost  = std::max<long>(drive, mStationOrder[pos].key);
+            if(cost < bestCost || (cost == bestCost && pos < bestPos)) {
+                bestPos   = pos;
+                bestCost  = cost;
+                bestDrive = drive;
+            }
+        }
+
+        if(bestPos < 0) {
+            return;
+        }
+
+        auto best = &mStationOrder[bestPos];
+        auto stat = best->entity;
+        trk->assignUnloadStation(stat->id(), stat->index(), bestDrive);
+        stat->addTruck(trk->id(), trk->index(), bestDrive, trk->unloadTime());
+        best->key += (trk->unloadTime() + stat->numOfBays() - 1) / stat->numOfBays();
+    }
+}
+
+/**
+ * @brief Drive time of the truck from its site to the station plus its way back to the site, 0 if the trucks are not routed
+ *
+ * @param trk
+ * @param stat
+ * @return int
+ */
+int
+Lunar::UnloadStationScheduler::driveTime(Truck *trk, UnloadStation *stat)
 {
-    return (stat1->totalWaitTime() < stat2->totalWaitTime()) ? true : false;
+    if(mSite == nullptr || mSite->hasRoutes() == false) {
+        return 0;
+    }
+
+    return trk->detourTime() + trk->scaledDriveTime(mSite->driveTime(trk->homeSite(), stat->index()));
 }
 
 /**
- * @brief It is sort algorithm to sort trucks based on thier oldest arrival time
+ * @brief It sorts unload stations based on least wait time
  *
- * @param trk1
- * @param trk2
- * @return true
- * @return false
  */
-bool
-Lunar::UnloadStationScheduler::incrementSortingForWaitTime(std::unique_ptr<Truck> &trk1,
-                                                          std::unique_ptr<Truck> &trk2)
+void
+Lunar::UnloadStationScheduler::sortStationsForWaitTime()
+{
+    refreshKeys(*mUnloadStations, mStationOrder, mStationVersion,
+                [] (UnloadStation &stat) { return stat.totalWaitTime(); });
+    stableSortByKey(mStationOrder, mStationScratch);
+}
+
+/**
+ * @brief It sorts trucks based on thier oldest arrival time
+ *
+ */
+void
+Lunar::UnloadStationScheduler::sortTrucksForWaitTime()
+{
+    refreshKeys(*mTrucks, mTruckOrder, mTruckVersion,
+                [] (Truck &trk) { return -trk.timeWaitingForUnLoadStation(); });
+    stableSortByKey(mTruckOrder, mTruckScratch);
+}
+
+/**
+ * @brief Refresh the sort keys of the order.
+ *          If the slot map changed since the last refresh, the entities may have moved:
+ *          the handles are re-resolved and the removed entities dropped in the same pass
+ *
+ * @param entities
+ * @param order
+ * @param version version of the slot map at the last refresh
+ * @param key
+ */
+template <typename T, typename Key>
+void
+Lunar::UnloadStationScheduler::refreshKeys(SlotMap<T> &entities, std::vector<OrderEntry<T>> &order, unsigned long &version, Key &&key)
+{
+    if(version == entities.version()) {
+        for (auto &entry : order) {
+            entry.key = key(*entry.entity);
+        }
+        return;
+    }
+
+    size_t kept {0};
+    for (auto &entry : order) {
+        auto entity = entities.get(entry.handle);
+        if(entity != nullptr) {
+            order[kept++] = OrderEntry<T>(key(*entity), entry.handle, entity);
+        }
+    }
+    order.resize(kept);
+    version = entities.version();
+}
+
+/**
+ * @brief Stable bottom-up merge sort by ascending key.
+ *          The sort keys are computed once per sort instead of once per comparison,
+ *          the scratch buffer keeps its capacity between ticks, so sorting doesn't allocate
+ *
+ * @param order
+ * @param scratch
+ */
+template <typename T>
+void
+Lunar::UnloadStationScheduler::stableSortByKey(std::vector<OrderEntry<T>> &order, std::vector<OrderEntry<T>> &scratch)
 {
-    return (trk1->timeWaitingForUnLoadStation() > trk2->timeWaitingForUnLoadStation()) ? true : false;
+    auto isLess = [] (const OrderEntry<T> &e1, const OrderEntry<T> &e2) { return e1.key < e2.key; };
+    if(std::is_sorted(order.begin(), order.end(), isLess)) {
+        return;
+    }
+
+    auto n = order.size();
+    scratch.resize(n);
+
+    for (size_t width {1}; width < n; width *= 2) {
+        for (size_t lo {0}; lo < n; lo += 2 * width) {
+            auto mid = std::min(lo + width, n);
+            auto hi  = std::min(lo + 2 * width, n);
+            std::merge(order.begin() + lo, order.begin() + mid,
+                       order.begin() + mid, order.begin() + hi,
+                       scratch.begin() + lo, isLess);
+        }
+        order.swap(scratch);
+    }
 }
 
 /**
@@ -162,8 +529,8 @@ void
 Lunar::UnloadStationScheduler::report()
 {
     if(mUnloadStations != nullptr) {
-        auto sReportReq = [] (std::unique_ptr<UnloadStation> &stat) {
-            std::cout << "[SCHD-REPORT], " << *stat << std::endl;
+        auto sReportReq = [] (UnloadStation &stat) {
+            std::cout << "[SCHD-REPORT], " << stat << std::endl;
         };
 
         std::ranges::for_each(*mUnloadStations, sReportReq);
@@ -171,8 +538,8 @@ Lunar::UnloadStationScheduler::report()
     }
 
     if(mTrucks != nullptr) {
-        auto sReportReq = [] (std::unique_ptr<Truck> &trk) {
-            std::cout << "[SCHD-REPORT], " << *trk << std::endl;
+        auto sReportReq = [] (Truck &trk) {
+            std::cout << "[SCHD-REPORT], " << trk << std::endl;
         };
 
         std::ranges::for_each(*mTrucks, sReportReq);
@@ -4,6 +4,9 @@
 #include "service_include.h"
 #include "unload_station.h"
 #include "truck.h"
+#include "assignment_solver.h"
+#include "slot_map.h"
+#include "site_model.h"
 
 namespace Lunar {
     class UnloadStationScheduler
@@ -13,27 +16,71 @@ namespace Lunar {
 
             virtual ~UnloadStationScheduler() {}
 
-            void setUnloadStations(std::list<std::unique_ptr<UnloadStation>> *unloadStations);
-            void setTrucks(std::list<std::unique_ptr<Truck>> *trks);
+            void setUnloadStations(SlotMap<UnloadStation> *unloadStations);
+            void setTrucks(SlotMap<Truck> *trks);
+            void setSiteModel(const SiteModel *site);
+            void truckAdded  (SlotHandle handle);
+            void stationAdded(SlotHandle handle);
+            void setSchedulingPolicy(SchedulingPolicy policy,
+                                     std::chrono::microseconds budget = std::chrono::microseconds(BATCH_ASSIGNMENT_BUDGET_US));
+            long batchFallbacks();
 
             void tick   ();
             void report ();
 
         protected:
-            std::list<std::unique_ptr<UnloadStation>> *mUnloadStations{nullptr};
-            std::list<std::unique_ptr<Truck>> *mTrucks{nullptr};
+            // scheduling order of an entity, the sort key is refreshed before each sort
+            template <typename T>
+            struct OrderEntry {
+                long       key    {0};
+                SlotHandle handle {};
+                T         *entity {nullptr};
+            };
 
-            static bool decrementSortingForWaitTime(std::unique_ptr<UnloadStation> &stat1,
-                                                     std::unique_ptr<UnloadStation> &stat2);
+            SlotMap<UnloadStation> *mUnloadStations{nullptr};
+            SlotMap<Truck> *mTrucks{nullptr};
+            const SiteModel *mSite{nullptr};
 
-            static bool incrementSortingForWaitTime(std::unique_ptr<Truck> &stat1,
-                                                    std::unique_ptr<Truck> &stat2);
+            // persistent scheduling order of trucks and stations, added entities are appended when they are added,
+            // removed entities are dropped and the entity pointers re-resolved by the next key refresh
+            std::vector<OrderEntry<UnloadStation>> mStationOrder;
+            std::vector<OrderEntry<UnloadStation>> mStationScratch;
+            std::vector<OrderEntry<Truck>>         mTruckOrder;
+            std::vector<OrderEntry<Truck>>         mTruckScratch;
+            std::vector<SlotHandle>                mTruckByIndex;
+            unsigned long mStationVersion {std::numeric_limits<unsigned long>::max()};
+            unsigned long mTruckVersion   {std::numeric_limits<unsigned long>::max()};
+
+            void sortStationsForWaitTime();
+            void sortTrucksForWaitTime  ();
+
+            template <typename T, typename Key>
+            static void refreshKeys(SlotMap<T> &entities, std::vector<OrderEntry<T>> &order, unsigned long &version, Key &&key);
+
+            template <typename T>
+            static void stableSortByKey(std::vector<OrderEntry<T>> &order, std::vector<OrderEntry<T>> &scratch);
 
         private:
             int  mServiceErrors{0};
+            SchedulingPolicy          mPolicy{SchedulingPolicy::GREEDY};
+            std::chrono::microseconds mBatchBudget{BATCH_ASSIGNMENT_BUDGET_US};
+            long                      mBatchFallbacks{0};
+            AssignmentSolver          mSolver;
+            std::vector<Truck *>         mBatchTrucks;
+            std::vector<UnloadStation *> mBatchStations;
+            std::vector<long>            mBatchCost;
+            std::vector<std::pair<int, int>> mBatchSlots;
+            std::vector<int>             mTrkDone;
+            std::vector<int>             mBatchDrive;
+            std::vector<long>            mBatchSlotWait;
+            std::vector<int>             mRoutedPos;      // station index -> position in mStationOrder, -1 closed
 
+            bool prepareTick();
             void checkForUnloadingDone();
             void checkForUnloadingRequest();
+            bool assignBatch();
+            void assignRouted();
+            int  driveTime(Truck *trk, UnloadStation *stat);
     };
 };
 #endif // UNLOAD_STATION_SCHEDULER_H
@@ -0,0 +1,49 @@
+#include "warm_up_detector.h"
+
+/**
+ * @brief MSER-5 truncation point of a per-minute series
+ *          MSER(d) = sum_{j>=d} (Z_j - mean_d)^2 / (b - d)^2 over the b batch means Z_j,
+ *          evaluated for every d in O(b) from suffix sums
+ *
+ * @param series value per minute
+ * @return long warm-up in minutes, 0 if the series is too short
+ */
+long
+Lunar::WarmUpDetector::mser5(const std::vector<double> &series)
+{
+    long numOfBatches = series.size() / BATCH_SIZE;
+    if(numOfBatches < 2) {
+        return 0;
+    }
+
+    std::vector<double> batches(numOfBatches, 0.0);
+    for (long j {0}; j < numOfBatches; j++) {
+        for (int i {0}; i < BATCH_SIZE; i++) {
+            batches[j] += series[j * BATCH_SIZE + i];
+        }
+        batches[j] /= BATCH_SIZE;
+    }
+
+    // walk the truncation point backwards so the suffix sums grow by one batch per step
+    double sum   {0.0};
+    double sumSq {0.0};
+    double best  {std::numeric_limits<double>::max()};
+    long   bestD {0};
+    for (long d {numOfBatches - 1}; d >= 0; d--) {
+        sum   += batches[d];
+        sumSq += batches[d] * batches[d];
+
+        if(d > numOfBatches / 2) {
+            continue;
+        }
+
+        double n    = numOfBatches - d;
+        double mser = (sumSq - sum * sum / n) / (n * n);
+        if(mser <= best) {
+            best  = mser;
+            bestD = d;
+        }
+    }
+
+    return bestD * BATCH_SIZE;
+}
@@ -0,0 +1,24 @@
+#ifndef WARM_UP_DETECTOR_H
+#define WARM_UP_DETECTOR_H
+
+#include "service_include.h"
+
+namespace Lunar {
+
+    /**
+     * @brief Detects the end of the initial transient of a run
+     *          All trucks start loading at minute 0, so the first hours are not representative.
+     *          MSER-5: the series is averaged in batches of 5, the warm-up is the truncation point
+     *          that minimizes the squared standard error of the remaining batches,
+     *          searched over the first half of the run
+     */
+    class WarmUpDetector
+    {
+        public:
+            static const int BATCH_SIZE {5};
+
+            static long mser5(const std::vector<double> &series);
+    };
+}
+
+#endif // WARM_UP_DETECTOR_H
@@ -0,0 +1,271 @@
+#include "worker_pool.h"
+
+#include <filesystem>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief Read the CPUs of the affinity mask and their NUMA nodes and cores
+ *
+ */
+Lunar::CpuTopology::CpuTopology()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::map<int, int> nodes;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        auto name = entry.path().filename().string();
+        if(name.rfind("node", 0) != 0 || name.size() == 4 || std::isdigit(static_cast<unsigned char>(name[4])) == 0) {
+            continue;
+        }
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+        for (auto cpu : parseCpuList(list)) {
+            nodes[cpu] = std::stoi(name.substr(4));
+        }
+    }
+
+    std::map<int, int> nodeIdx;
+    for (int c {0}; c < CPU_SETSIZE; c++) {
+        if(CPU_ISSET(c, &allowed) == 0) {
+            continue;
+        }
+
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/thread_siblings_list");
+        std::string list;
+        std::getline(file, list);
+        auto siblings = parseCpuList(list);
+
+        auto node = nodes.contains(c) ? nodes[c] : 0;
+        nodeIdx.emplace(node, static_cast<int>(nodeIdx.size()));
+        mCpus.push_back(Cpu(c, node, siblings.empty() || siblings.front() == c));
+    }
+
+    // the node numbers of the affinity mask are made dense
+    for (auto &cpu : mCpus) {
+        cpu.node = nodeIdx[cpu.node];
+    }
+    mNumOfNodes = std::max(1, static_cast<int>(nodeIdx.size()));
+
+    std::ranges::stable_sort(mCpus, [] (const Cpu &a, const Cpu &b) {
+        return (a.node != b.node) ? (a.node < b.node) : (a.primary && b.primary == false);
+    });
+}
+
+/**
+ * @brief Returns the (dense) NUMA node of the CPU
+ *
+ * @param cpu
+ * @return int -1 if the process can't run on the CPU
+ */
+int
+Lunar::CpuTopology::nodeOf(int cpu) const
+{
+    auto it = std::ranges::find(mCpus, cpu, &Cpu::id);
+    return (it != mCpus.end()) ? it->node : -1;
+}
+
+/**
+ * @brief CPU of each worker, the primary hardware threads of the cores are taken before their siblings.
+ *          compact: node by node, scatter: round-robin over the nodes.
+ *          Oversubscribed workers are left to the OS scheduler like with the policy none.
+ *
+ * @param numOfWorkers
+ * @param policy
+ * @return std::vector<int> -1 for a worker that isn't pinned
+ */
+std::vector<int>
+Lunar::CpuTopology::workerCpus(int numOfWorkers, PinningPolicy policy) const
+{
+    std::vector<int> cpus(std::max(numOfWorkers, 0), -1);
+    if(policy == PinningPolicy::NONE || numOfWorkers > numOfCpus()) {
+        return cpus;
+    }
+
+    if(policy == PinningPolicy::COMPACT) {
+        for (int w {0}; w < numOfWorkers; w++) {
+            cpus[w] = mCpus[w].id;
+        }
+        return cpus;
+    }
+
+    std::vector<std::vector<int>> perNode(mNumOfNodes);
+    for (const auto &cpu : mCpus) {
+        perNode[cpu.node].push_back(cpu.id);
+    }
+    std::vector<size_t> next(mNumOfNodes, 0);
+    int node {0};
+    for (int w {0}; w < numOfWorkers; node = (node + 1) % mNumOfNodes) {
+        if(next[node] < perNode[node].size()) {
+            cpus[w++] = perNode[node][next[node]++];
+        }
+    }
+
+    return cpus;
+}
+
+/**
+ * @brief Pin the calling thread to the CPU
+ *
+ * @param cpu -1: no pinning
+ * @return false if the affinity couldn't be set
+ */
+bool
+Lunar::CpuTopology::pinCurrentThread(int cpu)
+{
+    if(cpu < 0) {
+        return true;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Parse a CPU list of /sys, e.g. "0-3,8-11"
+ *
+ * @param list
+ * @return std::vector<int>
+ */
+std::vector<int>
+Lunar::CpuTopology::parseCpuList(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::string range;
+    std::stringstream ss(list);
+    while (std::getline(ss, range, ',')) {
+        try {
+            auto dash  = range.find('-');
+            auto first = std::stoi(range.substr(0, dash));
+            auto last  = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int c {first}; c <= last; c++) {
+                cpus.push_back(c);
+            }
+        }
+        catch (const std::exception &) {
+            break;
+        }
+    }
+
+    return cpus;
+}
+
+/**
+ * @brief Start the workers, numOfWorkers < 1 starts one per CPU of the affinity mask
+ *
+ * @param numOfWorkers
+ * @param policy
+ */
+Lunar::WorkerPool::WorkerPool(int numOfWorkers, PinningPolicy policy)
+{
+    CpuTopology topology;
+    if(numOfWorkers < 1) {
+        numOfWorkers = std::max(1, topology.numOfCpus());
+    }
+
+    mCpus = topology.workerCpus(numOfWorkers, policy);
+    for (int w {0}; w < numOfWorkers; w++) {
+        mThreads.emplace_back(&WorkerPool::worker, this, w);
+    }
+}
+
+/**
+ * @brief Finish the queued tasks and join the workers
+ *
+ */
+Lunar::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mTaskReady.notify_all();
+
+    for (auto &thread : mThreads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Queue a task for the next free worker
+ *
+ * @param task
+ */
+void
+Lunar::WorkerPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTasks.push_back(std::move(task));
+    }
+    mTaskReady.notify_one();
+}
+
+/**
+ * @brief Wait until every submitted task is done
+ *
+ */
+void
+Lunar::WorkerPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    mIdle.wait(lock, [this] { return mTasks.empty() && mBusy == 0; });
+}
+
+/**
+ * @brief Pinning policy of WORKER_PINNING, compact if not set
+ *
+ * @param cfg
+ * @return Lunar::PinningPolicy
+ */
+Lunar::PinningPolicy
+Lunar::WorkerPool::pinningPolicy(Config &cfg)
+{
+    auto policy = cfg.workerPinning();
+    if(policy < 0 || policy >= static_cast<int>(PinningPolicy::COUNT)) {
+        return PinningPolicy::COMPACT;
+    }
+
+    return static_cast<PinningPolicy>(policy);
+}
+
+/**
+ * @brief Worker loop, the worker is pinned before it takes its first task
+ *
+ * @param idx
+ */
+void
+Lunar::WorkerPool::worker(int idx)
+{
+    if(CpuTopology::pinCurrentThread(mCpus[idx]) == false) {
+        std::cerr << "[POOL-ERROR], Unable to pin worker " << idx << " to CPU " << mCpus[idx] << std::endl;
+    }
+
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        mTaskReady.wait(lock, [this] { return mStop || mTasks.empty() == false; });
+        if(mTasks.empty()) {
+            return;
+        }
+
+        auto task = std::move(mTasks.front());
+        mTasks.pop_front();
+        mBusy++;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        mBusy--;
+        if(mTasks.empty() && mBusy == 0) {
+            mIdle.notify_all();
+        }
+    }
+}
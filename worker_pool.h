@@ -0,0 +1,81 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "service_include.h"
+#include "config.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+namespace Lunar {
+
+    /**
+     * @brief CPUs the process may run on, with their NUMA node and whether they are the first hardware thread of their core.
+     *          It is read from the affinity mask and /sys, a host without NUMA information is one node.
+     */
+    class CpuTopology
+    {
+        public:
+            CpuTopology();
+            virtual ~CpuTopology() {}
+
+            int numOfCpus () const { return static_cast<int>(mCpus.size()); }
+            int numOfNodes() const { return mNumOfNodes; }
+            int nodeOf    (int cpu) const;
+
+            std::vector<int> workerCpus(int numOfWorkers, PinningPolicy policy) const;
+
+            static bool pinCurrentThread(int cpu);
+
+        private:
+            struct Cpu {
+                int  id      {0};
+                int  node    {0};
+                bool primary {true};    // first hardware thread of its core
+            };
+
+            std::vector<Cpu> mCpus       {};     // ordered by node, the primary threads first
+            int              mNumOfNodes {1};
+
+            static std::vector<int> parseCpuList(const std::string &list);
+    };
+
+    /**
+     * @brief Fixed set of worker threads for independent simulation runs, each worker pins itself
+     *          by the pinning policy before it takes a task. A task that creates its simulation on the worker
+     *          gets the truck and station storage on the NUMA node of the worker (first touch), so the runs
+     *          neither migrate between sockets nor access the memory of another node.
+     */
+    class WorkerPool
+    {
+        public:
+            WorkerPool(int numOfWorkers, PinningPolicy policy);
+            WorkerPool(const WorkerPool &) = delete;
+            WorkerPool &operator=(const WorkerPool &) = delete;
+            virtual ~WorkerPool();
+
+            void submit(std::function<void()> task);
+            void wait  ();
+
+            int numOfWorkers() const { return static_cast<int>(mThreads.size()); }
+            int cpuOf       (int worker) const { return mCpus[worker]; }
+
+            static PinningPolicy pinningPolicy(Config &cfg);
+
+        private:
+            std::vector<std::thread>          mThreads {};
+            std::vector<int>                  mCpus    {};     // per worker, -1: not pinned
+            std::deque<std::function<void()>> mTasks   {};
+            int                               mBusy    {0};
+            bool                              mStop    {false};
+            std::mutex                        mLock;
+            std::condition_variable           mTaskReady;
+            std::condition_variable           mIdle;
+
+            void worker(int idx);
+    };
+}
+
+#endif // WORKER_POOL_H